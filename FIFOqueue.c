@@ -23,50 +23,67 @@ struct FIFOqueue *newQueue() {
     }    
 
     q->size = 0; // intialize size
+    q->capacity = FIFOSIZE;
+    q->head = 0;
+    q->ring = malloc(sizeof(int) * q->capacity);
+    if(q->ring == NULL) {
+        perror("malloc error. cannot create queue ring.\n");
+        exit(1);
+    }
 
     return q;
 }
 /*
- * A function to insert an element into FIFO queue
+ * A function to double the size of the ring
+ * The elements are unwrapped so the head is in slot 0
  *
  * @param struct FIFOqueue *q, the FIFO queue
- * @param struct customer *c, the element to insert
+ *
+ * @local int *ring, the new ring
+ * @local int i, a counter
  */
-void enqueue(struct FIFOqueue *q, struct customer *c) {
-    if(q->size == 0) {      // if queue is empty, head and tail point to new element
-        q->head = c;
-        q->tail =  c;
-        q->size++;
-    } else {                // if queue is not empty, new element points to tail, then tail points to new element
-        c->nextCust = q->tail;
-        q->tail = c;
-        q->size++;
+static void growQueue(struct FIFOqueue *q) {
+    int i;
+    int *ring = malloc(sizeof(int) * q->capacity * 2);
+    if(ring == NULL) {
+        perror("malloc error. cannot grow queue ring.\n");
+        exit(1);
     }
+    for(i=0;i<q->size;i++)
+        ring[i] = q->ring[(q->head + i) & (q->capacity - 1)];
+    free(q->ring);
+    q->ring = ring;
+    q->head = 0;
+    q->capacity *= 2;
+}
+/*
+ * A function to insert an element into FIFO queue
+ *
+ * @param struct FIFOqueue *q, the FIFO queue
+ * @param int c, the id of the customer to insert
+ */
+void enqueue(struct FIFOqueue *q, int c) {
+    if(q->size == q->capacity)      // if ring is full, double it
+        growQueue(q);
+    q->ring[(q->head + q->size) & (q->capacity - 1)] = c;  // place behind the last element
+    q->size++;
 }
 /*
  * A function to remove element from queue
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
- * @local struct customer *tmp, pointer to tail
- * @local struct customer *toServe, the element to return 
+ * @local int toServe, the element to return 
  *
- * @return struct customer *, reference to the element which was removed
+ * @return int, the id of the customer which was removed, -1 if empty
  */
-struct customer *dequeue(struct FIFOqueue *q) {
-    struct customer *tmp = q->tail;         // tmp points to tail
-    struct customer *toServe = q->head;     // toServe points to head
-    if(q->size == 0) {
-        printf("Nothing to dequeue.\n");    // if queue is empty return NULL
-        return NULL;
-    } else if(q->size == 1) {               // if size is 1, decrement size, queue is now empty
-        q->size--;
-    } else {                                // if size is greater than 1
-        while(tmp->nextCust != q->head)     // tmp points to element next to head
-            tmp = tmp->nextCust;
-        q->head = tmp;                      // head points to tmp
-        q->size--;                          // decrement size
-    }
+int dequeue(struct FIFOqueue *q) {
+    int toServe;
+    if(q->size == 0)            // if queue is empty return -1
+        return -1;
+    toServe = q->ring[q->head];
+    q->head = (q->head + 1) & (q->capacity - 1);   // head moves to next in line
+    q->size--;
 
     return toServe;         // return element
 }
@@ -75,10 +92,12 @@ struct customer *dequeue(struct FIFOqueue *q) {
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
- * @return struct customer *, reference to element
+ * @return int, the id of the customer, -1 if empty
  */
-struct customer *getFirst(struct FIFOqueue *q) {
-    return q->head;
+int getFirst(struct FIFOqueue *q) {
+    if(q->size == 0)
+        return -1;
+    return q->ring[q->head];
 }
 /*
  * A function to check if FIFO queue is empty
@@ -105,32 +124,15 @@ int getSize(struct FIFOqueue *q) {
 }
 /*
  * A function to free the FIFO queue
+ * The elements belong to the customer pool and are freed with it
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
- * @local struct customer *tmp, pointer to next element after 3
- *
  * @return struct FIFOqueue *, reference to freed FIFO queue (NULL)
  */
 struct FIFOqueue *freeFIFOqueue(struct FIFOqueue *q) {
-    if(q->size > 2) {   // if size > 2, move through queue and free all elements
-        struct customer *tmp;
-        tmp = q->tail->nextCust;
-        while(tmp->nextCust != q->head) {        
-            free(q->tail);
-            q->tail = tmp;
-            tmp = tmp->nextCust;
-        }
-        free(q->head);
-        free(q->tail);
-        free(tmp);
-    } else if(q->size == 2) {   // if size == 2, just free head and tail
-        free(q->head);
-        free(q->tail);
-    } else if(q->size == 1) {   // if size == 1, just free head
-        free(q->head);
-    }
-    free(q);    // free FIFO queue structure
+    free(q->ring);  // free the ring
+    free(q);        // free FIFO queue structure
     q = NULL;
     return q;
 }
@@ -3,7 +3,7 @@
   File Name: FIFOqueue.h
   Simulation
 
-  Contains struct definitions, function prototypes, and #includes for FIFOqueue.c
+  Contains struct definitions, function prototypes, #defines, and #includes for FIFOqueue.c
 ***************************************************************/
 
 #include <stdio.h>
@@ -15,16 +15,24 @@
 #define _FIFOqueue_h
 
 /*
- * The FIFO queue structure
+ * The initial size of the FIFO queue, it doubles whenever it fills
+ * Must be a power of two
+ */
+#define FIFOSIZE 64
+
+/*
+ * The FIFO queue structure, a ring buffer of customer ids
  * 
  * @field int size, the size of the queue
- * @field struct customer *head, pointer to element in front of queue
- * @field struct customer *tail, pointer to element in back of queue
+ * @field int capacity, the size of the ring, a power of two
+ * @field int head, the slot of the element in front of queue
+ * @field int *ring, the customer ids
  */
 struct FIFOqueue {
     int size;
-    struct customer *head;
-    struct customer *tail;
+    int capacity;
+    int head;
+    int *ring;
 };
 
 /*
@@ -37,25 +45,25 @@ struct FIFOqueue *newQueue();
  * A function to insert an element into FIFO queue
  *
  * @param struct FIFOqueue *q, the FIFO queue
- * @param struct customer *c, the element to insert
+ * @param int c, the id of the customer to insert
  */
-void enqueue(struct FIFOqueue *q, struct customer *c);
+void enqueue(struct FIFOqueue *q, int c);
 /*
  * A function to remove element from queue
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
- * @return struct customer *, reference to the element which was removed
+ * @return int, the id of the customer which was removed, -1 if empty
  */
-struct customer *dequeue(struct FIFOqueue *q);
+int dequeue(struct FIFOqueue *q);
 /*
  * A function to get first element without removing
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
- * @return struct customer *, reference to element
+ * @return int, the id of the customer, -1 if empty
  */
-struct customer *getFirst(struct FIFOqueue *q);
+int getFirst(struct FIFOqueue *q);
 /*
  * A function to check if FIFO queue is empty
  *
@@ -74,6 +82,7 @@ int isEmptyFIFO(struct FIFOqueue *q);
 int getSize(struct FIFOqueue *q);
 /*
  * A function to free the FIFO queue
+ * The elements belong to the customer pool and are freed with it
  *
  * @param struct FIFOqueue *q, the FIFO queue
  *
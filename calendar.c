@@ -0,0 +1,248 @@
+/***************************************************************
+  Paul Lewis
+  File Name: calendar.c
+  Simulation
+
+  Contains functions for creating, using, and freeing a calendar queue
+***************************************************************/
+
+#include "calendar.h"
+
+/*
+ * A function to find the day an event time falls on
+ *
+ * @param struct calendar *cq, the queue
+ * @param double t, the event time
+ *
+ * @return long long, the day number
+ */
+static long long dayOf(struct calendar *cq, double t) {
+    return (long long) floor(t/cq->width);
+}
+/*
+ * A function to allocate an empty bucket array
+ *
+ * @param int numBuckets, the number of buckets
+ *
+ * @local struct eventNode **b, the new array
+ *
+ * @return struct eventNode **, the bucket array
+ */
+static struct eventNode **newBuckets(int numBuckets) {
+    struct eventNode **b = calloc(numBuckets, sizeof(struct eventNode *));
+    if(b == NULL) {
+        perror("calloc failed. cannot construct calendar buckets.\n");
+        exit(1);
+    }
+    return b;
+}
+/*
+ * A function to allocate and initialize an empty calendar queue
+ *
+ * @local struct calendar *cq, reference to new queue
+ *
+ * @return struct calendar *, reference to the queue
+ */
+struct calendar *newCalendar() {
+    struct calendar *cq = (struct calendar *) malloc(sizeof(struct calendar));
+    if(cq == NULL) {
+        perror("malloc failed. cannot construct calendar queue.\n");
+        exit(1);
+    }
+    cq->theSize = 0;
+    cq->numBuckets = CALENDAR_MIN_BUCKETS;
+    cq->width = 1.0;
+    cq->buckets = newBuckets(cq->numBuckets);
+    cq->day = 0;
+    initNodePool(&cq->nodes);
+    return cq;
+}
+/*
+ * A function to place a node in its bucket, after any equal times
+ *
+ * @param struct calendar *cq, the queue
+ * @param struct eventNode *e, the node
+ *
+ * @local long long d, the day of the event
+ * @local struct eventNode **link, the link to update
+ */
+static void placeNode(struct calendar *cq, struct eventNode *e) {
+    long long d = dayOf(cq, e->ev.time);
+    struct eventNode **link = &cq->buckets[d % cq->numBuckets];
+    while(*link != NULL && !(e->ev.time < (*link)->ev.time))
+        link = &(*link)->next;
+    e->next = *link;
+    *link = e;
+    if(d < cq->day)     // event is earlier than the search start
+        cq->day = d;
+}
+/*
+ * A function to find the bucket holding the smallest event
+ * Scans one year of days from the current day, then falls back
+ * to a direct search of every bucket
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @local long long d, the day being checked
+ * @local int i, a counter
+ * @local int b, the bucket being checked
+ * @local int best, the bucket with the smallest head in the direct search
+ *
+ * @return int, the bucket index
+ */
+static int findMinBucket(struct calendar *cq) {
+    long long d = cq->day;
+    int i, b, best = -1;
+    for(i=0;i<cq->numBuckets;i++,d++) {
+        b = d % cq->numBuckets;
+        if(cq->buckets[b] != NULL && dayOf(cq, cq->buckets[b]->ev.time) <= d) {
+            cq->day = d;
+            return b;
+        }
+    }
+    for(b=0;b<cq->numBuckets;b++)       // nothing this year, search directly
+        if(cq->buckets[b] != NULL && (best < 0 || cq->buckets[b]->ev.time < cq->buckets[best]->ev.time))
+            best = b;
+    cq->day = dayOf(cq, cq->buckets[best]->ev.time);
+    return best;
+}
+/*
+ * A function to unlink the smallest node without resizing
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @local int b, the bucket of the smallest node
+ * @local struct eventNode *e, the node
+ *
+ * @return struct eventNode *, the node
+ */
+static struct eventNode *popNode(struct calendar *cq) {
+    int b = findMinBucket(cq);
+    struct eventNode *e = cq->buckets[b];
+    cq->buckets[b] = e->next;
+    cq->theSize--;
+    return e;
+}
+/*
+ * A function to change the number of buckets and choose a new width
+ * The width is three times the average separation of the first
+ * CALENDAR_SAMPLE events, ignoring separations over twice the average
+ *
+ * @param struct calendar *cq, the queue
+ * @param int numBuckets, the new number of buckets
+ *
+ * @local struct eventNode *sample[], the first events in time order
+ * @local struct eventNode *all, every node, linked through next
+ * @local struct eventNode *e, a node being moved
+ * @local struct eventNode **old, the old bucket array
+ * @local int oldBuckets, the old number of buckets
+ * @local int k, the number of sampled events
+ * @local int i, int used, counters
+ * @local double avg, double sum, used to compute the width
+ */
+static void resize(struct calendar *cq, int numBuckets) {
+    struct eventNode *sample[CALENDAR_SAMPLE], *all = NULL, *e;
+    struct eventNode **old = cq->buckets;
+    int oldBuckets = cq->numBuckets, k, i, used = 0;
+    double avg, sum = 0.0;
+
+    k = cq->theSize < CALENDAR_SAMPLE ? cq->theSize : CALENDAR_SAMPLE;
+    for(i=0;i<k;i++)
+        sample[i] = popNode(cq);
+    if(k > 1) {
+        avg = (sample[k-1]->ev.time - sample[0]->ev.time)/(k-1);
+        for(i=1;i<k;i++) {
+            if(sample[i]->ev.time - sample[i-1]->ev.time <= 2.0*avg) {
+                sum += sample[i]->ev.time - sample[i-1]->ev.time;
+                used++;
+            }
+        }
+        if(used > 0 && sum > 0.0)
+            cq->width = 3.0*sum/used;
+    }
+    cq->theSize += k;
+
+    for(i=0;i<oldBuckets;i++) {         // unlink every remaining node
+        while(old[i] != NULL) {
+            e = old[i];
+            old[i] = e->next;
+            e->next = all;
+            all = e;
+        }
+    }
+    for(i=0;i<k;i++) {
+        sample[i]->next = all;
+        all = sample[i];
+    }
+    free(old);
+
+    cq->numBuckets = numBuckets;
+    cq->buckets = newBuckets(numBuckets);
+    cq->day = k > 0 ? dayOf(cq, sample[0]->ev.time) : 0;
+    while(all != NULL) {                // rehash with the new width
+        e = all;
+        all = e->next;
+        placeNode(cq, e);
+    }
+}
+/*
+ * A function to add an element to a calendar queue
+ * The number of buckets doubles when there are twice as many events
+ *
+ * @param struct calendar *cq, the queue
+ * @param struct event ev, the element to add
+ */
+void calendarInsert(struct calendar *cq, struct event ev) {
+    placeNode(cq, newNode(&cq->nodes, ev));
+    if(++cq->theSize > 2*cq->numBuckets)
+        resize(cq, 2*cq->numBuckets);
+}
+/*
+ * A function to remove the smallest element from a calendar queue
+ * The number of buckets halves when there are half as many events
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @local struct eventNode *e, the smallest node
+ * @local struct event min, the element to return
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event calendarDeleteMin(struct calendar *cq) {
+    struct eventNode *e;
+    struct event min;
+    if(cq->theSize == 0) {
+        min.id = -1;
+        return min;
+    }
+    e = popNode(cq);
+    min = e->ev;
+    freeNode(&cq->nodes, e);
+    if(cq->theSize < cq->numBuckets/2 && cq->numBuckets > CALENDAR_MIN_BUCKETS)
+        resize(cq, cq->numBuckets/2);
+    return min;
+}
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @return struct event, the element
+ */
+struct event calendarGetMin(struct calendar *cq) {
+    return cq->buckets[findMinBucket(cq)]->ev;
+}
+/*
+ * A function to free a calendar queue
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @return struct calendar *, reference to the freed queue (NULL)
+ */
+struct calendar *freeCalendar(struct calendar *cq) {
+    clearNodePool(&cq->nodes);
+    free(cq->buckets);
+    free(cq);
+    cq = NULL;
+    return cq;
+}
@@ -0,0 +1,88 @@
+/***************************************************************
+  Paul Lewis
+  File Name: calendar.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for calendar.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "customer.h"
+#include "eventnode.h"
+
+#ifndef _calendar_h
+#define _calendar_h
+
+/*
+ * The smallest number of buckets in a calendar queue
+ */
+#define CALENDAR_MIN_BUCKETS 2
+/*
+ * The number of events sampled to estimate a new bucket width
+ */
+#define CALENDAR_SAMPLE 25
+
+/*
+ * The calendar queue structure (Brown, 1988)
+ * Bucket i holds, in sorted order, the events whose time falls on
+ * day i of any year, where a day is width long and a year is
+ * numBuckets days
+ *
+ * @field int theSize, the number of events
+ * @field int numBuckets, the number of buckets
+ * @field double width, the length of time covered by one bucket
+ * @field struct eventNode **buckets, the sorted bucket lists
+ * @field long long day, the day the search for the next event starts on,
+ *  no event is earlier than this day
+ * @field struct nodePool nodes, the pool nodes are allocated from
+ */
+struct calendar {
+    int theSize;
+    int numBuckets;
+    double width;
+    struct eventNode **buckets;
+    long long day;
+    struct nodePool nodes;
+};
+
+/*
+ * A function to allocate and initialize an empty calendar queue
+ *
+ * @return struct calendar *, reference to the queue
+ */
+struct calendar *newCalendar();
+/*
+ * A function to add an element to a calendar queue
+ *
+ * @param struct calendar *cq, the queue
+ * @param struct event ev, the element to add
+ */
+void calendarInsert(struct calendar *cq, struct event ev);
+/*
+ * A function to remove the smallest element from a calendar queue
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event calendarDeleteMin(struct calendar *cq);
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @return struct event, the element
+ */
+struct event calendarGetMin(struct calendar *cq);
+/*
+ * A function to free a calendar queue
+ *
+ * @param struct calendar *cq, the queue
+ *
+ * @return struct calendar *, reference to the freed queue (NULL)
+ */
+struct calendar *freeCalendar(struct calendar *cq);
+
+#endif
@@ -0,0 +1,542 @@
+/***************************************************************
+  Paul Lewis
+  File Name: checkpoint.c
+  Simulation
+
+  Contains functions for checkpointing a run to a file and
+  restoring it. A checkpoint holds the run's scalars, both variate
+  streams, the customer pool, the FIFO queue, the event set and the
+  histograms, so a restored run goes on exactly as the run would
+  have. Each checkpoint is written to a temporary file, synced and
+  renamed over the last, so a crash leaves the last one whole
+***************************************************************/
+
+#include <limits.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include "model.h"
+#include "checkpoint.h"
+
+/*
+ * A function to hash bytes with 64 bit FNV-1a
+ *
+ * @param const char *data, the bytes
+ * @param size_t length, the number of bytes
+ *
+ * @local uint64_t h, the hash
+ * @local size_t i, a counter
+ *
+ * @return uint64_t, the hash
+ */
+static uint64_t checksum(const char *data, size_t length) {
+    uint64_t h = 14695981039346656037ULL;
+    size_t i;
+    for(i=0;i<length;i++) {
+        h ^= (unsigned char) data[i];
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+/*
+ * A function to append bytes to a snapshot
+ *
+ * @param struct checkpointer *c, the checkpoints
+ * @param const void *data, the bytes
+ * @param size_t size, the number of bytes
+ */
+static void put(struct checkpointer *c, const void *data, size_t size) {
+    if(c->length + size > c->size) {
+        c->size = 2*(c->length + size);
+        c->snapshot = (char *) realloc(c->snapshot, c->size);
+        if(c->snapshot == NULL) {
+            perror("realloc error. cannot grow checkpoint.\n");
+            exit(1);
+        }
+    }
+    memcpy(c->snapshot + c->length, data, size);
+    c->length += size;
+}
+/*
+ * A function to append a histogram to a snapshot, only the buckets
+ * from the first to the last that are not empty
+ *
+ * @param struct checkpointer *c, the checkpoints
+ * @param const struct histogram *h, the histogram
+ *
+ * @local int32_t lo, hi, the first and last buckets that are not empty
+ */
+static void putHistogram(struct checkpointer *c, const struct histogram *h) {
+    int32_t lo = 0, hi = HIST_BUCKETS - 1;
+    while(lo < HIST_BUCKETS && h->counts[lo] == 0)
+        lo++;
+    while(hi >= lo && h->counts[hi] == 0)
+        hi--;
+    put(c, &h->total, sizeof(h->total));
+    put(c, &lo, sizeof(lo));
+    put(c, &hi, sizeof(hi));
+    if(hi >= lo)
+        put(c, h->counts + lo, sizeof(long) * (hi - lo + 1));
+}
+/*
+ * A function to write a buffer to a file descriptor
+ *
+ * @param int fd, the file
+ * @param const char *data, the bytes
+ * @param size_t length, the number of bytes
+ *
+ * @local ssize_t got, the bytes written by one call
+ *
+ * @return int, 0, or -1 on an error
+ */
+static int writeAll(int fd, const char *data, size_t length) {
+    ssize_t got;
+    while(length > 0) {
+        if((got = write(fd, data, length)) < 0)
+            return -1;
+        data += got;
+        length -= got;
+    }
+    return 0;
+}
+/*
+ * A function to write a snapshot to its file, atomically: it goes to
+ * a temporary file that is synced and then renamed over the last one,
+ * and the directory is synced so the rename survives a crash
+ *
+ * @param struct checkpointer *c, the checkpoints
+ *
+ * @local int fd, the file being written, then the directory
+ * @local char *slash, the last / of the path
+ * @local int ok, boolean, whether the checkpoint was written
+ *
+ * @return int, boolean, whether the checkpoint was written
+ */
+static int writeSnapshot(struct checkpointer *c) {
+    int fd, ok;
+    char *slash;
+    fd = open(c->temp, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0)
+        return 0;
+    ok = writeAll(fd, (const char *) &c->head, sizeof(c->head)) == 0
+        && writeAll(fd, c->snapshot, c->length) == 0 && fsync(fd) == 0;
+    if(close(fd) != 0 || !ok || rename(c->temp, c->path) != 0)
+        return 0;
+    slash = strrchr(c->path, '/');
+    if(slash != NULL)
+        *slash = '\0';
+    fd = open(slash == NULL ? "." : (slash == c->path ? "/" : c->path), O_RDONLY);
+    if(slash != NULL)
+        *slash = '/';
+    if(fd >= 0) {
+        fsync(fd);
+        close(fd);
+    }
+    return 1;
+}
+/*
+ * A function run by the writer thread, writing the snapshot each
+ * time it is passed one until the run stops taking checkpoints
+ *
+ * @param void *arg, the checkpoints
+ *
+ * @local struct checkpointer *c, the checkpoints
+ * @local int ok, boolean, whether the checkpoint was written
+ *
+ * @return void *, NULL
+ */
+static void *writeCheckpoints(void *arg) {
+    struct checkpointer *c = (struct checkpointer *) arg;
+    int ok;
+    pthread_mutex_lock(&c->lock);
+    for(;;) {
+        while(!c->busy && !c->done)
+            pthread_cond_wait(&c->cond, &c->lock);
+        if(!c->busy)
+            break;
+        pthread_mutex_unlock(&c->lock);
+        ok = writeSnapshot(c);
+        pthread_mutex_lock(&c->lock);
+        c->written += ok;
+        c->busy = 0;
+        pthread_cond_broadcast(&c->cond);
+    }
+    pthread_mutex_unlock(&c->lock);
+    return NULL;
+}
+/*
+ * A function to fill the header that ties a checkpoint to its run
+ *
+ * @param struct checkpointHeader *h, the header
+ * @param const struct simConfig *cfg, the config
+ */
+static void fillHeader(struct checkpointHeader *h, const struct simConfig *cfg) {
+    memset(h, 0, sizeof(*h));
+    memcpy(h->magic, CHECKPOINT_MAGIC, sizeof(h->magic));
+    h->version = CHECKPOINT_VERSION;
+    h->stateSize = sizeof(struct simulation);
+    h->lambda = cfg->lambda;
+    h->mu = cfg->mu;
+    h->m = cfg->m;
+    h->engine = cfg->engine;
+    h->n = cfg->n;
+    h->seed = cfg->seed;
+    h->method = cfg->method;
+    h->stopOn = cfg->stopOn;
+    h->tolerance = cfg->tolerance;
+    h->warmup = cfg->warmup;
+    h->traceRecords = cfg->trace != NULL ? cfg->trace->records : 0;
+}
+/*
+ * A function to start taking checkpoints of a run
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simConfig *cfg, the config, cfg->checkpoint is the file
+ *
+ * @local struct checkpointer *c, the checkpoints
+ */
+void startCheckpoints(struct simulation *sim, const struct simConfig *cfg) {
+    struct checkpointer *c = (struct checkpointer *) malloc(sizeof(struct checkpointer));
+    if(c == NULL) {
+        perror("malloc error. cannot create checkpoints.\n");
+        exit(1);
+    }
+    c->path = (char *) malloc(strlen(cfg->checkpoint) + 1);
+    c->temp = (char *) malloc(strlen(cfg->checkpoint) + 5);
+    if(c->path == NULL || c->temp == NULL) {
+        perror("malloc error. cannot create checkpoints.\n");
+        exit(1);
+    }
+    strcpy(c->path, cfg->checkpoint);
+    sprintf(c->temp, "%s.tmp", cfg->checkpoint);
+    c->every = cfg->checkpointEvery;
+    fillHeader(&c->head, cfg);
+    c->snapshot = NULL;
+    c->length = 0;
+    c->size = 0;
+    c->events = NULL;
+    c->eventSize = 0;
+    c->busy = 0;
+    c->done = 0;
+    c->written = 0;
+    pthread_mutex_init(&c->lock, NULL);
+    pthread_cond_init(&c->cond, NULL);
+    if(pthread_create(&c->writer, NULL, writeCheckpoints, c) != 0) {
+        perror("pthread_create error. cannot start checkpoint writer.\n");
+        exit(1);
+    }
+    sim->ckpt = c;
+    sim->nextCheckpoint = sim->numberOfCustomers + c->every;
+}
+/*
+ * A function to take the events out of a run's event set in order
+ * and schedule them again on a new event set of the same engine
+ * Events at equal times then leave in the same order in the run and
+ * in any run restored from the checkpoint
+ *
+ * @param struct simulation *sim, the run
+ * @param struct checkpointer *c, the checkpoints, holding the events after
+ *
+ * @local int i, a counter
+ * @local int count, the number of events
+ * @local int type, the engine
+ *
+ * @return int, the number of events
+ */
+static int rebuildEventSet(struct simulation *sim, struct checkpointer *c) {
+    int i, count = sim->es->theSize, type = sim->es->type;
+    if(count > c->eventSize) {
+        c->eventSize = 2*count;
+        c->events = (struct event *) realloc(c->events, sizeof(struct event) * c->eventSize);
+        if(c->events == NULL) {
+            perror("realloc error. cannot grow checkpoint.\n");
+            exit(1);
+        }
+    }
+    for(i=0;i<count;i++)
+        c->events[i] = nextEvent(sim->es);
+    freeEventSet(sim->es);
+    sim->es = newEventSet(type);
+    for(i=0;i<count;i++)
+        schedule(sim->es, c->events[i]);
+    return count;
+}
+/*
+ * A function to take a checkpoint of a run between two events
+ * The snapshot is only made if the writer has finished the last one,
+ * so the run never waits on the disk
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @local struct checkpointer *c, the checkpoints
+ * @local struct customerPool *p, the customer pool
+ * @local int32_t i, a counter
+ * @local int32_t count, the number of events or customers waiting
+ * @local int32_t inPlace[], whether each variate stream reads its trace in place
+ * @local int busy, boolean, whether the writer is still writing
+ */
+void takeCheckpoint(struct simulation *sim) {
+    struct checkpointer *c = sim->ckpt;
+    struct customerPool *p = sim->p;
+    int32_t i, count, inPlace[2];
+    int busy;
+    sim->nextCheckpoint += c->every;
+    count = rebuildEventSet(sim, c);
+    pthread_mutex_lock(&c->lock);
+    busy = c->busy;
+    pthread_mutex_unlock(&c->lock);
+    if(busy)
+        return;
+    c->length = 0;
+    put(c, sim, sizeof(struct simulation));
+    inPlace[0] = sim->arrivals.at != sim->arrivals.buf;
+    inPlace[1] = sim->services.at != sim->services.buf;
+    put(c, inPlace, sizeof(inPlace));
+    put(c, p, sizeof(struct customerPool));
+    put(c, p->arrivalTime, sizeof(double) * p->used);
+    put(c, p->startOfServiceTime, sizeof(double) * p->used);
+    put(c, p->departureTime, sizeof(double) * p->used);
+    put(c, p->nextFree, sizeof(int) * p->used);
+    put(c, &count, sizeof(count));
+    put(c, c->events, sizeof(struct event) * count);
+    count = sim->q->size;
+    put(c, &count, sizeof(count));
+    for(i=0;i<count;i++)
+        put(c, &sim->q->ring[(sim->q->head + i) & (sim->q->capacity - 1)], sizeof(int));
+    putHistogram(c, sim->wHist);
+    putHistogram(c, sim->wqHist);
+    c->head.length = c->length;
+    c->head.checksum = checksum(c->snapshot, c->length);
+    pthread_mutex_lock(&c->lock);
+    c->busy = 1;
+    pthread_cond_broadcast(&c->cond);
+    pthread_mutex_unlock(&c->lock);
+}
+/*
+ * A function to wait for the last checkpoint of a run to be written
+ * and stop taking them
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @local struct checkpointer *c, the checkpoints
+ * @local long written, the checkpoints written
+ *
+ * @return long, the checkpoints written
+ */
+long stopCheckpoints(struct simulation *sim) {
+    struct checkpointer *c = sim->ckpt;
+    long written;
+    pthread_mutex_lock(&c->lock);
+    c->done = 1;
+    pthread_cond_broadcast(&c->cond);
+    pthread_mutex_unlock(&c->lock);
+    pthread_join(c->writer, NULL);
+    pthread_mutex_destroy(&c->lock);
+    pthread_cond_destroy(&c->cond);
+    written = c->written;
+    free(c->path);
+    free(c->temp);
+    free(c->snapshot);
+    free(c->events);
+    free(c);
+    sim->ckpt = NULL;
+    sim->nextCheckpoint = LONG_MAX;
+    return written;
+}
+/*
+ * A function to read a checkpoint and check it is whole and belongs
+ * to a config
+ *
+ * @param const struct simConfig *cfg, the config, cfg->restore is the checkpoint
+ * @param struct checkpointHeader *h, where to store the header
+ *
+ * @local FILE *fp, the checkpoint
+ * @local struct checkpointHeader want, the header the config would write
+ * @local char *state, the state
+ *
+ * @return char *, the state, h->length bytes, or NULL if it cannot be used
+ */
+static char *readCheckpoint(const struct simConfig *cfg, struct checkpointHeader *h) {
+    FILE *fp;
+    struct checkpointHeader want;
+    char *state;
+    if((fp = fopen(cfg->restore, "rb")) == NULL)
+        return NULL;
+    fillHeader(&want, cfg);
+    if(fread(h, sizeof(*h), 1, fp) != 1 || memcmp(h->magic, want.magic, sizeof(h->magic)) != 0
+            || h->version != want.version || h->stateSize != want.stateSize
+            || h->lambda != want.lambda || h->mu != want.mu || h->m != want.m
+            || h->engine != want.engine || h->n != want.n || h->seed != want.seed
+            || h->method != want.method || h->stopOn != want.stopOn
+            || h->tolerance != want.tolerance || h->warmup != want.warmup
+            || h->traceRecords != want.traceRecords || h->length > ((uint64_t) 1 << 40)) {
+        fclose(fp);
+        return NULL;
+    }
+    state = (char *) malloc(h->length);
+    if(state == NULL) {
+        perror("malloc error. cannot read checkpoint.\n");
+        exit(1);
+    }
+    if(fread(state, 1, h->length, fp) != h->length || fgetc(fp) != EOF
+            || checksum(state, h->length) != h->checksum) {
+        free(state);
+        fclose(fp);
+        return NULL;
+    }
+    fclose(fp);
+    return state;
+}
+/*
+ * A function to check that a checkpoint is whole and belongs to a config
+ *
+ * @param const struct simConfig *cfg, the config, cfg->restore is the checkpoint
+ *
+ * @local struct checkpointHeader h, the header
+ * @local char *state, the state
+ *
+ * @return int, 0, or -1 if it cannot be read, is damaged or is of another run
+ */
+int checkCheckpoint(const struct simConfig *cfg) {
+    struct checkpointHeader h;
+    char *state = readCheckpoint(cfg, &h);
+    if(state == NULL)
+        return -1;
+    free(state);
+    return 0;
+}
+/*
+ * A function to take bytes from the state of a checkpoint
+ *
+ * @param const char **at, where the next bytes are, moved past them
+ * @param const char *end, the end of the state
+ * @param void *data, where to copy them
+ * @param size_t size, the number of bytes
+ *
+ * @return int, 0, or -1 if the state is too short
+ */
+static int take(const char **at, const char *end, void *data, size_t size) {
+    if((size_t) (end - *at) < size)
+        return -1;
+    memcpy(data, *at, size);
+    *at += size;
+    return 0;
+}
+/*
+ * A function to take a histogram from the state of a checkpoint
+ *
+ * @param const char **at, where the histogram is, moved past it
+ * @param const char *end, the end of the state
+ * @param struct histogram *h, the histogram to fill
+ *
+ * @local int32_t lo, hi, the first and last buckets stored
+ *
+ * @return int, 0, or -1 if the state is damaged
+ */
+static int takeHistogram(const char **at, const char *end, struct histogram *h) {
+    int32_t lo, hi;
+    clearHistogram(h);
+    if(take(at, end, &h->total, sizeof(h->total)) != 0 || take(at, end, &lo, sizeof(lo)) != 0
+            || take(at, end, &hi, sizeof(hi)) != 0 || lo < 0 || hi >= HIST_BUCKETS)
+        return -1;
+    if(hi < lo)
+        return 0;
+    return take(at, end, h->counts + lo, sizeof(long) * (hi - lo + 1));
+}
+/*
+ * A function to point a restored variate stream at its batch again
+ *
+ * @param struct variates *v, the restored stream
+ * @param const double *trace, the trace column of this run, NULL if none
+ * @param int inPlace, boolean, whether its batch was read in place from the trace
+ */
+static void restoreVariates(struct variates *v, const double *trace, int inPlace) {
+    v->trace = trace;
+    v->at = inPlace ? trace + v->position - VARIATE_BATCH : v->buf;
+}
+/*
+ * A function to restore a run from a checkpoint
+ * The run's own queue, pool, histograms and streams are kept and
+ * filled with the checkpoint's, and the event set is made afresh
+ * It must be restored before its checkpoints or snapshots are started
+ *
+ * @param struct simulation *sim, the run, set up for cfg but not started
+ * @param const struct simConfig *cfg, the config, cfg->restore is the checkpoint
+ *
+ * @local struct checkpointHeader h, the header
+ * @local struct simulation saved, the run's own pointers
+ * @local struct customerPool pool, the checkpoint's pool
+ * @local struct event ev, an event
+ * @local int32_t i, a counter
+ * @local int32_t count, the number of events or customers waiting
+ * @local int32_t inPlace[], whether each stream read its trace in place
+ * @local int c, a customer waiting
+ * @local char *state, the state
+ * @local const char *at, const char *end, the part of the state still to restore
+ *
+ * @return long, the customers the run had taken, or -1 if it cannot be restored
+ */
+long restoreCheckpoint(struct simulation *sim, const struct simConfig *cfg) {
+    struct checkpointHeader h;
+    struct simulation saved = *sim;
+    struct customerPool pool;
+    struct event ev;
+    int32_t i, count, inPlace[2];
+    int c;
+    char *state = readCheckpoint(cfg, &h);
+    const char *at = state, *end = state + h.length;
+    if(state == NULL)
+        return -1;
+    if(take(&at, end, sim, sizeof(struct simulation)) != 0 || take(&at, end, inPlace, sizeof(inPlace)) != 0
+            || take(&at, end, &pool, sizeof(pool)) != 0 || pool.used < 0 || pool.used > pool.capacity)
+        goto damaged;
+    sim->es = saved.es;         // the run's own structures, filled below
+    sim->q = saved.q;
+    sim->p = saved.p;
+    sim->wHist = saved.wHist;
+    sim->wqHist = saved.wqHist;
+    sim->log = saved.log;
+    sim->ckpt = saved.ckpt;
+    sim->next = saved.next;
+    sim->prof = saved.prof;     // a profile only covers what this process ran
+    sim->progress = saved.progress;
+    sim->nextProgress = saved.nextProgress;
+    sim->nextCheckpoint = sim->ckpt != NULL ? sim->numberOfCustomers + sim->ckpt->every : LONG_MAX;
+    restoreVariates(&sim->arrivals, saved.arrivals.trace, inPlace[0]);
+    restoreVariates(&sim->services, saved.services.trace, inPlace[1]);
+    reservePool(sim->p, pool.capacity);
+    if(take(&at, end, sim->p->arrivalTime, sizeof(double) * pool.used) != 0
+            || take(&at, end, sim->p->startOfServiceTime, sizeof(double) * pool.used) != 0
+            || take(&at, end, sim->p->departureTime, sizeof(double) * pool.used) != 0
+            || take(&at, end, sim->p->nextFree, sizeof(int) * pool.used) != 0)
+        goto damaged;
+    sim->p->used = pool.used;
+    sim->p->freeList = pool.freeList;
+    sim->p->live = pool.live;
+    sim->p->peakLive = pool.peakLive;
+    sim->p->allocations = pool.allocations;
+    freeEventSet(sim->es);
+    sim->es = newEventSet(cfg->engine);
+    if(take(&at, end, &count, sizeof(count)) != 0)
+        goto damaged;
+    for(i=0;i<count;i++) {
+        if(take(&at, end, &ev, sizeof(ev)) != 0)
+            goto damaged;
+        schedule(sim->es, ev);
+    }
+    sim->q->size = 0;
+    sim->q->head = 0;
+    if(take(&at, end, &count, sizeof(count)) != 0)
+        goto damaged;
+    for(i=0;i<count;i++) {
+        if(take(&at, end, &c, sizeof(c)) != 0)
+            goto damaged;
+        enqueue(sim->q, c);
+    }
+    if(takeHistogram(&at, end, sim->wHist) != 0 || takeHistogram(&at, end, sim->wqHist) != 0 || at != end)
+        goto damaged;
+    free(state);
+    return sim->numberOfCustomers;
+damaged:
+    free(state);
+    return -1;
+}
@@ -0,0 +1,136 @@
+/***************************************************************
+  Paul Lewis
+  File Name: checkpoint.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for checkpoint.c
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <pthread.h>
+#include "libsimulation.h"
+
+#ifndef _checkpoint_h
+#define _checkpoint_h
+
+#define CHECKPOINT_MAGIC "SIMCKPT1"    // the first 8 bytes of every checkpoint
+#define CHECKPOINT_VERSION 1
+
+struct simulation;
+
+/*
+ * The header of a checkpoint, the run it belongs to and the size
+ * and checksum of the state after it
+ * A checkpoint can only be restored by the same build of the program
+ *
+ * @field char magic[], CHECKPOINT_MAGIC, not terminated
+ * @field uint32_t version, CHECKPOINT_VERSION
+ * @field uint32_t stateSize, sizeof(struct simulation) of the build that wrote it
+ * @field uint64_t length, the bytes of state after the header
+ * @field uint64_t checksum, the FNV-1a hash of those bytes
+ * @field double lambda, double mu, int32_t m, int64_t n, uint64_t seed,
+ *  int32_t engine, int32_t method, double tolerance, int32_t stopOn,
+ *  int32_t warmup, the config of the run
+ * @field int64_t traceRecords, the customers in the trace replayed, 0 if none
+ */
+struct checkpointHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t stateSize;
+    uint64_t length;
+    uint64_t checksum;
+    double lambda;
+    double mu;
+    int32_t m;
+    int32_t engine;
+    int64_t n;
+    uint64_t seed;
+    int32_t method;
+    int32_t stopOn;
+    double tolerance;
+    int32_t warmup;
+    int32_t reserved;
+    int64_t traceRecords;
+};
+
+/*
+ * The checkpoints of a run. The state is copied into a snapshot
+ * between two events, and a writer thread writes the snapshot while
+ * the run goes on
+ *
+ * @field char *path, the checkpoint file
+ * @field char *temp, the file each checkpoint is written to before it replaces path
+ * @field long every, the customers between checkpoints
+ * @field struct checkpointHeader head, the header of the snapshot
+ * @field char *snapshot, the state
+ * @field size_t length, the bytes of state in the snapshot
+ * @field size_t size, the bytes allocated for the snapshot
+ * @field struct event *events, room to take the event set apart
+ * @field int eventSize, the events there is room for
+ * @field int busy, boolean, whether the writer is writing the snapshot
+ * @field int done, boolean, whether the writer should finish
+ * @field long written, the checkpoints written
+ * @field pthread_t writer, the writer thread
+ * @field pthread_mutex_t lock, guards busy and done
+ * @field pthread_cond_t cond, signalled when either changes
+ */
+struct checkpointer {
+    char *path;
+    char *temp;
+    long every;
+    struct checkpointHeader head;
+    char *snapshot;
+    size_t length;
+    size_t size;
+    struct event *events;
+    int eventSize;
+    int busy;
+    int done;
+    long written;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+/*
+ * A function to start taking checkpoints of a run
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simConfig *cfg, the config, cfg->checkpoint is the file
+ */
+void startCheckpoints(struct simulation *sim, const struct simConfig *cfg);
+/*
+ * A function to take a checkpoint of a run between two events
+ *
+ * @param struct simulation *sim, the run
+ */
+void takeCheckpoint(struct simulation *sim);
+/*
+ * A function to wait for the last checkpoint of a run to be written
+ * and stop taking them
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @return long, the checkpoints written
+ */
+long stopCheckpoints(struct simulation *sim);
+/*
+ * A function to check that a checkpoint is whole and belongs to a config
+ *
+ * @param const struct simConfig *cfg, the config, cfg->restore is the checkpoint
+ *
+ * @return int, 0, or -1 if it cannot be read, is damaged or is of another run
+ */
+int checkCheckpoint(const struct simConfig *cfg);
+/*
+ * A function to restore a run from a checkpoint
+ *
+ * @param struct simulation *sim, the run, set up for cfg but not started
+ * @param const struct simConfig *cfg, the config, cfg->restore is the checkpoint
+ *
+ * @return long, the customers the run had taken, or -1 if it cannot be restored
+ */
+long restoreCheckpoint(struct simulation *sim, const struct simConfig *cfg);
+
+#endif
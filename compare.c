@@ -0,0 +1,118 @@
+/***************************************************************
+  Paul Lewis
+  File Name: compare.c
+  Simulation
+
+  Compares two numbers of servers with common random numbers.
+  Replication r of each draws from the streams of replication r,
+  so the pair differs only in M, and the variance of the paired
+  differences is set against what independent streams would give
+***************************************************************/
+
+#include "model.h"
+#include "compare.h"
+#include "stats.h"
+#include "threadpool.h"
+
+/*
+ * One replication of both server counts, filled in by a worker thread
+ */
+struct compareJob {
+    const struct simConfig *cfg;
+    int m[2];
+    int rep;
+    struct results r[2];
+};
+
+/*
+ * A function run by a worker thread for one replication of both server counts
+ *
+ * @param void *arg, the struct compareJob to run
+ *
+ * @local struct compareJob *job, the replication
+ * @local struct simulation *sim, the run
+ * @local int i, a counter
+ */
+static void compareReplicate(void *arg) {
+    struct compareJob *job = (struct compareJob *) arg;
+    const struct simConfig *cfg = job->cfg;
+    struct simulation *sim;
+    int i;
+    for(i=0;i<2;i++) {
+        sim = newSimulation(cfg->lambda, cfg->mu, job->m[i], cfg->n, cfg->engine, cfg->method, cfg->seed, job->rep);
+        applyConfig(sim, cfg, job->rep);
+        runSimulation(sim);
+        job->r[i] = postCalc(sim);
+        freeSimulation(sim);
+    }
+}
+/*
+ * A function to compare cfg->m servers with m2 servers under common
+ * random numbers
+ *
+ * @param const struct simConfig *cfg, the run, cfg->replications pairs,
+ *  at least 2, antithetic and control are not used
+ * @param int m2, the other number of servers
+ * @param struct simComparison *out, where to store the comparison
+ *
+ * @local int i, k, counters
+ * @local int reps, the number of replications
+ * @local struct simConfig run, the config without antithetic pairs or controls
+ * @local struct compareJob *jobs, the replications
+ * @local struct threadPool *tp, the workers
+ * @local struct summary a, b, d, one statistic at each server count and their difference
+ * @local double independent, the variance the difference would have with independent streams
+ *
+ * @return int, 0, or -1 if the config is invalid
+ */
+int compareServers(const struct simConfig *cfg, int m2, struct simComparison *out) {
+    int i, k, reps;
+    struct simConfig run = *cfg;
+    struct compareJob *jobs;
+    struct threadPool *tp;
+    struct summary a, b, d;
+    double independent;
+    run.antithetic = 0;
+    run.control = 0;
+    if(!validConfig(&run) || m2 <= 0)
+        return -1;
+    reps = cfg->replications >= 2 ? cfg->replications : COMPARE_REPS;
+    jobs = (struct compareJob *) malloc(reps * sizeof(struct compareJob));
+    if(jobs == NULL) {
+        perror("malloc error. cannot create replications.\n");
+        exit(1);
+    }
+    tp = newThreadPool(cfg->threads);
+    for(k=0;k<reps;k++) {
+        jobs[k].cfg = &run;
+        jobs[k].m[0] = cfg->m;
+        jobs[k].m[1] = m2;
+        jobs[k].rep = k;
+        submitTask(tp, compareReplicate, &jobs[k]);
+    }
+    waitThreadPool(tp);
+    tp = freeThreadPool(tp);
+
+    out->m[0] = cfg->m;
+    out->m[1] = m2;
+    out->replications = reps;
+    for(i=0;i<RESULT_STATS;i++) {
+        initSummary(&a);
+        initSummary(&b);
+        initSummary(&d);
+        for(k=0;k<reps;k++) {   // in replication order so the results are deterministic
+            addSample(&a, *resultStat(&jobs[k].r[0], i));
+            addSample(&b, *resultStat(&jobs[k].r[1], i));
+            addSample(&d, *resultStat(&jobs[k].r[0], i) - *resultStat(&jobs[k].r[1], i));
+        }
+        *resultStat(&out->mean[0], i) = a.mean;
+        *resultStat(&out->mean[1], i) = b.mean;
+        *resultStat(&out->difference, i) = d.mean;
+        *resultStat(&out->halfWidth, i) = halfWidth95(&d);
+        independent = summaryVariance(&a) + summaryVariance(&b);
+        *resultStat(&out->reduction, i) = summaryVariance(&d) > 0 ? independent/summaryVariance(&d)
+            : (independent > 0 ? INFINITY : 1.0);
+    }
+    free(jobs);
+    return 0;
+}
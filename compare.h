@@ -0,0 +1,19 @@
+/***************************************************************
+  Paul Lewis
+  File Name: compare.h
+  Simulation
+
+  Contains #defines and #includes for compare.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _compare_h
+#define _compare_h
+
+/*
+ * The replications run when the config asks for fewer than two
+ */
+#define COMPARE_REPS 10
+
+#endif
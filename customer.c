@@ -3,52 +3,167 @@
   File Name: customer.c
   Simulation
 
-  Contains functions for creating and freeing a customer node
+  Contains functions for creating and freeing customers
+  in the pool of customer columns
 ***************************************************************/
 
 #include "customer.h"
 
 /*
- * A function to create allocate and initialize a new structure
+ * A function to resize one column of the pool
  *
- * @param float time, the absolute time
- * @param int arrbool, boolean to signify if arrival or departure
+ * @param void *column, the column
+ * @param size_t size, the new size in bytes
+ *
+ * @return void *, the resized column
+ */
+static void *growColumn(void *column, size_t size) {
+    column = realloc(column, size);
+    if(column == NULL) {
+        perror("realloc error. cannot grow customer pool.\n");
+        exit(1);
+    }
+    return column;
+}
+/*
+ * A function to allocate and initialize an empty customer pool
  *
- * @local struct customer *c, pointer to new customer
+ * @local struct customerPool *p, pointer to new pool
  *
- * @return struct customer *, reference to the customer
- */ 
-struct customer *newCustomer(float time, int arrbool) {
-    struct customer *c = (struct customer *) malloc (sizeof(struct customer));
-    if(c == NULL) {
-        perror("malloc error. cannot create customer.\n");
+ * @return struct customerPool *, reference to the new pool
+ */
+struct customerPool *newPool() {
+    struct customerPool *p = (struct customerPool *) malloc(sizeof(struct customerPool));
+    if(p == NULL) {
+        perror("malloc error. cannot create customer pool.\n");
         exit(1);
     }
 
+    p->arrivalTime = NULL;
+    p->startOfServiceTime = NULL;
+    p->departureTime = NULL;
+    p->nextFree = NULL;
+    p->capacity = 0;
+    p->used = 0;
+    p->freeList = -1;
+    p->live = 0;
+    p->peakLive = 0;
+    p->allocations = 0;
+
+    return p;
+}
+/*
+ * A function to take an unused id from the pool
+ * Recycled ids are preferred over fresh ones, the columns double when full
+ *
+ * @param struct customerPool *p, the pool
+ *
+ * @local int c, the id to return
+ *
+ * @return int, the id
+ */
+static int takeRecord(struct customerPool *p) {
+    int c;
+    if(p->freeList >= 0) {          // reuse most recently freed id
+        c = p->freeList;
+        p->freeList = p->nextFree[c];
+        return c;
+    }
+    if(p->used == p->capacity) {    // columns are full, double them
+        p->capacity = p->capacity ? p->capacity * 2 : CUSTOMER_POOL_SIZE;
+        p->arrivalTime = growColumn(p->arrivalTime, sizeof(double) * p->capacity);
+        p->startOfServiceTime = growColumn(p->startOfServiceTime, sizeof(double) * p->capacity);
+        p->departureTime = growColumn(p->departureTime, sizeof(double) * p->capacity);
+        p->nextFree = growColumn(p->nextFree, sizeof(int) * p->capacity);
+    }
+    return p->used++;
+}
+/*
+ * A function to take a customer from the pool and initialize it
+ *
+ * @param struct customerPool *p, the pool to take the record from
+ * @param double time, the absolute time
+ * @param int arrbool, boolean to signify if arrival or departure
+ *
+ * @local int c, the id of the new customer
+ *
+ * @return int, the id of the customer
+ */ 
+int newCustomer(struct customerPool *p, double time, int arrbool) {
+    int c = takeRecord(p);
+    p->allocations++;
+    if(++p->live > p->peakLive)     // keep track of peak number of live records
+        p->peakLive = p->live;
+
     /* initialize variables
        for the purposes of this simulation, arrbool will always be true */
     if(arrbool) {
-        c->arrivalTime = time;
-        c->startOfServiceTime = 0.0;
-        c->departureTime = -1.0;
-        c->pqTime = time;
+        p->arrivalTime[c] = time;
+        p->startOfServiceTime[c] = 0.0;
+        p->departureTime[c] = -1.0;
     } else {
-        c->arrivalTime = -1.0;
-        c->startOfServiceTime = 0.0;
-        c->departureTime = time;
-        c->pqTime = time;
+        p->arrivalTime[c] = -1.0;
+        p->startOfServiceTime[c] = 0.0;
+        p->departureTime[c] = time;
     }
     return c;
 }
 /*
- * A function to free a customer
+ * A function to return a customer to its pool
  *
- * @param struct customer *c, the customer to free
+ * @param struct customerPool *p, the pool the customer came from
+ * @param int c, the id of the customer to free
  * 
- * @return struct customer *, reference to the freed customer (NULL) 
+ * @return int, the freed id (-1) 
  */
-struct customer *freeCustomer(struct customer *c) {
-    free(c);
-    c = NULL;
-    return c;
+int freeCustomer(struct customerPool *p, int c) {
+    p->nextFree[c] = p->freeList;   // push onto free list
+    p->freeList = c;
+    p->live--;
+    return -1;
+}
+/*
+ * A function to empty a pool so another run can reuse its columns
+ * Every customer is released, the columns keep their capacity
+ *
+ * @param struct customerPool *p, the pool
+ */
+void resetPool(struct customerPool *p) {
+    p->used = 0;
+    p->freeList = -1;
+    p->live = 0;
+    p->peakLive = 0;
+    p->allocations = 0;
+}
+/*
+ * A function to grow the columns of a pool to hold at least a number of customers
+ * Columns that are already large enough are left alone
+ *
+ * @param struct customerPool *p, the pool
+ * @param int capacity, the customers to make room for
+ */
+void reservePool(struct customerPool *p, int capacity) {
+    if(capacity <= p->capacity)
+        return;
+    p->capacity = capacity;
+    p->arrivalTime = growColumn(p->arrivalTime, sizeof(double) * p->capacity);
+    p->startOfServiceTime = growColumn(p->startOfServiceTime, sizeof(double) * p->capacity);
+    p->departureTime = growColumn(p->departureTime, sizeof(double) * p->capacity);
+    p->nextFree = growColumn(p->nextFree, sizeof(int) * p->capacity);
+}
+/*
+ * A function to free a pool and every customer allocated from it
+ *
+ * @param struct customerPool *p, the pool
+ *
+ * @return struct customerPool *, reference to the freed pool (NULL)
+ */
+struct customerPool *freePool(struct customerPool *p) {
+    free(p->arrivalTime);
+    free(p->startOfServiceTime);
+    free(p->departureTime);
+    free(p->nextFree);
+    free(p);
+    p = NULL;
+    return p;
 }
@@ -3,7 +3,7 @@
   File Name: customer.h
   Simulation
 
-  Contains struct definitions, function prototypes, and #includes for customer.c
+  Contains struct definitions, function prototypes, #defines, and #includes for customer.c
 ***************************************************************/
 
 #include <stdlib.h>
@@ -13,40 +13,99 @@
 #define _customer_h
 
 /*
- * A structure for a customer
+ * The number of customer records the pool starts with, it doubles whenever it fills
+ */
+#define CUSTOMER_POOL_SIZE 4096
+
+/*
+ * An event in the future event set
+ * The key and the customer id are stored inline so that comparing
+ * events never touches customer records
  *
- * @field float arrivalTime, the time of arrival
- * @field float startOfServiceTime, the time the customer is served
- * @field float departureTime, the time of departure
- * @field float pqTime, equal to either arrival or departure time
- *  used for comparison in functions
- * @field struct customer *nextCust, pointer to next customer
- *  used for FIFO queue
+ * @field double time, the time of the event, either arrival or departure time
+ * @field int id, the customer the event belongs to
  */
-struct customer {
-    float arrivalTime;
-    float startOfServiceTime;
-    float departureTime;
-    float pqTime;
-    struct customer *nextCust;
+struct event {
+    double time;
+    int id;
 };
 
 /*
- * A function to create allocate and initialize a new structure
+ * The customer pool structure
+ * Customers are identified by an id that indexes a column for each field.
+ * Freed ids are recycled through an intrusive free list in LIFO order,
+ * so the most recently freed (and most likely cached) record is handed out next
+ *
+ * @field double *arrivalTime, the time of arrival, by id
+ * @field double *startOfServiceTime, the time the customer is served, by id
+ * @field double *departureTime, the time of departure, negative until
+ *  the customer is scheduled to depart, by id
+ * @field int *nextFree, the next id on the free list, by id
+ * @field int capacity, the size of each column
+ * @field int used, the number of ids ever handed out
+ * @field int freeList, the most recently freed id, -1 if none
+ * @field long live, the number of ids currently handed out
+ * @field long peakLive, the largest value live has reached
+ * @field long allocations, the number of calls to newCustomer
+ */
+struct customerPool {
+    double *arrivalTime;
+    double *startOfServiceTime;
+    double *departureTime;
+    int *nextFree;
+    int capacity;
+    int used;
+    int freeList;
+    long live;
+    long peakLive;
+    long allocations;
+};
+
+/*
+ * A function to allocate and initialize an empty customer pool
+ *
+ * @return struct customerPool *, reference to the new pool
+ */
+struct customerPool *newPool();
+/*
+ * A function to take a customer from the pool and initialize it
  *
- * @param float time, the absolute time
+ * @param struct customerPool *p, the pool to take the record from
+ * @param double time, the absolute time
  * @param int arrbool, boolean to signify if arrival or departure
  *
- * @return struct customer *, reference to the customer
+ * @return int, the id of the customer
  */ 
-struct customer *newCustomer(float time, int arrbool);
+int newCustomer(struct customerPool *p, double time, int arrbool);
 /*
- * A function to free a customer
+ * A function to return a customer to its pool
  *
- * @param struct customer *c, the customer to free
+ * @param struct customerPool *p, the pool the customer came from
+ * @param int c, the id of the customer to free
  * 
- * @return struct customer *, reference to the freed customer (NULL) 
+ * @return int, the freed id (-1) 
+ */
+int freeCustomer(struct customerPool *p, int c);
+/*
+ * A function to empty a pool so another run can reuse its columns
+ *
+ * @param struct customerPool *p, the pool
+ */
+void resetPool(struct customerPool *p);
+/*
+ * A function to grow the columns of a pool to hold at least a number of customers
+ *
+ * @param struct customerPool *p, the pool
+ * @param int capacity, the customers to make room for
+ */
+void reservePool(struct customerPool *p, int capacity);
+/*
+ * A function to free a pool and every customer allocated from it
+ *
+ * @param struct customerPool *p, the pool
+ *
+ * @return struct customerPool *, reference to the freed pool (NULL)
  */
-struct customer *freeCustomer(struct customer *c);
+struct customerPool *freePool(struct customerPool *p);
 
 #endif
@@ -0,0 +1,126 @@
+/***************************************************************
+  Paul Lewis
+  File Name: dheap.c
+  Simulation
+
+  Contains functions for creating, using, and freeing an implicit
+  d-ary heap, which is shallower than the binary heap in heap.c
+***************************************************************/
+
+#include "dheap.h"
+
+/*
+ * A function to allocate and initialize an empty d-ary heap
+ *
+ * @local struct dheap *d, reference to new heap
+ *
+ * @return struct dheap *, reference to the heap
+ */
+struct dheap *newDheap() {
+    struct dheap *d = (struct dheap *) malloc(sizeof(struct dheap));
+    if(d == NULL) {
+        perror("malloc failed. cannot construct d-ary heap.\n");
+        exit(1);
+    }
+    d->theSize = 0;
+    d->totalSize = 128;
+    d->array = malloc(sizeof(struct event)*d->totalSize);
+    if(d->array == NULL) {
+        perror("malloc failed. cannot construct d-ary heap array.\n");
+        exit(1);
+    }
+    return d;
+}
+/*
+ * A function to add an element to a d-ary heap
+ * The array is doubled when full
+ *
+ * @param struct dheap *d, the heap
+ * @param struct event ev, the element to add
+ *
+ * @local int slot, the slot to check where to insert
+ * @local int parent, the parent of slot
+ */
+void dheapInsert(struct dheap *d, struct event ev) {
+    int slot, parent;
+    if(d->theSize == d->totalSize) {
+        d->totalSize *= 2;
+        d->array = realloc(d->array, sizeof(struct event)*d->totalSize);
+        if(d->array == NULL) {
+            perror("realloc failed. cannot grow d-ary heap array.\n");
+            exit(1);
+        }
+    }
+    slot = d->theSize++;
+    while(slot > 0) {                   // move parents down until place for insertion is found
+        parent = (slot-1)/DHEAP_ARITY;
+        if(!(ev.time < d->array[parent].time))
+            break;
+        d->array[slot] = d->array[parent];
+        slot = parent;
+    }
+    d->array[slot] = ev;
+}
+/*
+ * A function to remove the smallest element from a d-ary heap
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @local struct event min, the element to return
+ * @local struct event tmp, the last element, to be placed
+ * @local int slot, the slot being filled
+ * @local int child, the first child of slot
+ * @local int best, the smallest child of slot
+ * @local int last, the last child of slot
+ * @local int i, a counter
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event dheapDeleteMin(struct dheap *d) {
+    struct event min, tmp;
+    int slot = 0, child, best, last, i;
+    if(d->theSize == 0) {
+        min.id = -1;
+        return min;
+    }
+    min = d->array[0];
+    tmp = d->array[--d->theSize];
+    while((child = DHEAP_ARITY*slot+1) < d->theSize) {     // smallest child moves up until place for tmp is found
+        last = child + DHEAP_ARITY;
+        if(last > d->theSize)
+            last = d->theSize;
+        best = child;
+        for(i=child+1;i<last;i++)
+            if(d->array[i].time < d->array[best].time)
+                best = i;
+        if(!(d->array[best].time < tmp.time))
+            break;
+        d->array[slot] = d->array[best];
+        slot = best;
+    }
+    d->array[slot] = tmp;
+    return min;
+}
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @return struct event, the element
+ */
+struct event dheapGetMin(struct dheap *d) {
+    return d->array[0];
+}
+/*
+ * A function to free a d-ary heap
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @return struct dheap *, reference to the freed heap (NULL)
+ */
+struct dheap *freeDheap(struct dheap *d) {
+    free(d->array);
+    free(d);
+    d = NULL;
+    return d;
+}
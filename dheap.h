@@ -0,0 +1,74 @@
+/***************************************************************
+  Paul Lewis
+  File Name: dheap.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for dheap.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "customer.h"
+
+#ifndef _dheap_h
+#define _dheap_h
+
+/*
+ * The number of children of each node in the d-ary heap
+ */
+#define DHEAP_ARITY 4
+
+/*
+ * The d-ary priority queue structure
+ * Elements are stored from slot 0, the children of slot i are
+ * slots DHEAP_ARITY*i+1 through DHEAP_ARITY*i+DHEAP_ARITY
+ *
+ * @field int theSize, the current size of the heap
+ * @field int totalSize, the size of the array
+ * @field struct event *array, an array of events, keys stored inline
+ */
+struct dheap {
+    int theSize;
+    int totalSize;
+    struct event *array;
+};
+
+/*
+ * A function to allocate and initialize an empty d-ary heap
+ *
+ * @return struct dheap *, reference to the heap
+ */
+struct dheap *newDheap();
+/*
+ * A function to add an element to a d-ary heap
+ *
+ * @param struct dheap *d, the heap
+ * @param struct event ev, the element to add
+ */
+void dheapInsert(struct dheap *d, struct event ev);
+/*
+ * A function to remove the smallest element from a d-ary heap
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event dheapDeleteMin(struct dheap *d);
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @return struct event, the element
+ */
+struct event dheapGetMin(struct dheap *d);
+/*
+ * A function to free a d-ary heap
+ *
+ * @param struct dheap *d, the heap
+ *
+ * @return struct dheap *, reference to the freed heap (NULL)
+ */
+struct dheap *freeDheap(struct dheap *d);
+
+#endif
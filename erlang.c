@@ -0,0 +1,206 @@
+/***************************************************************
+  Paul Lewis
+  File Name: erlang.c
+  Simulation
+
+  The a priori statistics of M/M/c in double precision.
+  With a = lambda/mu, the Erlang-B blocking probability follows
+      B(0) = 1,  B(m) = a B(m-1) / (m + a B(m-1))
+  which stays in (0, 1] for any m, and the Erlang-C probability
+  of waiting is C = m B / (m - a (1 - B)). Po needs the Poisson
+  sums S(m) = sum a^k/k!, k = 0..m, which pass 10^308 once a
+  is a few hundred, so they are carried as mantissas with a
+  power of two exponent (the log2 scale) that is stepped by 500
+  whenever they grow too large. Every step is a handful of
+  multiplies and a divide with no calls to log or exp, so all
+  M up to mMax cost O(mMax), and the loop over pairs vectorizes
+***************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+#include <float.h>
+#include "erlang.h"
+
+/*
+ * Poisson sums beyond ERLANG_LIMIT are scaled by ERLANG_SCALE
+ */
+#define ERLANG_LIMIT 0x1p500
+#define ERLANG_SCALE 0x1p-500
+
+/*
+ * A function to step every pair of a chunk from m-1 to m servers
+ *
+ * @param int n, the number of pairs in the chunk
+ * @param int m, the number of servers
+ * @param const double *a, the offered loads lambda/mu
+ * @param double *b, Erlang-B for m-1, becomes Erlang-B for m
+ * @param double *t, a^(m-1)/(m-1)! scaled, becomes a^m/m! scaled
+ * @param double *s, S(m-1) scaled, becomes S(m) scaled
+ * @param double *p, becomes S(m-1) scaled
+ *
+ * @local int j, a counter
+ */
+static inline void erlangAdvance(int n, int m, const double *restrict a, double *restrict b, double *restrict t,
+        double *restrict s, double *restrict p) {
+    int j;
+    for(j=0;j<n;j++) {
+        b[j] = a[j] * b[j] / (m + a[j] * b[j]);
+        b[j] = b[j] < DBL_MIN ? 0.0 : b[j];     // flush subnormals, which would stick at the smallest one
+        p[j] = s[j];
+        t[j] = t[j] * a[j] / m;
+        s[j] = p[j] + t[j];
+    }
+}
+/*
+ * A function to scale down the sums of any pair that have grown too large
+ *
+ * @param int n, the number of pairs in the chunk
+ * @param double *t, a^m/m! scaled
+ * @param double *s, S(m) scaled
+ * @param double *u, the scale, 2^-500 for every time the sums were scaled
+ *
+ * @local int j, a counter
+ * @local int big, the number of pairs to scale
+ */
+static inline void erlangRescale(int n, double *restrict t, double *restrict s, double *restrict u) {
+    int j, big = 0;
+    for(j=0;j<n;j++)            // rarely true, so test the chunk first
+        big += s[j] > ERLANG_LIMIT;
+    if(big == 0)
+        return;
+    for(j=0;j<n;j++) {
+        if(s[j] > ERLANG_LIMIT) {
+            t[j] *= ERLANG_SCALE;
+            s[j] *= ERLANG_SCALE;
+            u[j] *= ERLANG_SCALE;
+        }
+    }
+}
+/*
+ * A function to store the statistics of every pair of a chunk for m servers
+ *
+ * @param int n, the number of pairs in the chunk
+ * @param int m, the number of servers
+ * @param const double *lambda, the arrival rates
+ * @param const double *a, the offered loads lambda/mu
+ * @param const double *b, Erlang-B for m
+ * @param const double *t, a^m/m! scaled
+ * @param const double *p, S(m-1) scaled
+ * @param const double *u, the scale of t and p
+ * @param struct analytic *out, where the statistics of pair j go, out[j]
+ *
+ * @local int j, a counter
+ * @local double c, the probability of waiting
+ * @local double lq, the average number waiting in queue
+ */
+static inline void erlangStore(int n, int m, const double *lambda, const double *a, const double *b,
+        const double *t, const double *p, const double *u, struct analytic *out) {
+    int j;
+    double c, lq;
+    for(j=0;j<n;j++) {
+        if(a[j] >= m) {         // past saturation the queue grows without bound
+            out[j].po = 0.0;
+            out[j].lq = INFINITY;
+            out[j].l = INFINITY;
+            out[j].wq = INFINITY;
+            out[j].w = INFINITY;
+            out[j].rho = a[j] / m;
+            out[j].pWait = 1.0;
+            continue;
+        }
+        c = m * b[j] / (m - a[j] * (1.0 - b[j]));
+        lq = c * a[j] / (m - a[j]);
+        out[j].po = u[j] / (p[j] + t[j] * m / (m - a[j]));
+        out[j].lq = lq;
+        out[j].l = lq + a[j];
+        out[j].wq = lq / lambda[j];
+        out[j].w = (lq + a[j]) / lambda[j];
+        out[j].rho = a[j] / m;
+        out[j].pWait = c;
+    }
+}
+/*
+ * A function to calculate the a priori statistics of M/M/c for every
+ * (lambda, mu) pair and every number of servers from mMin to mMax,
+ * in one pass over M
+ *
+ * @param const double *lambda, the arrival rate of each pair
+ * @param const double *mu, the service rate of each pair
+ * @param int pairs, the number of pairs
+ * @param int mMin, the fewest servers
+ * @param int mMax, the most servers
+ * @param struct analytic *out, the statistics, out[(m - mMin) * pairs + j] for pair j
+ *
+ * @local int i, j, m, counters
+ * @local int n, the number of pairs in the chunk
+ * @local double a[], b[], t[], s[], p[], u[], the state of each pair of the chunk
+ */
+__attribute__((target_clones("avx2", "default")))
+void erlangBatch(const double *lambda, const double *mu, int pairs, int mMin, int mMax, struct analytic *out) {
+    int i, j, m, n;
+    double a[ERLANG_CHUNK], b[ERLANG_CHUNK], t[ERLANG_CHUNK], s[ERLANG_CHUNK], p[ERLANG_CHUNK], u[ERLANG_CHUNK];
+    for(i=0;i<pairs;i+=ERLANG_CHUNK) {
+        n = pairs - i < ERLANG_CHUNK ? pairs - i : ERLANG_CHUNK;
+        for(j=0;j<n;j++) {
+            a[j] = lambda[i+j] / mu[i+j];
+            b[j] = 1.0;
+            t[j] = 1.0;
+            s[j] = 1.0;
+            u[j] = 1.0;
+        }
+        for(m=1;m<=mMax;m++) {
+            erlangAdvance(n, m, a, b, t, s, p);
+            if(m >= mMin)
+                erlangStore(n, m, lambda + i, a, b, t, p, u, out + (m - mMin) * (long) pairs + i);
+            erlangRescale(n, t, s, u);
+        }
+    }
+}
+/*
+ * A function to calculate the a priori statistics of M/M/c
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ *
+ * @local struct analytic out, the statistics
+ *
+ * @return struct analytic, the statistics
+ */
+struct analytic erlangC(double lambda, double mu, int m) {
+    struct analytic out;
+    erlangBatch(&lambda, &mu, 1, m, m, &out);
+    return out;
+}
+/*
+ * A function to calculate the a priori probability Pn of n in the system
+ * for n from 0 up, the last entry holds every n beyond
+ * Pn = Pn-1 a / min(n, m), starting from P0
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param double po, P0 from erlangC()
+ * @param double *pn, where to store the probabilities, all 0 where rho >= 1
+ * @param int states, the number of entries in pn
+ *
+ * @local int n, the number in the system
+ * @local double a, the offered load lambda/mu
+ * @local double p, Pn
+ * @local double sum, the sum of the entries so far
+ */
+void erlangStates(double lambda, double mu, int m, double po, double *pn, int states) {
+    int n;
+    double a = lambda/mu, p = po, sum = 0.0;
+    if(a >= m) {
+        for(n=0;n<states;n++)
+            pn[n] = 0.0;
+        return;
+    }
+    for(n=0;n<states-1;n++) {
+        pn[n] = p;
+        sum += p;
+        p *= a/(n + 1 < m ? n + 1 : m);
+    }
+    pn[states-1] = sum < 1.0 ? 1.0 - sum : 0.0;
+}
@@ -0,0 +1,56 @@
+/***************************************************************
+  Paul Lewis
+  File Name: erlang.h
+  Simulation
+
+  Contains function prototypes, #defines, and #includes for erlang.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _erlang_h
+#define _erlang_h
+
+/*
+ * The number of (lambda, mu) pairs worked on together, the inner loop
+ * runs across them so it vectorizes
+ */
+#define ERLANG_CHUNK 64
+
+/*
+ * A function to calculate the a priori statistics of M/M/c for every
+ * (lambda, mu) pair and every number of servers from mMin to mMax,
+ * in one pass over M
+ *
+ * @param const double *lambda, the arrival rate of each pair
+ * @param const double *mu, the service rate of each pair
+ * @param int pairs, the number of pairs
+ * @param int mMin, the fewest servers
+ * @param int mMax, the most servers
+ * @param struct analytic *out, the statistics, out[(m - mMin) * pairs + j] for pair j
+ */
+void erlangBatch(const double *lambda, const double *mu, int pairs, int mMin, int mMax, struct analytic *out);
+/*
+ * A function to calculate the a priori statistics of M/M/c
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ *
+ * @return struct analytic, the statistics
+ */
+struct analytic erlangC(double lambda, double mu, int m);
+/*
+ * A function to calculate the a priori probability Pn of n in the system
+ * for n from 0 up, the last entry holds every n beyond
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param double po, P0 from erlangC()
+ * @param double *pn, where to store the probabilities, all 0 where rho >= 1
+ * @param int states, the number of entries in pn
+ */
+void erlangStates(double lambda, double mu, int m, double po, double *pn, int states);
+
+#endif
@@ -0,0 +1,189 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventlog.c
+  Simulation
+
+  Contains functions for writing every customer's arrival, start
+  of service and departure to a binary log. Customers are kept in
+  two blocks of columns, so memory does not grow with the run, and
+  one block is written while the other fills
+***************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include "eventlog.h"
+
+/*
+ * A function to write one block of a log
+ * Only the writer thread writes while there is one
+ *
+ * @param struct eventLog *log, the log
+ * @param int b, the block
+ *
+ * @local uint32_t count, the customers in the block
+ * @local int i, a counter
+ */
+static void writeBlock(struct eventLog *log, int b) {
+    uint32_t count = log->head[b].count;
+    int i;
+    if(log->failed)
+        return;
+    if(fwrite(&log->head[b], sizeof(struct logBlock), 1, log->fp) != 1)
+        log->failed = 1;
+    for(i=0;i<3 && !log->failed;i++)
+        if(fwrite(log->blocks[b] + i*LOG_BLOCK, sizeof(float), count, log->fp) != count)
+            log->failed = 1;
+    if(!log->failed)
+        log->logged += count;
+}
+/*
+ * A function run by the writer thread of a log, writing each block
+ * it is passed until the log is closed
+ *
+ * @param void *arg, the log
+ *
+ * @local struct eventLog *log, the log
+ * @local int b, the block to write
+ *
+ * @return void *, NULL
+ */
+static void *writeBlocks(void *arg) {
+    struct eventLog *log = (struct eventLog *) arg;
+    int b;
+    pthread_mutex_lock(&log->lock);
+    for(;;) {
+        while(log->pending < 0 && !log->done)
+            pthread_cond_wait(&log->cond, &log->lock);
+        if(log->pending < 0)
+            break;
+        b = log->pending;
+        pthread_mutex_unlock(&log->lock);
+        writeBlock(log, b);
+        pthread_mutex_lock(&log->lock);
+        log->pending = -1;
+        pthread_cond_broadcast(&log->cond);
+    }
+    pthread_mutex_unlock(&log->lock);
+    return NULL;
+}
+/*
+ * A function to point a log at a block to fill
+ *
+ * @param struct eventLog *log, the log
+ * @param int b, the block
+ */
+static void startBlock(struct eventLog *log, int b) {
+    log->filling = b;
+    log->gap = log->blocks[b];
+    log->wait = log->blocks[b] + LOG_BLOCK;
+    log->service = log->blocks[b] + 2*LOG_BLOCK;
+    log->head[b].base = log->last;
+    log->n = 0;
+}
+/*
+ * A function to create a log file
+ *
+ * @param const char *path, the file
+ * @param int threaded, boolean, whether to write blocks on a writer thread
+ *
+ * @local struct eventLog *log, the new log
+ * @local struct logHeader h, the file header
+ * @local int i, a counter
+ *
+ * @return struct eventLog *, reference to the log, NULL if the file cannot be created
+ */
+struct eventLog *openEventLog(const char *path, int threaded) {
+    struct eventLog *log;
+    struct logHeader h;
+    int i;
+    FILE *fp = fopen(path, "wb");
+    if(fp == NULL)
+        return NULL;
+    log = (struct eventLog *) malloc(sizeof(struct eventLog));
+    if(log == NULL) {
+        perror("malloc error. cannot create log.\n");
+        exit(1);
+    }
+    for(i=0;i<2;i++) {
+        log->blocks[i] = (float *) malloc(3 * LOG_BLOCK * sizeof(float));
+        if(log->blocks[i] == NULL) {
+            perror("malloc error. cannot create log.\n");
+            exit(1);
+        }
+        log->head[i].reserved = 0;
+    }
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, LOG_MAGIC, sizeof(h.magic));
+    h.block = LOG_BLOCK;
+    log->fp = fp;
+    log->failed = fwrite(&h, sizeof(h), 1, fp) != 1;
+    log->logged = 0;
+    log->last = 0.0;
+    log->threaded = threaded;
+    log->pending = -1;
+    log->done = 0;
+    startBlock(log, 0);
+    if(threaded) {
+        pthread_mutex_init(&log->lock, NULL);
+        pthread_cond_init(&log->cond, NULL);
+        if(pthread_create(&log->writer, NULL, writeBlocks, log) != 0) {
+            perror("pthread_create error. cannot start log writer.\n");
+            exit(1);
+        }
+    }
+    return log;
+}
+/*
+ * A function to pass a full block to be written and start the other
+ * With a writer thread this only waits if the other block is still
+ * being written
+ *
+ * @param struct eventLog *log, the log
+ *
+ * @local int b, the block passed on
+ */
+void flushEventLog(struct eventLog *log) {
+    int b = log->filling;
+    log->head[b].count = log->n;
+    if(log->threaded) {
+        pthread_mutex_lock(&log->lock);
+        while(log->pending >= 0)
+            pthread_cond_wait(&log->cond, &log->lock);
+        log->pending = b;
+        pthread_cond_broadcast(&log->cond);
+        pthread_mutex_unlock(&log->lock);
+    } else {
+        writeBlock(log, b);
+    }
+    startBlock(log, 1 - b);
+}
+/*
+ * A function to write the rest of a log and close it
+ *
+ * @param struct eventLog *log, the log
+ * @param long *logged, where to store the customers written, all of them
+ *  unless a write failed
+ *
+ * @return struct eventLog *, reference to the freed log (NULL)
+ */
+struct eventLog *closeEventLog(struct eventLog *log, long *logged) {
+    if(log->n > 0)
+        flushEventLog(log);
+    if(log->threaded) {
+        pthread_mutex_lock(&log->lock);
+        log->done = 1;
+        pthread_cond_broadcast(&log->cond);
+        pthread_mutex_unlock(&log->lock);
+        pthread_join(log->writer, NULL);
+        pthread_mutex_destroy(&log->lock);
+        pthread_cond_destroy(&log->cond);
+    }
+    if(fclose(log->fp) != 0)
+        log->logged = 0;
+    *logged = log->logged;
+    free(log->blocks[0]);
+    free(log->blocks[1]);
+    free(log);
+    log = NULL;
+    return log;
+}
@@ -0,0 +1,136 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventlog.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for eventlog.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdint.h>
+#include <pthread.h>
+
+#ifndef _eventlog_h
+#define _eventlog_h
+
+#define LOG_MAGIC "SIMLOG01"    // the first 8 bytes of every log file
+#define LOG_BLOCK 8192          // customers in a full block
+
+/*
+ * The header of a log file
+ * It is followed by blocks of at most LOG_BLOCK customers in the order
+ * they arrived, each a struct logBlock and then three columns of
+ * floats: the time since the previous arrival, the time waited in
+ * queue and the service time
+ *
+ * @field char magic[], LOG_MAGIC, not terminated
+ * @field uint32_t block, LOG_BLOCK
+ * @field uint32_t reserved, 0
+ */
+struct logHeader {
+    char magic[8];
+    uint32_t block;
+    uint32_t reserved;
+};
+
+/*
+ * The header of a block of a log
+ * Arrival k of the block is base plus the first k+1 interarrival
+ * times, each added in double precision, so no rounding error builds
+ * up; start of service adds the wait and departure the service time
+ *
+ * @field uint32_t count, the customers in the block
+ * @field uint32_t reserved, 0
+ * @field double base, the arrival time before the block's first
+ */
+struct logBlock {
+    uint32_t count;
+    uint32_t reserved;
+    double base;
+};
+
+/*
+ * A log being written, two blocks that are filled in turn, one
+ * while the other is written, on a writer thread if there is one
+ *
+ * @field FILE *fp, the log file
+ * @field float *blocks[], the columns of both blocks, LOG_BLOCK of each
+ * @field struct logBlock head[], the header of each block
+ * @field int filling, the block being filled
+ * @field float *gap, float *wait, float *service, the columns being filled
+ * @field uint32_t n, the customers in the block being filled
+ * @field double last, the arrival time of the last customer, as the log gives it
+ * @field long logged, the customers written
+ * @field int failed, boolean, whether a write has failed
+ * @field int threaded, boolean, whether blocks are written on a writer thread
+ * @field int pending, the block waiting for or being written by the writer, -1 if none
+ * @field int done, boolean, whether the writer should finish
+ * @field pthread_t writer, the writer thread
+ * @field pthread_mutex_t lock, guards pending and done
+ * @field pthread_cond_t cond, signalled when either changes
+ */
+struct eventLog {
+    FILE *fp;
+    float *blocks[2];
+    struct logBlock head[2];
+    int filling;
+    float *gap;
+    float *wait;
+    float *service;
+    uint32_t n;
+    double last;
+    long logged;
+    int failed;
+    int threaded;
+    int pending;
+    int done;
+    pthread_t writer;
+    pthread_mutex_t lock;
+    pthread_cond_t cond;
+};
+
+/*
+ * A function to create a log file
+ *
+ * @param const char *path, the file
+ * @param int threaded, boolean, whether to write blocks on a writer thread
+ *
+ * @return struct eventLog *, reference to the log, NULL if the file cannot be created
+ */
+struct eventLog *openEventLog(const char *path, int threaded);
+/*
+ * A function to pass a full block to be written and start the other
+ *
+ * @param struct eventLog *log, the log
+ */
+void flushEventLog(struct eventLog *log);
+/*
+ * A function to add a customer to a log as service starts
+ *
+ * @param struct eventLog *log, the log
+ * @param double arrival, the arrival time
+ * @param double start, the start of service
+ * @param double departure, the departure time
+ *
+ * @local float gap, the time since the previous arrival
+ */
+static inline void logCustomer(struct eventLog *log, double arrival, double start, double departure) {
+    float gap = (float) (arrival - log->last);
+    log->last += gap;
+    log->gap[log->n] = gap;
+    log->wait[log->n] = (float) (start - arrival);
+    log->service[log->n] = (float) (departure - start);
+    if(++log->n == LOG_BLOCK)
+        flushEventLog(log);
+}
+/*
+ * A function to write the rest of a log and close it
+ *
+ * @param struct eventLog *log, the log
+ * @param long *logged, where to store the customers written
+ *
+ * @return struct eventLog *, reference to the freed log (NULL)
+ */
+struct eventLog *closeEventLog(struct eventLog *log, long *logged);
+
+#endif
@@ -0,0 +1,87 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventnode.c
+  Simulation
+
+  Contains functions for allocating and freeing the list nodes
+  used by the linked event set engines
+***************************************************************/
+
+#include "eventnode.h"
+
+/*
+ * A function to initialize an empty node pool
+ *
+ * @param struct nodePool *np, the pool
+ */
+void initNodePool(struct nodePool *np) {
+    np->slabs = NULL;
+    np->numSlabs = 0;
+    np->maxSlabs = 0;
+    np->slabUsed = NODE_SLAB;       // forces a slab to be allocated on first use
+    np->freeList = NULL;
+}
+/*
+ * A function to take a node from the pool
+ *
+ * @param struct nodePool *np, the pool
+ * @param struct event ev, the event to store in the node
+ *
+ * @local struct eventNode *e, the node to return
+ *
+ * @return struct eventNode *, reference to the node
+ */
+struct eventNode *newNode(struct nodePool *np, struct event ev) {
+    struct eventNode *e;
+    if(np->freeList != NULL) {          // reuse most recently freed node
+        e = np->freeList;
+        np->freeList = e->next;
+    } else {
+        if(np->slabUsed == NODE_SLAB) { // newest slab is used up, allocate another
+            if(np->numSlabs == np->maxSlabs) {
+                np->maxSlabs = np->maxSlabs ? np->maxSlabs * 2 : 16;
+                np->slabs = realloc(np->slabs, sizeof(struct eventNode *) * np->maxSlabs);
+                if(np->slabs == NULL) {
+                    perror("realloc error. cannot grow node pool.\n");
+                    exit(1);
+                }
+            }
+            np->slabs[np->numSlabs] = malloc(sizeof(struct eventNode) * NODE_SLAB);
+            if(np->slabs[np->numSlabs] == NULL) {
+                perror("malloc error. cannot create node slab.\n");
+                exit(1);
+            }
+            np->numSlabs++;
+            np->slabUsed = 0;
+        }
+        e = &np->slabs[np->numSlabs-1][np->slabUsed++];
+    }
+    e->ev = ev;
+    e->next = NULL;
+    e->child = NULL;
+    return e;
+}
+/*
+ * A function to return a node to the pool
+ *
+ * @param struct nodePool *np, the pool
+ * @param struct eventNode *e, the node
+ */
+void freeNode(struct nodePool *np, struct eventNode *e) {
+    e->next = np->freeList;     // push onto free list
+    np->freeList = e;
+}
+/*
+ * A function to free every node allocated from a pool
+ *
+ * @param struct nodePool *np, the pool
+ *
+ * @local int i, a counter
+ */
+void clearNodePool(struct nodePool *np) {
+    int i;
+    for(i=0;i<np->numSlabs;i++)
+        free(np->slabs[i]);
+    free(np->slabs);
+    initNodePool(np);
+}
@@ -0,0 +1,80 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventnode.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for eventnode.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "customer.h"
+
+#ifndef _eventnode_h
+#define _eventnode_h
+
+/*
+ * The number of nodes allocated at once by a node pool
+ */
+#define NODE_SLAB 1024
+
+/*
+ * A list node used by the linked event set engines
+ *
+ * @field struct event ev, the event
+ * @field struct eventNode *next, the next node in a list or the next sibling
+ * @field struct eventNode *child, the first child (pairing heap only)
+ */
+struct eventNode {
+    struct event ev;
+    struct eventNode *next;
+    struct eventNode *child;
+};
+
+/*
+ * The node pool structure, nodes are recycled LIFO through freeList
+ *
+ * @field struct eventNode **slabs, the slabs allocated so far
+ * @field int numSlabs, the number of slabs in use
+ * @field int maxSlabs, the size of the slabs array
+ * @field int slabUsed, the number of nodes handed out of the newest slab
+ * @field struct eventNode *freeList, the most recently freed node
+ */
+struct nodePool {
+    struct eventNode **slabs;
+    int numSlabs;
+    int maxSlabs;
+    int slabUsed;
+    struct eventNode *freeList;
+};
+
+/*
+ * A function to initialize an empty node pool
+ *
+ * @param struct nodePool *np, the pool
+ */
+void initNodePool(struct nodePool *np);
+/*
+ * A function to take a node from the pool
+ *
+ * @param struct nodePool *np, the pool
+ * @param struct event ev, the event to store in the node
+ *
+ * @return struct eventNode *, reference to the node
+ */
+struct eventNode *newNode(struct nodePool *np, struct event ev);
+/*
+ * A function to return a node to the pool
+ *
+ * @param struct nodePool *np, the pool
+ * @param struct eventNode *e, the node
+ */
+void freeNode(struct nodePool *np, struct eventNode *e);
+/*
+ * A function to free every node allocated from a pool
+ *
+ * @param struct nodePool *np, the pool
+ */
+void clearNodePool(struct nodePool *np);
+
+#endif
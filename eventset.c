@@ -0,0 +1,168 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventset.c
+  Simulation
+
+  Contains functions for using a future event set through
+  whichever priority queue engine was chosen at runtime
+***************************************************************/
+
+#include "eventset.h"
+
+/*
+ * The engine names, indexed by type
+ */
+static const char *const engineNames[EVENTSET_ENGINES] = {
+    "binary", "dary", "pairing", "calendar", "ladder"
+};
+
+/*
+ * A function to allocate and initialize an empty event set
+ *
+ * @param int type, the engine, one of the EVENTSET_ values
+ *
+ * @local struct eventSet *es, reference to new event set
+ *
+ * @return struct eventSet *, reference to the event set
+ */
+struct eventSet *newEventSet(int type) {
+    struct eventSet *es = (struct eventSet *) malloc(sizeof(struct eventSet));
+    if(es == NULL) {
+        perror("malloc failed. cannot construct event set.\n");
+        exit(1);
+    }
+    es->type = type;
+    es->theSize = 0;
+    switch(type) {
+        case EVENTSET_DARY:     es->engine.dary = newDheap(); break;
+        case EVENTSET_PAIRING:  es->engine.pairing = newPairingHeap(); break;
+        case EVENTSET_CALENDAR: es->engine.calendar = newCalendar(); break;
+        case EVENTSET_LADDER:   es->engine.ladder = newLadder(); break;
+        default:
+            es->type = EVENTSET_BINARY;
+            es->engine.binary = constructHeap(0, NULL);
+    }
+    return es;
+}
+/*
+ * A function to add an event to an event set
+ *
+ * @param struct eventSet *es, the event set
+ * @param struct event ev, the event
+ */
+void schedule(struct eventSet *es, struct event ev) {
+    es->theSize++;
+    switch(es->type) {
+        case EVENTSET_DARY:     dheapInsert(es->engine.dary, ev); break;
+        case EVENTSET_PAIRING:  pairingInsert(es->engine.pairing, ev); break;
+        case EVENTSET_CALENDAR: calendarInsert(es->engine.calendar, ev); break;
+        case EVENTSET_LADDER:   ladderInsert(es->engine.ladder, ev); break;
+        default:                percolateUp(es->engine.binary, ev);
+    }
+}
+/*
+ * A function to remove the earliest event from an event set
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @local struct event none, returned if the set is empty
+ *
+ * @return struct event, the removed event, id -1 if empty
+ */
+struct event nextEvent(struct eventSet *es) {
+    struct event none;
+    if(es->theSize == 0) {
+        none.time = 0.0;
+        none.id = -1;
+        return none;
+    }
+    es->theSize--;
+    switch(es->type) {
+        case EVENTSET_DARY:     return dheapDeleteMin(es->engine.dary);
+        case EVENTSET_PAIRING:  return pairingDeleteMin(es->engine.pairing);
+        case EVENTSET_CALENDAR: return calendarDeleteMin(es->engine.calendar);
+        case EVENTSET_LADDER:   return ladderDeleteMin(es->engine.ladder);
+        default:                return deleteMin(es->engine.binary);
+    }
+}
+/*
+ * A function to return the earliest event without removing it
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @local struct event none, returned if the set is empty
+ *
+ * @return struct event, the event, id -1 if empty
+ */
+struct event peekEvent(struct eventSet *es) {
+    struct event none;
+    if(es->theSize == 0) {
+        none.time = 0.0;
+        none.id = -1;
+        return none;
+    }
+    switch(es->type) {
+        case EVENTSET_DARY:     return dheapGetMin(es->engine.dary);
+        case EVENTSET_PAIRING:  return pairingGetMin(es->engine.pairing);
+        case EVENTSET_CALENDAR: return calendarGetMin(es->engine.calendar);
+        case EVENTSET_LADDER:   return ladderGetMin(es->engine.ladder);
+        default:                return getMin(es->engine.binary);
+    }
+}
+/*
+ * A function to check if an event set is empty
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return int, boolean
+ */
+int isEmptyEventSet(struct eventSet *es) {
+    return es->theSize == 0;
+}
+/*
+ * A function to free an event set
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return struct eventSet *, reference to the freed event set (NULL)
+ */
+struct eventSet *freeEventSet(struct eventSet *es) {
+    switch(es->type) {
+        case EVENTSET_DARY:     freeDheap(es->engine.dary); break;
+        case EVENTSET_PAIRING:  freePairingHeap(es->engine.pairing); break;
+        case EVENTSET_CALENDAR: freeCalendar(es->engine.calendar); break;
+        case EVENTSET_LADDER:   freeLadder(es->engine.ladder); break;
+        default:                freeHeap(es->engine.binary);
+    }
+    free(es);
+    es = NULL;
+    return es;
+}
+/*
+ * A function to look up an engine by name
+ *
+ * @param const char *name, one of binary, dary, pairing, calendar, ladder
+ *
+ * @local int i, a counter
+ *
+ * @return int, the engine, -1 if the name is unknown
+ */
+int eventSetType(const char *name) {
+    int i;
+    for(i=0;i<EVENTSET_ENGINES;i++)
+        if(strcmp(name, engineNames[i]) == 0)
+            return i;
+    return -1;
+}
+/*
+ * A function to return the name of an engine
+ *
+ * @param int type, the engine
+ *
+ * @return const char *, the name
+ */
+const char *eventSetName(int type) {
+    if(type < 0 || type >= EVENTSET_ENGINES)
+        return "unknown";
+    return engineNames[type];
+}
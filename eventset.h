@@ -0,0 +1,116 @@
+/***************************************************************
+  Paul Lewis
+  File Name: eventset.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for eventset.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "customer.h"
+#include "heap.h"
+#include "dheap.h"
+#include "pairing.h"
+#include "calendar.h"
+#include "ladder.h"
+
+#ifndef _eventset_h
+#define _eventset_h
+
+/*
+ * The future event set engines
+ */
+#define EVENTSET_BINARY 0
+#define EVENTSET_DARY 1
+#define EVENTSET_PAIRING 2
+#define EVENTSET_CALENDAR 3
+#define EVENTSET_LADDER 4
+#define EVENTSET_ENGINES 5
+
+/*
+ * The future event set structure, a priority queue of events by time
+ * backed by one of the engines
+ *
+ * @field int type, the engine, one of the EVENTSET_ values
+ * @field int theSize, the number of events
+ * @field union engine, the engine's own structure
+ */
+struct eventSet {
+    int type;
+    int theSize;
+    union {
+        struct heap *binary;
+        struct dheap *dary;
+        struct pairingHeap *pairing;
+        struct calendar *calendar;
+        struct ladder *ladder;
+    } engine;
+};
+
+/*
+ * A function to allocate and initialize an empty event set
+ *
+ * @param int type, the engine, one of the EVENTSET_ values
+ *
+ * @return struct eventSet *, reference to the event set
+ */
+struct eventSet *newEventSet(int type);
+/*
+ * A function to add an event to an event set
+ *
+ * @param struct eventSet *es, the event set
+ * @param struct event ev, the event
+ */
+void schedule(struct eventSet *es, struct event ev);
+/*
+ * A function to remove the earliest event from an event set
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return struct event, the removed event, id -1 if empty
+ */
+struct event nextEvent(struct eventSet *es);
+/*
+ * A function to return the earliest event without removing it
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return struct event, the event, id -1 if empty
+ */
+struct event peekEvent(struct eventSet *es);
+/*
+ * A function to check if an event set is empty
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return int, boolean
+ */
+int isEmptyEventSet(struct eventSet *es);
+/*
+ * A function to free an event set
+ *
+ * @param struct eventSet *es, the event set
+ *
+ * @return struct eventSet *, reference to the freed event set (NULL)
+ */
+struct eventSet *freeEventSet(struct eventSet *es);
+/*
+ * A function to look up an engine by name
+ *
+ * @param const char *name, one of binary, dary, pairing, calendar, ladder
+ *
+ * @return int, the engine, -1 if the name is unknown
+ */
+int eventSetType(const char *name);
+/*
+ * A function to return the name of an engine
+ *
+ * @param int type, the engine
+ *
+ * @return const char *, the name
+ */
+const char *eventSetName(int type);
+
+#endif
@@ -8,22 +8,40 @@
 
 #include "heap.h"
 
+/*
+ * Function to double the size of the heap array
+ *
+ * @param struct heap *h, the priority queue
+ * @param int minSize, the smallest array size needed
+ */
+static void growHeap(struct heap *h, int minSize) {
+    while(h->totalSize < minSize)
+        h->totalSize *= 2;
+    h->array = realloc(h->array, sizeof(struct event)*h->totalSize);
+    if(h->array == NULL) {
+        perror("realloc failed. cannot grow heap array.\n");
+        exit(1);
+    }
+}
 /*
  * Function to add an element to a priority queue
+ * The array is doubled when full
  *
  * @param struct heap *h, the priority queue
- * @param struct customer *cust, the element to add
+ * @param struct event ev, the element to add
  *
  * @local int slot, the slot to check where to insert
  */
-void percolateUp(struct heap *h, struct customer *cust) {
-    h->array[0] = cust;     // sentinel
+void percolateUp(struct heap *h, struct event ev) {
+    if(h->theSize+1 >= h->totalSize)
+        growHeap(h, h->theSize+2);
+    h->array[0] = ev;       // sentinel
     int slot = ++h->theSize;    // increment size
-    while(cust->pqTime < h->array[slot/2]->pqTime) {    // search for slot to place customer
+    while(ev.time < h->array[slot/2].time) {    // search for slot to place event
         h->array[slot] = h->array[slot/2];
         slot /= 2;
     }   
-    h->array[slot] = cust; // place customer
+    h->array[slot] = ev;    // place event
 }
 /*
  * Function to swap an element with its children by priority order
@@ -32,18 +50,18 @@ void percolateUp(struct heap *h, struct customer *cust) {
  * @param int slot, the slot to percolate
  *
  * @local int child, the child of the current slot
- * @local customer *tmp, the element to swap in the heap
+ * @local struct event tmp, the element to swap in the heap
  */
 void percolateDown(struct heap *h, int slot) {
     int child;
-    struct customer *tmp = h->array[slot];  // element at slot to percolate down
+    struct event tmp = h->array[slot];      // element at slot to percolate down
 
     while(slot * 2 <= h->theSize) {         // loop to rearrange parent with its children in heap order
         child = slot * 2;                   // smaller items further down the heap are copied up until place for insertion is found
-        if(child != h->theSize && h->array[child+1]->pqTime < h->array[child]->pqTime) {
+        if(child != h->theSize && h->array[child+1].time < h->array[child].time) {
             child++;
         }
-        if(h->array[child]->pqTime < tmp->pqTime) {
+        if(h->array[child].time < tmp.time) {
             h->array[slot] = h->array[child];
         } else {
             break;
@@ -70,21 +88,24 @@ void buildHeap(struct heap *h) {
  * Params should be 0 and NULL if initializing an empty heap
  *
  * @param int initialSize, the size of the array passed to the function
- * @param struct customer *a[], an array of elements to place into new heap
+ * @param struct event a[], an array of elements to place into new heap
  *
  * @local int i, a counter
  * @local struct heap *h, reference to new heap
  *
  * @return struct heap *, reference to the heap
  */
-struct heap *constructHeap(int initialSize, struct customer **a) {
+struct heap *constructHeap(int initialSize, struct event *a) {
     int i;
     struct heap *h = (struct heap *) malloc (sizeof(struct heap));
     if(h == NULL) {
         perror("malloc failed. cannot construct heap.\n");
         exit(1);
     }
-    h->array = malloc(sizeof(struct customer *)*(HEAPSIZE+1));
+    h->totalSize = HEAPSIZE;
+    while(h->totalSize < initialSize+1)
+        h->totalSize *= 2;
+    h->array = malloc(sizeof(struct event)*h->totalSize);
     if(h->array == NULL) {
         perror("malloc failed. cannot construct heap array.\n");
         exit(1);
@@ -95,14 +116,10 @@ struct heap *constructHeap(int initialSize, struct customer **a) {
     if(a != NULL) {         
         for(i=0;i<initialSize;i++)
             h->array[i+1] = a[i];
-        buildHeap(h);
-        h->totalSize = HEAPSIZE+1;
         h->theSize = initialSize;
-        h->empty = 0;
+        buildHeap(h);
     } else {
-        h->totalSize = HEAPSIZE+1;
-        h->theSize = initialSize;
-        h->empty = 1;
+        h->theSize = 0;
     }
     
     return h;
@@ -112,19 +129,17 @@ struct heap *constructHeap(int initialSize, struct customer **a) {
  *
  * @param struct heap *h, the heap
  *
- * @local struct customer *tmp, the element to remove
+ * @local struct event tmp, the element to remove
  *
- * @return struct customer *, reference to removed element
+ * @return struct event, the removed element, id -1 if empty
  */
-struct customer *deleteMin(struct heap *h) {
-    struct customer *tmp = h->array[1];     // copy the item at top of heap to tmp
+struct event deleteMin(struct heap *h) {
+    struct event tmp = h->array[1];         // copy the item at top of heap to tmp
     if(h->theSize == 0) {
-        printf("Nothing in priority queue.\n");
-        return NULL;
+        tmp.id = -1;
+        return tmp;
     } else {
         h->array[1] = h->array[h->theSize--];   // copy item at end of heap to top of heap and decrement size
-        if(h->theSize == 0)
-            h->empty = 1;
         percolateDown(h,1); 
     }
     return tmp;
@@ -137,7 +152,7 @@ struct customer *deleteMin(struct heap *h) {
  * @return int, boolean
  */
 int isEmptyHeap(struct heap *h) {
-    return h->empty;
+    return h->theSize == 0;
 }
 /*
  * A function to return a reference to the first element in priority queue
@@ -145,9 +160,9 @@ int isEmptyHeap(struct heap *h) {
  *
  * @param struct heap *h, the priority queue
  *
- * @return struct customer *, a reference to the element
+ * @return struct event, the element
  */
-struct customer *getMin(struct heap *h) {
+struct event getMin(struct heap *h) {
     return h->array[1];
 }
 /*
@@ -155,20 +170,9 @@ struct customer *getMin(struct heap *h) {
  * 
  * @param struct heap *h, the heap
  *
- * @local int i, a counter
- *
  * @return struct heap *, the reference to the freed heap (NULL)
  */
 struct heap *freeHeap(struct heap *h) {
-    int i;
-    if(h->theSize != 0) {   // if array has elements, free those elements
-        if(h->theSize > 1) {
-            for(i=1;i<h->theSize;i++) 
-                free(h->array[i]);
-        } else {
-            free(h->array[1]);
-        }
-    }
     free(h->array);         // free the array
     free(h);                // free the heap structure
     h=NULL;
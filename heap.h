@@ -15,31 +15,30 @@
 #define _heap_h
 
 /*
- * The size of the priority queue
+ * The initial size of the priority queue, it doubles whenever it fills
  */
-#define HEAPSIZE 100
+#define HEAPSIZE 128
 
 /*
  * The priority queue structure
  * 
  * @field int theSize, the current size of the heap
  * @field int totalSize, the size of the array
- * @field int empty, boolean to show if heap is empty
- * @field struct customer **array, an array of customers
+ * @field struct event *array, an array of events, keys stored inline
  */
 struct heap {
     int theSize;
     int totalSize;
-    int empty;
-    struct customer **array;
+    struct event *array;
 };
 /*
  * Function to add an element to a priority queue
+ * The array is doubled when full
  *
  * @param struct heap *h, the priority queue
- * @param struct customer *cust, the element to add
+ * @param struct event ev, the element to add
  */
-void percolateUp(struct heap *h, struct customer *cust);
+void percolateUp(struct heap *h, struct event ev);
 /*
  * Function swap an element with its children by priority order
  *
@@ -58,28 +57,28 @@ void buildHeap(struct heap *h);
  * Params should be 0 and NULL if initializing an empty heap
  *
  * @param int initialSize, the size of the array passed to the function
- * @param struct customer *a[], an array of elements to place into new heap
+ * @param struct event a[], an array of elements to place into new heap
  *
  * @return struct heap *, reference to the heap
  */
-struct heap *constructHeap(int initialSize, struct customer **a);
+struct heap *constructHeap(int initialSize, struct event *a);
 /*
  * A function to remove element from heap
  *
  * @param struct heap *h, the heap
  *
- * @return struct customer *, reference to removed element
+ * @return struct event, the removed element, id -1 if empty
  */
-struct customer *deleteMin(struct heap *h);
+struct event deleteMin(struct heap *h);
 /*
  * A function to return a reference to the first element in priority queue
  * without removing it
  *
  * @param struct heap *h, the priority queue
  *
- * @return struct customer *, a reference to the element
+ * @return struct event, the element
  */
-struct customer *getMin(struct heap *h);
+struct event getMin(struct heap *h);
 /*
  * A function to check if heap is 
  *
@@ -0,0 +1,112 @@
+/***************************************************************
+  Paul Lewis
+  File Name: histogram.c
+  Simulation
+
+  Contains functions for log-bucketed histograms, in the manner
+  of HDR histograms, used for quantiles of the time customers
+  spend in the system and waiting in queue
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "histogram.h"
+
+/*
+ * A function to allocate an empty histogram
+ *
+ * @local struct histogram *h, the new histogram
+ *
+ * @return struct histogram *, reference to the new histogram
+ */
+struct histogram *newHistogram() {
+    struct histogram *h = (struct histogram *) calloc(1, sizeof(struct histogram));
+    if(h == NULL) {
+        perror("malloc error. cannot create histogram.\n");
+        exit(1);
+    }
+    return h;
+}
+/*
+ * A function to empty a histogram
+ *
+ * @param struct histogram *h, the histogram
+ */
+void clearHistogram(struct histogram *h) {
+    memset(h, 0, sizeof(struct histogram));
+}
+/*
+ * A function to add every value of one histogram to another
+ *
+ * @param struct histogram *to, the histogram added to
+ * @param const struct histogram *from, the histogram added
+ *
+ * @local int i, a counter
+ */
+void mergeHistogram(struct histogram *to, const struct histogram *from) {
+    int i;
+    for(i=0;i<HIST_BUCKETS;i++)
+        to->counts[i] += from->counts[i];
+    to->total += from->total;
+}
+/*
+ * A function to return the midpoint of a bucket
+ *
+ * @param int i, the bucket
+ *
+ * @local int e, the exponent of the bucket
+ * @local int sub, the bucket within the power of two
+ *
+ * @return double, the midpoint
+ */
+static double bucketValue(int i) {
+    int e, sub;
+    if(i == 0)
+        return 0.0;
+    if(i == HIST_BUCKETS - 1)
+        return ldexp(1.0, HIST_MAX_EXP);
+    e = ((i - 1) >> HIST_SUB_BITS) + HIST_MIN_EXP;
+    sub = (i - 1) & ((1 << HIST_SUB_BITS) - 1);
+    return ldexp(1.0 + (sub + 0.5) / (1 << HIST_SUB_BITS), e);
+}
+/*
+ * A function to return a quantile of the values in a histogram, the
+ * midpoint of the bucket holding it
+ *
+ * @param const struct histogram *h, the histogram
+ * @param double q, the quantile, between 0 and 1
+ *
+ * @local long rank, the position of the quantile among the values, from 1
+ * @local long seen, the values in the buckets so far
+ * @local int i, a counter
+ *
+ * @return double, the value, 0 for an empty histogram
+ */
+double histogramQuantile(const struct histogram *h, double q) {
+    long rank, seen = 0;
+    int i;
+    if(h->total == 0)
+        return 0.0;
+    rank = (long) ceil(q * h->total);
+    if(rank < 1)
+        rank = 1;
+    for(i=0;i<HIST_BUCKETS;i++) {
+        seen += h->counts[i];
+        if(seen >= rank)
+            return bucketValue(i);
+    }
+    return bucketValue(HIST_BUCKETS - 1);
+}
+/*
+ * A function to free a histogram
+ *
+ * @param struct histogram *h, the histogram
+ *
+ * @return struct histogram *, reference to the freed histogram (NULL)
+ */
+struct histogram *freeHistogram(struct histogram *h) {
+    free(h);
+    h = NULL;
+    return h;
+}
@@ -0,0 +1,104 @@
+/***************************************************************
+  Paul Lewis
+  File Name: histogram.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for histogram.c
+***************************************************************/
+
+#include <stdint.h>
+#include <string.h>
+
+#ifndef _histogram_h
+#define _histogram_h
+
+/*
+ * Each power of two is split into 2^HIST_SUB_BITS buckets, so a
+ * bucket's midpoint is within 0.4% of any value in it
+ */
+#define HIST_SUB_BITS 7
+/*
+ * Values from 2^HIST_MIN_EXP up to 2^HIST_MAX_EXP get their own
+ * bucket, smaller ones (and 0) share the first, larger the last
+ */
+#define HIST_MIN_EXP -24
+#define HIST_MAX_EXP 32
+#define HIST_BUCKETS (((HIST_MAX_EXP - HIST_MIN_EXP) << HIST_SUB_BITS) + 2)
+
+/*
+ * A log-bucketed histogram of positive values, fixed in size
+ * Histograms of the same values add bucket by bucket, so merging
+ * loses nothing
+ *
+ * @field long total, the number of values recorded
+ * @field long counts[], the number of values in each bucket
+ */
+struct histogram {
+    long total;
+    long counts[HIST_BUCKETS];
+};
+
+/*
+ * A function to allocate an empty histogram
+ *
+ * @return struct histogram *, reference to the new histogram
+ */
+struct histogram *newHistogram();
+/*
+ * A function to empty a histogram
+ *
+ * @param struct histogram *h, the histogram
+ */
+void clearHistogram(struct histogram *h);
+/*
+ * A function to add every value of one histogram to another
+ *
+ * @param struct histogram *to, the histogram added to
+ * @param const struct histogram *from, the histogram added
+ */
+void mergeHistogram(struct histogram *to, const struct histogram *from);
+/*
+ * A function to return a quantile of the values in a histogram, the
+ * midpoint of the bucket holding it
+ *
+ * @param const struct histogram *h, the histogram
+ * @param double q, the quantile, between 0 and 1
+ *
+ * @return double, the value, 0 for an empty histogram
+ */
+double histogramQuantile(const struct histogram *h, double q);
+/*
+ * A function to free a histogram
+ *
+ * @param struct histogram *h, the histogram
+ *
+ * @return struct histogram *, reference to the freed histogram (NULL)
+ */
+struct histogram *freeHistogram(struct histogram *h);
+/*
+ * A function to add a value to a histogram
+ * The bucket comes straight from the exponent and the top mantissa bits
+ *
+ * @param struct histogram *h, the histogram
+ * @param double x, the value
+ *
+ * @local uint64_t bits, the bits of x
+ * @local int e, the exponent of x
+ * @local int i, the bucket
+ */
+static inline void recordValue(struct histogram *h, double x) {
+    uint64_t bits;
+    int e, i;
+    memcpy(&bits, &x, sizeof(bits));
+    e = (int) ((bits >> 52) & 0x7ff) - 1023;
+    if(x <= 0 || e < HIST_MIN_EXP)
+        i = 0;
+    else if(e >= HIST_MAX_EXP)
+        i = HIST_BUCKETS - 1;
+    else
+        i = 1 + ((e - HIST_MIN_EXP) << HIST_SUB_BITS) + (int) ((bits >> (52 - HIST_SUB_BITS)) & ((1 << HIST_SUB_BITS) - 1));
+    h->counts[i]++;
+    h->total++;
+}
+
+#endif
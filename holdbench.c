@@ -0,0 +1,134 @@
+/***************************************************************
+  Paul Lewis
+  File Name: holdbench.c
+  Simulation
+
+  A program for timing the future event set engines with the
+  classic hold model: remove the earliest event, then schedule
+  a new one a random interval later
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <time.h>
+#include "eventset.h"
+#include "rng.h"
+
+/*
+ * The server counts to benchmark
+ */
+static const int servers[] = { 1, 16, 256, 4096, 65536 };
+/*
+ * The loads (lambda/(M*mu)) to benchmark
+ */
+static const double loads[] = { 0.5, 0.9, 0.99 };
+
+/*
+ * The random number generator for intervals
+ */
+static struct rng stream;
+
+/*
+ * A function for generating an exponential interval with mean 1
+ *
+ * @return double, the interval
+ */
+static double nextInterval() {
+    return -log(uniformOpen(&stream));
+}
+/*
+ * A function to return the current time in seconds
+ *
+ * @local struct timespec ts, the time
+ *
+ * @return double, the time
+ */
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+/*
+ * A function to run the hold model on one engine
+ * The pending population of an M server system at load rho is about
+ * rho*M departures plus one arrival
+ *
+ * @param int engine, the event set engine
+ * @param int population, the number of pending events
+ * @param long holds, the number of hold operations to time
+ *
+ * @local struct eventSet *es, the event set
+ * @local struct event ev, the event being held
+ * @local double last, the time of the previous event, to check order
+ * @local long i, a counter
+ * @local int ordered, boolean, set if the events came out in order
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per hold, negative if out of order
+ */
+static double hold(int engine, int population, long holds) {
+    struct eventSet *es = newEventSet(engine);
+    struct event ev;
+    double last = 0.0;
+    long i;
+    int ordered = 1;
+    double start;
+
+    seedRng(&stream, 1);
+    for(i=0;i<population;i++) {
+        ev.time = nextInterval();
+        ev.id = i;
+        schedule(es, ev);
+    }
+    for(i=0;i<holds/10;i++) {       // warm up
+        ev = nextEvent(es);
+        ev.time += nextInterval();
+        schedule(es, ev);
+    }
+    start = now();
+    for(i=0;i<holds;i++) {
+        ev = nextEvent(es);
+        if(ev.time < last)
+            ordered = 0;
+        last = ev.time;
+        ev.time += nextInterval();
+        schedule(es, ev);
+    }
+    start = now() - start;
+    freeEventSet(es);
+    return ordered ? start*1e9/holds : -1.0;
+}
+/*
+ * A program to compare the event set engines across M and load
+ *
+ * @param int argc, the number of command line arguments
+ * @param char *argv[], the command line arguments, optionally the number of holds
+ *
+ * @local long holds, the number of holds per measurement
+ * @local int e, int i, int j, counters
+ * @local int population, the number of pending events
+ * @local double ns, nanoseconds per hold
+ *
+ * @return 0
+ */
+int main(int argc, char *argv[]) {
+    long holds = argc > 1 ? atol(argv[1]) : 1000000;
+    int e, i, j, population;
+    double ns;
+
+    printf("%-10s %8s %6s %12s\n", "engine", "M", "load", "ns/hold");
+    for(i=0;i<(int)(sizeof(servers)/sizeof(servers[0]));i++) {
+        for(j=0;j<(int)(sizeof(loads)/sizeof(loads[0]));j++) {
+            population = (int)(loads[j]*servers[i]) + 1;
+            for(e=0;e<EVENTSET_ENGINES;e++) {
+                ns = hold(e, population, holds);
+                if(ns < 0)
+                    printf("%-10s %8d %6.2f %12s\n", eventSetName(e), servers[i], loads[j], "OUT OF ORDER");
+                else
+                    printf("%-10s %8d %6.2f %12.1f\n", eventSetName(e), servers[i], loads[j], ns);
+            }
+        }
+    }
+    return 0;
+}
@@ -0,0 +1,694 @@
+/***************************************************************
+  Paul Lewis
+  File Name: jackson.c
+  Simulation
+
+  Simulates open (Jackson) networks of M/M/c stations with
+  probabilistic routing. The traffic equations
+      gamma_j = lambda_j + sum_i gamma_i P(i, j)
+  give the arrival rate at each station, and by the product form
+  each station then behaves as M/M/c at that rate, so the network
+  is set against Erlang C station by station and, by Little's law,
+  end to end. A run keeps one future event set for every station,
+  and draws each routing decision in O(1) from an alias table
+***************************************************************/
+
+#include "jackson.h"
+#include "threadpool.h"
+
+/*
+ * One replication of a network, filled in by a worker thread
+ */
+struct networkJob {
+    const struct simConfig *cfg;
+    const struct simNetwork *net;
+    const struct routing *rt;
+    int rep;
+    struct results *r;
+    double w;
+    double l;
+    double visits;
+    long customers;
+    long peakEvents;
+};
+
+/*
+ * A function to allocate memory or exit
+ *
+ * @param size_t size, the bytes to allocate
+ *
+ * @local void *ptr, the memory
+ *
+ * @return void *, the memory
+ */
+static void *allocate(size_t size) {
+    void *ptr = malloc(size > 0 ? size : 1);
+    if(ptr == NULL) {
+        perror("malloc error. cannot create network.\n");
+        exit(1);
+    }
+    return ptr;
+}
+/*
+ * A function to solve the traffic equations (I - P^T) gamma = lambda by
+ * Gaussian elimination with partial pivoting
+ *
+ * @param const struct simNetwork *net, the network
+ * @param double *gamma, where to store the arrival rate at each station
+ *
+ * @local int i, j, k, counters
+ * @local int k0, the number of stations
+ * @local int pivot, the row of the largest pivot
+ * @local double *a, the system, row j is the equation of station j, with lambda_j in the last column
+ * @local double *row, double *tmp, rows of the system
+ * @local double f, the multiple of the pivot row taken away
+ *
+ * @return int, 0, or -1 if the system is singular, as it is when some customers never leave
+ */
+static int solveTraffic(const struct simNetwork *net, double *gamma) {
+    int i, j, k, k0 = net->stations, pivot;
+    double *a = (double *) allocate((size_t) k0 * (k0 + 1) * sizeof(double));
+    double *row, *tmp = (double *) allocate((k0 + 1) * sizeof(double));
+    double f;
+    memset(a, 0, (size_t) k0 * (k0 + 1) * sizeof(double));
+    for(j=0;j<k0;j++) {
+        a[(size_t) j*(k0+1) + j] = 1.0;
+        a[(size_t) j*(k0+1) + k0] = net->lambda[j];
+    }
+    for(k=0;k<net->routes;k++)
+        a[(size_t) net->route[k].to*(k0+1) + net->route[k].from] -= net->route[k].p;
+    for(i=0;i<k0;i++) {
+        pivot = i;
+        for(j=i+1;j<k0;j++)
+            if(fabs(a[(size_t) j*(k0+1) + i]) > fabs(a[(size_t) pivot*(k0+1) + i]))
+                pivot = j;
+        if(fabs(a[(size_t) pivot*(k0+1) + i]) < JACKSON_PIVOT) {
+            free(tmp);
+            free(a);
+            return -1;
+        }
+        if(pivot != i) {
+            memcpy(tmp, a + (size_t) i*(k0+1), (k0 + 1) * sizeof(double));
+            memcpy(a + (size_t) i*(k0+1), a + (size_t) pivot*(k0+1), (k0 + 1) * sizeof(double));
+            memcpy(a + (size_t) pivot*(k0+1), tmp, (k0 + 1) * sizeof(double));
+        }
+        row = a + (size_t) i*(k0+1);
+        for(j=i+1;j<k0;j++) {
+            f = a[(size_t) j*(k0+1) + i] / row[i];
+            if(f == 0)          // routing is sparse, so most rows are skipped
+                continue;
+            for(k=i;k<=k0;k++)
+                a[(size_t) j*(k0+1) + k] -= f * row[k];
+        }
+    }
+    for(i=k0-1;i>=0;i--) {
+        row = a + (size_t) i*(k0+1);
+        f = row[k0];
+        for(k=i+1;k<k0;k++)
+            f -= row[k] * gamma[k];
+        gamma[i] = f / row[i];
+    }
+    free(tmp);
+    free(a);
+    return 0;
+}
+/*
+ * A function to build the alias table of the entries of one station
+ * by Vose's method, from the probability of each entry in cut
+ *
+ * @param struct routing *rt, the routing
+ * @param int first, the first entry of the station
+ * @param int n, the number of entries
+ * @param int *work, room for n entries
+ *
+ * @local int i, a counter
+ * @local int small, the number of entries below their share, kept at the front of work
+ * @local int large, the number at or above it, kept at the back
+ * @local int s, l, an entry below and one above its share
+ */
+static void buildAlias(struct routing *rt, int first, int n, int *work) {
+    int i, small = 0, large = n, s, l;
+    for(i=0;i<n;i++) {
+        rt->cut[first + i] *= n;
+        rt->alias[first + i] = first + i;
+        if(rt->cut[first + i] < 1.0)
+            work[small++] = first + i;
+        else
+            work[--large] = first + i;
+    }
+    while(small > 0 && large < n) {
+        s = work[--small];
+        l = work[large];
+        rt->alias[s] = l;
+        rt->cut[l] -= 1.0 - rt->cut[s];
+        if(rt->cut[l] < 1.0) {      // l is now below its share, move it to the front
+            large++;
+            work[small++] = l;
+        }
+    }
+    for(i=0;i<small;i++)            // left over by rounding, keep them outright
+        rt->cut[work[i]] = 1.0;
+    for(i=large;i<n;i++)
+        rt->cut[work[i]] = 1.0;
+}
+/*
+ * A function to check a network, solve its traffic equations and
+ * build its routing
+ *
+ * @param const struct simNetwork *net, the network
+ *
+ * @local struct routing *rt, the new routing
+ * @local int i, k, counters
+ * @local int k0, the number of stations
+ * @local int *count, the entries of each station, then where the next one goes
+ * @local int *work, room for the alias tables
+ * @local double *out, the routing probabilities from each station
+ * @local double arrivals, the arrival rate from outside the network
+ * @local const struct simRoute *r, a route
+ *
+ * @return struct routing *, reference to the routing, NULL if the network
+ *  is invalid, some customers would never leave it or a station's gamma is
+ *  not below its M mu
+ */
+struct routing *newRouting(const struct simNetwork *net) {
+    struct routing *rt;
+    int i, k, k0 = net->stations;
+    int *count, *work;
+    double *out, arrivals = 0.0;
+    const struct simRoute *r;
+    if(k0 <= 0 || net->routes < 0 || (net->routes > 0 && net->route == NULL))
+        return NULL;
+    for(i=0;i<k0;i++) {
+        if(!(net->lambda[i] >= 0) || !(net->mu[i] > 0) || net->m[i] <= 0 || isinf(net->lambda[i]) || isinf(net->mu[i]))
+            return NULL;
+        arrivals += net->lambda[i];
+    }
+    if(!(arrivals > 0))
+        return NULL;
+    out = (double *) allocate(k0 * sizeof(double));
+    memset(out, 0, k0 * sizeof(double));
+    for(k=0;k<net->routes;k++) {
+        r = &net->route[k];
+        if(r->from < 0 || r->from >= k0 || r->to < 0 || r->to >= k0 || !(r->p >= 0) || r->p > 1.0) {
+            free(out);
+            return NULL;
+        }
+        out[r->from] += r->p;
+    }
+    for(i=0;i<k0;i++) {
+        if(out[i] > 1.0 + JACKSON_SLACK) {
+            free(out);
+            return NULL;
+        }
+    }
+
+    rt = (struct routing *) allocate(sizeof(struct routing));
+    rt->stations = k0;
+    rt->first = rt->dest = rt->alias = NULL;
+    rt->cut = NULL;
+    rt->gamma = (double *) allocate(k0 * sizeof(double));
+    k = solveTraffic(net, rt->gamma);
+    for(i=0;i<k0 && k == 0;i++) {
+        if(!isfinite(rt->gamma[i]) || rt->gamma[i] < -JACKSON_SLACK)
+            k = -1;
+        else if(rt->gamma[i] < 0)   // rounding below 0
+            rt->gamma[i] = 0.0;
+        if(rt->gamma[i] >= net->m[i]*net->mu[i])    // unstable, its queue grows without bound
+            k = -1;
+    }
+    if(k != 0) {
+        free(out);
+        freeRouting(rt);
+        return NULL;
+    }
+
+    count = (int *) allocate((k0 + 1) * sizeof(int));
+    for(i=0;i<k0;i++)
+        count[i] = out[i] < 1.0 - JACKSON_SLACK;    // leaving the network
+    for(k=0;k<net->routes;k++)
+        count[net->route[k].from] += net->route[k].p > 0;
+    rt->first = (int *) allocate((k0 + 1) * sizeof(int));
+    rt->first[0] = 0;
+    for(i=0;i<k0;i++)
+        rt->first[i+1] = rt->first[i] + count[i];
+    rt->dest = (int *) allocate(rt->first[k0] * sizeof(int));
+    rt->alias = (int *) allocate(rt->first[k0] * sizeof(int));
+    rt->cut = (double *) allocate(rt->first[k0] * sizeof(double));
+    for(i=0;i<k0;i++) {
+        count[i] = rt->first[i];
+        if(out[i] < 1.0 - JACKSON_SLACK) {
+            rt->dest[count[i]] = -1;
+            rt->cut[count[i]++] = 1.0 - out[i];
+        }
+    }
+    for(k=0;k<net->routes;k++) {
+        r = &net->route[k];
+        if(r->p > 0) {
+            rt->dest[count[r->from]] = r->to;
+            rt->cut[count[r->from]++] = r->p / (out[r->from] > 1.0 ? out[r->from] : 1.0);
+        }
+    }
+    work = (int *) allocate(rt->first[k0] * sizeof(int));
+    for(i=0;i<k0;i++)
+        buildAlias(rt, rt->first[i], rt->first[i+1] - rt->first[i], work);
+    free(work);
+    free(count);
+    free(out);
+    return rt;
+}
+/*
+ * A function to free a routing
+ *
+ * @param struct routing *rt, the routing
+ *
+ * @return struct routing *, reference to the freed routing (NULL)
+ */
+struct routing *freeRouting(struct routing *rt) {
+    free(rt->first);
+    free(rt->dest);
+    free(rt->alias);
+    free(rt->cut);
+    free(rt->gamma);
+    free(rt);
+    rt = NULL;
+    return rt;
+}
+/*
+ * A function to allocate one run of a network
+ * Replication rep draws routing from stream 0 of its streams, and
+ * station i its arrivals from stream 2i + 1 and services from 2i + 2
+ *
+ * @param const struct simNetwork *net, the network
+ * @param const struct routing *rt, its routing
+ * @param long n, the arrivals from outside to take
+ * @param int engine, the future event set engine
+ * @param int method, the variate method
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication, whose streams the run draws from
+ *
+ * @local struct network *nw, the new run
+ * @local struct station *st, a station
+ * @local struct rng r, the next stream
+ * @local struct event ev, the first arrival at a station
+ * @local int i, a counter
+ *
+ * @return struct network *, reference to the run
+ */
+struct network *newNetwork(const struct simNetwork *net, const struct routing *rt, long n, int engine, int method,
+        uint64_t seed, int rep) {
+    struct network *nw = (struct network *) allocate(sizeof(struct network));
+    struct station *st;
+    struct rng r;
+    struct event ev;
+    int i;
+    nw->net = net;
+    nw->rt = rt;
+    nw->st = (struct station *) allocate(net->stations * sizeof(struct station));
+    nw->es = newEventSet(engine);
+    nw->p = newPool();
+    nw->entered = NULL;
+    nw->at = NULL;
+    nw->capacity = 0;
+    nw->clock = 0.0;
+    nw->n = n;
+    nw->numberOfCustomers = 0;
+    nw->exits = 0;
+    nw->visits = 0;
+    nw->totalSojourn = 0.0;
+    nw->peakEvents = 0;
+    seedStream(&r, seed, rep, 0);
+    nw->route = r;
+    for(i=0;i<net->stations;i++) {
+        st = &nw->st[i];
+        memset(st, 0, sizeof(struct station));
+        st->q = newQueue();
+        st->m = net->m[i];
+        st->serviceAvailable = net->m[i];
+        jumpRng(&r);
+        if(net->lambda[i] > 0)
+            initVariates(&st->arrivals, &r, net->lambda[i], method);
+        jumpRng(&r);
+        initVariates(&st->services, &r, net->mu[i], method);
+    }
+    for(i=0;i<net->stations && nw->numberOfCustomers < n;i++) {    // the first arrival at each station
+        if(net->lambda[i] > 0) {
+            ev.time = nextVariate(&nw->st[i].arrivals);
+            ev.id = -1 - i;
+            schedule(nw->es, ev);
+            nw->numberOfCustomers++;
+        }
+    }
+    return nw;
+}
+/*
+ * A function to add the time since the number at a station last
+ * changed to its time-weighted statistics
+ *
+ * @param struct station *st, the station
+ * @param double clock, the simulated time
+ *
+ * @local int queue, the number waiting
+ * @local int inSystem, the number waiting or in service
+ * @local double dt, the time since the last change
+ */
+static inline void touchStation(struct station *st, double clock) {
+    int queue = st->q->size;
+    int inSystem = st->m - st->serviceAvailable + queue;
+    double dt = clock - st->last;
+    st->areaSystem += inSystem * dt;
+    st->areaQueue += queue * dt;
+    if(inSystem == 0)
+        st->idleTime += dt;
+    st->last = clock;
+}
+/*
+ * A function to start serving a customer at a station and schedule its departure
+ *
+ * @param struct network *nw, the run
+ * @param struct station *st, the station
+ * @param int c, the customer
+ *
+ * @local struct event ev, the departure
+ */
+static inline void startService(struct network *nw, struct station *st, int c) {
+    struct event ev;
+    nw->p->startOfServiceTime[c] = nw->clock;
+    st->totalWaitTime += nw->clock - nw->p->arrivalTime[c];
+    ev.time = nw->clock + nextVariate(&st->services);
+    ev.id = c;
+    nw->p->departureTime[c] = ev.time;
+    schedule(nw->es, ev);
+    if(nw->es->theSize > nw->peakEvents)
+        nw->peakEvents = nw->es->theSize;
+}
+/*
+ * A function for a customer to arrive at a station, from outside or routed
+ *
+ * @param struct network *nw, the run
+ * @param int s, the station
+ * @param int c, the customer
+ *
+ * @local struct station *st, the station
+ */
+static inline void joinStation(struct network *nw, int s, int c) {
+    struct station *st = &nw->st[s];
+    touchStation(st, nw->clock);
+    st->visits++;
+    nw->visits++;
+    nw->p->arrivalTime[c] = nw->clock;
+    nw->at[c] = s;
+    if(st->serviceAvailable > 0) {
+        st->serviceAvailable--;
+        startService(nw, st, c);
+    } else {
+        enqueue(st->q, c);
+        st->numInQueue++;
+    }
+}
+/*
+ * A function to draw where a customer leaving a station goes
+ *
+ * @param struct network *nw, the run
+ * @param int s, the station
+ *
+ * @local const struct routing *rt, the routing
+ * @local int first, the first entry of the station
+ * @local int n, the number of entries
+ * @local int k, the entry drawn
+ * @local uint64_t x, the random bits, the high half picks the entry and the low half keeps it
+ *
+ * @return int, the next station, -1 to leave the network
+ */
+static inline int routeFrom(struct network *nw, int s) {
+    const struct routing *rt = nw->rt;
+    int first = rt->first[s], n = rt->first[s+1] - first, k;
+    uint64_t x;
+    if(n == 1)
+        return rt->dest[first];
+    x = nextRandom(&nw->route);
+    k = first + (int) (((x >> 32) * (uint64_t) n) >> 32);
+    if((x & 0xffffffffULL) * 0x1p-32 >= rt->cut[k])
+        k = rt->alias[k];
+    return rt->dest[k];
+}
+/*
+ * A function to take an arrival from outside at a station and
+ * schedule the next one
+ *
+ * @param struct network *nw, the run
+ * @param int s, the station
+ *
+ * @local int c, the new customer
+ * @local struct event ev, the next arrival
+ */
+static void arriveOutside(struct network *nw, int s) {
+    int c = newCustomer(nw->p, nw->clock, 1);
+    struct event ev;
+    if(nw->p->capacity > nw->capacity) {    // the pool grew, grow the network's columns with it
+        nw->capacity = nw->p->capacity;
+        nw->entered = (double *) realloc(nw->entered, nw->capacity * sizeof(double));
+        nw->at = (int *) realloc(nw->at, nw->capacity * sizeof(int));
+        if(nw->entered == NULL || nw->at == NULL) {
+            perror("malloc error. cannot grow network.\n");
+            exit(1);
+        }
+    }
+    nw->entered[c] = nw->clock;
+    if(nw->numberOfCustomers < nw->n) {
+        ev.time = nw->clock + nextVariate(&nw->st[s].arrivals);
+        ev.id = -1 - s;
+        schedule(nw->es, ev);
+        nw->numberOfCustomers++;
+    }
+    joinStation(nw, s, c);
+}
+/*
+ * A function to take a departure from a station and route the
+ * customer on, or out of the network
+ *
+ * @param struct network *nw, the run
+ * @param int c, the customer
+ *
+ * @local int s, the station it leaves
+ * @local int next, where it goes
+ * @local struct station *st, the station
+ */
+static void departStation(struct network *nw, int c) {
+    int s = nw->at[c], next;
+    struct station *st = &nw->st[s];
+    touchStation(st, nw->clock);
+    st->served++;
+    st->totalServiceTime += nw->clock - nw->p->startOfServiceTime[c];
+    if(!isEmptyFIFO(st->q))
+        startService(nw, st, dequeue(st->q));
+    else
+        st->serviceAvailable++;
+    next = routeFrom(nw, s);
+    if(next >= 0) {
+        joinStation(nw, next, c);
+        return;
+    }
+    nw->exits++;
+    nw->totalSojourn += nw->clock - nw->entered[c];
+    freeCustomer(nw->p, c);
+}
+/*
+ * A function to run a network until every customer has left it
+ *
+ * @param struct network *nw, the run
+ *
+ * @local struct event ev, the next event
+ * @local int i, a counter
+ */
+void runNetwork(struct network *nw) {
+    struct event ev;
+    int i;
+    while(nw->es->theSize > 0) {
+        ev = nextEvent(nw->es);
+        nw->clock = ev.time;
+        if(ev.id < 0)
+            arriveOutside(nw, -1 - ev.id);
+        else
+            departStation(nw, ev.id);
+    }
+    for(i=0;i<nw->net->stations;i++)    // close every station's time-weighted statistics
+        touchStation(&nw->st[i], nw->clock);
+}
+/*
+ * A function to calculate the a posteriori statistics of a finished run
+ * A station no customer reached has 0 for its times and P(wait)
+ *
+ * @param struct network *nw, the finished run
+ * @param struct results *r, where to store the statistics of each station
+ * @param double *w, where to store the average time in the network
+ * @param double *l, where to store the average number in the network
+ * @param double *visits, where to store the average visits per customer
+ *
+ * @local struct station *st, a station
+ * @local double span, the time simulated
+ * @local double area, the time-weighted number in the network
+ * @local int i, a counter
+ */
+void networkCalc(struct network *nw, struct results *r, double *w, double *l, double *visits) {
+    struct station *st;
+    double span = nw->clock, area = 0.0;
+    int i;
+    for(i=0;i<nw->net->stations;i++) {
+        st = &nw->st[i];
+        r[i].po = st->idleTime/span;
+        r[i].w = st->served > 0 ? (st->totalWaitTime + st->totalServiceTime)/(double)st->served : 0.0;
+        r[i].wq = st->served > 0 ? st->totalWaitTime/(double)st->served : 0.0;
+        r[i].pWait = st->served > 0 ? st->numInQueue/(double)st->served : 0.0;
+        r[i].l = st->areaSystem/span;
+        r[i].lq = st->areaQueue/span;
+        r[i].utilization = (st->areaSystem - st->areaQueue)/(st->m * span);
+        area += st->areaSystem;
+    }
+    *w = nw->totalSojourn/(double)nw->exits;
+    *l = area/span;
+    *visits = nw->visits/(double)nw->exits;
+}
+/*
+ * A function to free a run of a network
+ *
+ * @param struct network *nw, the run
+ *
+ * @local int i, a counter
+ *
+ * @return struct network *, reference to the freed run (NULL)
+ */
+struct network *freeNetwork(struct network *nw) {
+    int i;
+    for(i=0;i<nw->net->stations;i++)
+        nw->st[i].q = freeFIFOqueue(nw->st[i].q);
+    free(nw->st);
+    nw->es = freeEventSet(nw->es);
+    nw->p = freePool(nw->p);
+    free(nw->entered);
+    free(nw->at);
+    free(nw);
+    nw = NULL;
+    return nw;
+}
+/*
+ * A function run by a worker thread for one replication of a network
+ *
+ * @param void *arg, the struct networkJob to run
+ *
+ * @local struct networkJob *job, the replication
+ * @local struct network *nw, the run
+ */
+static void networkReplicate(void *arg) {
+    struct networkJob *job = (struct networkJob *) arg;
+    struct network *nw = newNetwork(job->net, job->rt, job->cfg->n, job->cfg->engine, job->cfg->method,
+        job->cfg->seed, job->rep);
+    runNetwork(nw);
+    networkCalc(nw, job->r, &job->w, &job->l, &job->visits);
+    job->customers = nw->exits;
+    job->peakEvents = nw->peakEvents;
+    nw = freeNetwork(nw);
+}
+/*
+ * A function to simulate an open (Jackson) network. Every station has
+ * its own servers, queue and streams and all share one future event
+ * set, so an event costs O(log events) however many stations there are
+ * Each station's a priori statistics are those of M/M/c at the arrival
+ * rate the traffic equations give it, as the product form promises
+ *
+ * @param const struct simConfig *cfg, the run, cfg->n arrivals from outside the
+ *  network, with its seed, engine, method, replications and threads; lambda, mu, m,
+ *  the stopping rule, warm-up, variance reduction, trace, log, checkpoints and
+ *  progress are not used
+ * @param const struct simNetwork *net, the network
+ * @param struct simNetworkResults *out, where to store the results, out->station
+ *  must hold net->stations entries
+ *
+ * @local int i, j, k, counters
+ * @local int reps, the number of replications
+ * @local struct simConfig run, the config with only what a network uses
+ * @local struct routing *rt, the routing
+ * @local struct networkJob *jobs, the replications
+ * @local struct results *r, the statistics of every station of every replication
+ * @local struct threadPool *tp, the workers
+ * @local struct summary s, one statistic over the replications
+ * @local struct summary w, l, v, the end to end statistics over the replications
+ *
+ * @return int, 0, or -1 if the config or network is invalid, some
+ *  customers would never leave the network or a station would be unstable,
+ *  its gamma not below m mu
+ */
+int simulateNetwork(const struct simConfig *cfg, const struct simNetwork *net, struct simNetworkResults *out) {
+    int i, j, k, reps = cfg->replications;
+    struct simConfig run;
+    struct routing *rt;
+    struct networkJob *jobs;
+    struct results *r;
+    struct threadPool *tp;
+    struct summary s, w, l, v;
+    defaultConfig(&run);
+    run.n = cfg->n;
+    run.seed = cfg->seed;
+    run.engine = cfg->engine;
+    run.method = cfg->method;
+    run.replications = cfg->replications;
+    run.threads = cfg->threads;
+    if(!validConfig(&run) || (rt = newRouting(net)) == NULL)
+        return -1;
+    jobs = (struct networkJob *) allocate(reps * sizeof(struct networkJob));
+    r = (struct results *) allocate((size_t) reps * net->stations * sizeof(struct results));
+    tp = newThreadPool(cfg->threads);
+    for(k=0;k<reps;k++) {
+        jobs[k].cfg = &run;
+        jobs[k].net = net;
+        jobs[k].rt = rt;
+        jobs[k].rep = k;
+        jobs[k].r = r + (size_t) k * net->stations;
+        submitTask(tp, networkReplicate, &jobs[k]);
+    }
+    waitThreadPool(tp);
+    tp = freeThreadPool(tp);
+
+    out->replications = reps;
+    out->customers = 0;
+    out->peakEvents = 0;
+    out->lambda = 0.0;
+    out->analyticL = 0.0;
+    out->analyticVisits = 0.0;
+    for(i=0;i<net->stations;i++) {
+        out->station[i].gamma = rt->gamma[i];
+        out->station[i].analytic = preCalc(rt->gamma[i], net->mu[i], net->m[i]);
+        out->lambda += net->lambda[i];
+        out->analyticL += out->station[i].analytic.l;
+        out->analyticVisits += rt->gamma[i];
+        for(j=0;j<RESULT_STATS;j++) {
+            initSummary(&s);
+            for(k=0;k<reps;k++)     // in replication order so the results are deterministic
+                addSample(&s, *resultStat(&jobs[k].r[i], j));
+            *resultStat(&out->station[i].mean, j) = s.mean;
+            *resultStat(&out->station[i].halfWidth, j) = halfWidth95(&s);
+        }
+    }
+    out->analyticW = out->analyticL/out->lambda;     // Little's law over the whole network
+    out->analyticVisits /= out->lambda;
+    initSummary(&w);
+    initSummary(&l);
+    initSummary(&v);
+    for(k=0;k<reps;k++) {
+        addSample(&w, jobs[k].w);
+        addSample(&l, jobs[k].l);
+        addSample(&v, jobs[k].visits);
+        out->customers += jobs[k].customers;
+        if(jobs[k].peakEvents > out->peakEvents)
+            out->peakEvents = jobs[k].peakEvents;
+    }
+    out->w = w.mean;
+    out->wHalfWidth = halfWidth95(&w);
+    out->l = l.mean;
+    out->lHalfWidth = halfWidth95(&l);
+    out->visits = v.mean;
+    out->visitsHalfWidth = halfWidth95(&v);
+    free(r);
+    free(jobs);
+    rt = freeRouting(rt);
+    return 0;
+}
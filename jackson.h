@@ -0,0 +1,174 @@
+/***************************************************************
+  Paul Lewis
+  File Name: jackson.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for jackson.c
+***************************************************************/
+
+#include "model.h"
+
+#ifndef _jackson_h
+#define _jackson_h
+
+#define JACKSON_PIVOT 1e-12     // a smaller pivot means some customers never leave the network
+#define JACKSON_SLACK 1e-9      // the rounding allowed in the routing probabilities of a station
+
+/*
+ * The routing of an open network, built once and shared by every
+ * replication. The outcomes of a departure from station s are the
+ * entries first[s] to first[s+1] - 1, one for each route and one for
+ * leaving, drawn in O(1) by the alias method: an entry is picked
+ * uniformly and kept with probability cut, otherwise its alias is taken
+ *
+ * @field int stations, the number of stations
+ * @field int *first, where the entries of each station start, stations + 1 of them
+ * @field int *dest, the station an entry goes to, -1 to leave the network
+ * @field int *alias, the entry taken when an entry is not kept
+ * @field double *cut, the probability an entry is kept
+ * @field double *gamma, the arrival rate at each station, from the traffic equations
+ */
+struct routing {
+    int stations;
+    int *first;
+    int *dest;
+    int *alias;
+    double *cut;
+    double *gamma;
+};
+
+/*
+ * One station of a network in a run, an M/M/c queue of its own
+ *
+ * @field struct FIFOqueue *q, the customers waiting
+ * @field struct variates arrivals, the interarrival times from outside the network
+ * @field struct variates services, the service times
+ * @field int m, the number of servers
+ * @field int serviceAvailable, the number of idle servers
+ * @field double last, the time the number at the station last changed
+ * @field double areaSystem, double areaQueue, the time-weighted number at the station and in its queue
+ * @field double idleTime, the time with no one at the station
+ * @field double totalWaitTime, double totalServiceTime, over every visit
+ * @field long visits, the arrivals at the station, from outside or routed
+ * @field long served, the departures
+ * @field long numInQueue, the visits that had to wait
+ */
+struct station {
+    struct FIFOqueue *q;
+    struct variates arrivals;
+    struct variates services;
+    int m;
+    int serviceAvailable;
+    double last;
+    double areaSystem;
+    double areaQueue;
+    double idleTime;
+    double totalWaitTime;
+    double totalServiceTime;
+    long visits;
+    long served;
+    long numInQueue;
+};
+
+/*
+ * One run of an open network. Every station shares the one future
+ * event set: an event with id c >= 0 is the departure of customer c
+ * from the station at[c], one with id -1 - s is the next arrival from
+ * outside at station s
+ *
+ * @field const struct simNetwork *net, the network
+ * @field const struct routing *rt, its routing
+ * @field struct station *st, the stations
+ * @field struct eventSet *es, the future event set
+ * @field struct customerPool *p, the customers in the network
+ * @field double *entered, the time each customer entered the network
+ * @field int *at, the station each customer is at
+ * @field int capacity, the customers entered and at can hold
+ * @field struct rng route, the stream routing is drawn from
+ * @field double clock, the simulated time
+ * @field long n, the arrivals from outside to take
+ * @field long numberOfCustomers, the arrivals from outside scheduled
+ * @field long exits, the customers that have left the network
+ * @field long visits, the visits to every station
+ * @field double totalSojourn, the time in the network of every customer that left
+ * @field long peakEvents, the most events in the event set at once
+ */
+struct network {
+    const struct simNetwork *net;
+    const struct routing *rt;
+    struct station *st;
+    struct eventSet *es;
+    struct customerPool *p;
+    double *entered;
+    int *at;
+    int capacity;
+    struct rng route;
+    double clock;
+    long n;
+    long numberOfCustomers;
+    long exits;
+    long visits;
+    double totalSojourn;
+    long peakEvents;
+};
+
+/*
+ * A function to check a network, solve its traffic equations and
+ * build its routing
+ *
+ * @param const struct simNetwork *net, the network
+ *
+ * @return struct routing *, reference to the routing, NULL if the network
+ *  is invalid, some customers would never leave it or a station's gamma is
+ *  not below its M mu
+ */
+struct routing *newRouting(const struct simNetwork *net);
+/*
+ * A function to free a routing
+ *
+ * @param struct routing *rt, the routing
+ *
+ * @return struct routing *, reference to the freed routing (NULL)
+ */
+struct routing *freeRouting(struct routing *rt);
+/*
+ * A function to allocate one run of a network
+ *
+ * @param const struct simNetwork *net, the network
+ * @param const struct routing *rt, its routing
+ * @param long n, the arrivals from outside to take
+ * @param int engine, the future event set engine
+ * @param int method, the variate method
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication, whose streams the run draws from
+ *
+ * @return struct network *, reference to the run
+ */
+struct network *newNetwork(const struct simNetwork *net, const struct routing *rt, long n, int engine, int method,
+        uint64_t seed, int rep);
+/*
+ * A function to run a network until every customer has left it
+ *
+ * @param struct network *nw, the run
+ */
+void runNetwork(struct network *nw);
+/*
+ * A function to calculate the a posteriori statistics of a finished run
+ *
+ * @param struct network *nw, the finished run
+ * @param struct results *r, where to store the statistics of each station
+ * @param double *w, where to store the average time in the network
+ * @param double *l, where to store the average number in the network
+ * @param double *visits, where to store the average visits per customer
+ */
+void networkCalc(struct network *nw, struct results *r, double *w, double *l, double *visits);
+/*
+ * A function to free a run of a network
+ *
+ * @param struct network *nw, the run
+ *
+ * @return struct network *, reference to the freed run (NULL)
+ */
+struct network *freeNetwork(struct network *nw);
+
+#endif
@@ -0,0 +1,339 @@
+/***************************************************************
+  Paul Lewis
+  File Name: ladder.c
+  Simulation
+
+  Contains functions for creating, using, and freeing a ladder queue
+***************************************************************/
+
+#include "ladder.h"
+
+/*
+ * A function to allocate and initialize an empty ladder queue
+ *
+ * @local struct ladder *lq, reference to new queue
+ * @local int i, a counter
+ *
+ * @return struct ladder *, reference to the queue
+ */
+struct ladder *newLadder() {
+    int i;
+    struct ladder *lq = (struct ladder *) malloc(sizeof(struct ladder));
+    if(lq == NULL) {
+        perror("malloc failed. cannot construct ladder queue.\n");
+        exit(1);
+    }
+    lq->theSize = 0;
+    lq->top = NULL;
+    lq->topCount = 0;
+    lq->topMin = 0.0;
+    lq->topMax = 0.0;
+    lq->topStart = -HUGE_VAL;       // everything goes in top until the first rung exists
+    for(i=0;i<LADDER_RUNGS;i++) {
+        lq->rungs[i].buckets = NULL;
+        lq->rungs[i].counts = NULL;
+        lq->rungs[i].maxBuckets = 0;
+    }
+    lq->numRungs = 0;
+    lq->bottom = NULL;
+    lq->bottomCount = 0;
+    initNodePool(&lq->nodes);
+    return lq;
+}
+/*
+ * A function to find the bucket of a rung an event time falls in
+ *
+ * @param struct rung *r, the rung
+ * @param double t, the event time
+ *
+ * @local double b, the unclamped bucket number
+ *
+ * @return int, the bucket index, -1 if t is before the rung
+ */
+static int bucketOf(struct rung *r, double t) {
+    double b = floor((t - r->start)/r->width);
+    if(b < 0.0)
+        return -1;
+    if(b >= r->numBuckets)
+        return r->numBuckets-1;
+    return (int) b;
+}
+/*
+ * A function to sort a list of nodes by time
+ *
+ * @param struct eventNode *list, the list
+ * @param int count, the number of nodes in the list
+ *
+ * @local struct eventNode *a, struct eventNode *b, the two halves
+ * @local struct eventNode *head, the sorted list
+ * @local struct eventNode **link, the end of the sorted list
+ * @local int i, a counter
+ *
+ * @return struct eventNode *, the sorted list
+ */
+static struct eventNode *sortList(struct eventNode *list, int count) {
+    struct eventNode *a = list, *b, *head = NULL, **link = &head;
+    int i;
+    if(count < 2)
+        return list;
+    for(i=1;i<count/2;i++)      // split after the first half
+        a = a->next;
+    b = a->next;
+    a->next = NULL;
+    a = sortList(list, count/2);
+    b = sortList(b, count - count/2);
+    while(a != NULL && b != NULL) {     // merge, taking from a on ties to keep order
+        if(b->ev.time < a->ev.time) {
+            *link = b;
+            b = b->next;
+        } else {
+            *link = a;
+            a = a->next;
+        }
+        link = &(*link)->next;
+    }
+    *link = a != NULL ? a : b;
+    return head;
+}
+/*
+ * A function to spread a list of events over a new, finer rung
+ * There must be fewer than LADDER_RUNGS rungs and max > min
+ *
+ * @param struct ladder *lq, the queue
+ * @param struct eventNode *list, the events
+ * @param int count, the number of events
+ * @param double min, the smallest time in the list
+ * @param double max, the largest time in the list
+ *
+ * @local struct rung *r, the new rung
+ * @local struct eventNode *e, the node being placed
+ * @local int b, the bucket index
+ */
+static void spawnRung(struct ladder *lq, struct eventNode *list, int count, double min, double max) {
+    struct rung *r = &lq->rungs[lq->numRungs++];
+    struct eventNode *e;
+    int b;
+    r->numBuckets = count+1;    // the last bucket holds events at max
+    if(r->numBuckets > r->maxBuckets) {
+        free(r->buckets);
+        free(r->counts);
+        r->maxBuckets = r->numBuckets;
+        r->buckets = malloc(sizeof(struct eventNode *)*r->maxBuckets);
+        r->counts = malloc(sizeof(int)*r->maxBuckets);
+        if(r->buckets == NULL || r->counts == NULL) {
+            perror("malloc failed. cannot construct ladder rung.\n");
+            exit(1);
+        }
+    }
+    for(b=0;b<r->numBuckets;b++) {
+        r->buckets[b] = NULL;
+        r->counts[b] = 0;
+    }
+    r->start = min;
+    r->width = (max - min)/count;
+    r->cur = 0;
+    r->count = count;
+    while(list != NULL) {
+        e = list;
+        list = e->next;
+        b = bucketOf(r, e->ev.time);
+        if(b < 0)
+            b = 0;
+        e->next = r->buckets[b];
+        r->buckets[b] = e;
+        r->counts[b]++;
+    }
+}
+/*
+ * A function to insert a node into the sorted bottom list
+ * A bottom that grows past LADDER_THRESHOLD becomes a new rung
+ *
+ * @param struct ladder *lq, the queue
+ * @param struct eventNode *e, the node
+ *
+ * @local struct eventNode **link, the link to update
+ * @local struct eventNode *last, the last node of bottom
+ */
+static void bottomInsert(struct ladder *lq, struct eventNode *e) {
+    struct eventNode **link = &lq->bottom, *last;
+    while(*link != NULL && !(e->ev.time < (*link)->ev.time))
+        link = &(*link)->next;
+    e->next = *link;
+    *link = e;
+    lq->bottomCount++;
+    if(lq->bottomCount > LADDER_THRESHOLD && lq->numRungs < LADDER_RUNGS) {
+        for(last=lq->bottom;last->next!=NULL;last=last->next)
+            ;
+        if(last->ev.time > lq->bottom->ev.time) {
+            spawnRung(lq, lq->bottom, lq->bottomCount, lq->bottom->ev.time, last->ev.time);
+            lq->bottom = NULL;
+            lq->bottomCount = 0;
+        }
+    }
+}
+/*
+ * A function to add an element to a ladder queue
+ * The event goes in top, the coarsest rung whose unemptied buckets
+ * cover it, or bottom
+ *
+ * @param struct ladder *lq, the queue
+ * @param struct event ev, the element to add
+ *
+ * @local struct eventNode *e, the new node
+ * @local double t, the event time
+ * @local struct rung *r, the rung being checked
+ * @local int i, a counter
+ * @local int b, the bucket index
+ */
+void ladderInsert(struct ladder *lq, struct event ev) {
+    struct eventNode *e = newNode(&lq->nodes, ev);
+    double t = ev.time;
+    struct rung *r;
+    int i, b;
+    lq->theSize++;
+    if(t >= lq->topStart) {
+        if(lq->topCount == 0 || t < lq->topMin)
+            lq->topMin = t;
+        if(lq->topCount == 0 || t > lq->topMax)
+            lq->topMax = t;
+        e->next = lq->top;
+        lq->top = e;
+        lq->topCount++;
+        return;
+    }
+    for(i=0;i<lq->numRungs;i++) {
+        r = &lq->rungs[i];
+        b = bucketOf(r, t);
+        if(b >= r->cur) {
+            e->next = r->buckets[b];
+            r->buckets[b] = e;
+            r->counts[b]++;
+            r->count++;
+            return;
+        }
+    }
+    bottomInsert(lq, e);
+}
+/*
+ * A function to refill bottom from the ladder, and the ladder from top
+ * The first non-empty bucket of the finest rung is sorted into bottom,
+ * or spread over a new rung if it holds too many events
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @local struct rung *r, the finest rung
+ * @local struct eventNode *list, the bucket being moved
+ * @local struct eventNode *e, a node of list
+ * @local int count, the number of events in list
+ * @local double min, double max, the time range of list
+ */
+static void refill(struct ladder *lq) {
+    struct rung *r;
+    struct eventNode *list, *e;
+    int count;
+    double min, max;
+    while(lq->bottom == NULL) {
+        if(lq->numRungs == 0) {
+            if(lq->topCount == 0)
+                return;
+            list = lq->top;             // move top onto the ladder
+            count = lq->topCount;
+            lq->topStart = lq->topMax;
+            lq->top = NULL;
+            lq->topCount = 0;
+            if(lq->topMax > lq->topMin) {
+                spawnRung(lq, list, count, lq->topMin, lq->topMax);
+            } else {                    // all times are equal
+                lq->bottom = list;
+                lq->bottomCount = count;
+                return;
+            }
+        }
+        r = &lq->rungs[lq->numRungs-1];
+        while(r->cur < r->numBuckets && r->counts[r->cur] == 0)
+            r->cur++;
+        if(r->cur == r->numBuckets) {   // rung is empty
+            lq->numRungs--;
+            continue;
+        }
+        list = r->buckets[r->cur];
+        count = r->counts[r->cur];
+        r->buckets[r->cur] = NULL;
+        r->counts[r->cur] = 0;
+        r->cur++;
+        r->count -= count;
+        min = max = list->ev.time;
+        for(e=list->next;e!=NULL;e=e->next) {
+            if(e->ev.time < min)
+                min = e->ev.time;
+            if(e->ev.time > max)
+                max = e->ev.time;
+        }
+        if(count > LADDER_THRESHOLD && lq->numRungs < LADDER_RUNGS && max > min) {
+            spawnRung(lq, list, count, min, max);
+        } else {
+            lq->bottom = sortList(list, count);
+            lq->bottomCount = count;
+        }
+    }
+}
+/*
+ * A function to remove the smallest element from a ladder queue
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @local struct eventNode *e, the smallest node
+ * @local struct event min, the element to return
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event ladderDeleteMin(struct ladder *lq) {
+    struct eventNode *e;
+    struct event min;
+    if(lq->theSize == 0) {
+        min.id = -1;
+        return min;
+    }
+    refill(lq);
+    e = lq->bottom;
+    lq->bottom = e->next;
+    lq->bottomCount--;
+    min = e->ev;
+    freeNode(&lq->nodes, e);
+    if(--lq->theSize == 0) {        // start over so the next events go in top
+        lq->numRungs = 0;
+        lq->topStart = -HUGE_VAL;
+    }
+    return min;
+}
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @return struct event, the element
+ */
+struct event ladderGetMin(struct ladder *lq) {
+    refill(lq);
+    return lq->bottom->ev;
+}
+/*
+ * A function to free a ladder queue
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @local int i, a counter
+ *
+ * @return struct ladder *, reference to the freed queue (NULL)
+ */
+struct ladder *freeLadder(struct ladder *lq) {
+    int i;
+    for(i=0;i<LADDER_RUNGS;i++) {
+        free(lq->rungs[i].buckets);
+        free(lq->rungs[i].counts);
+    }
+    clearNodePool(&lq->nodes);
+    free(lq);
+    lq = NULL;
+    return lq;
+}
@@ -0,0 +1,122 @@
+/***************************************************************
+  Paul Lewis
+  File Name: ladder.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for ladder.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include "customer.h"
+#include "eventnode.h"
+
+#ifndef _ladder_h
+#define _ladder_h
+
+/*
+ * The most rungs a ladder queue will spawn
+ */
+#define LADDER_RUNGS 8
+/*
+ * The number of events a bucket or the bottom may hold before
+ * it is spread over a new rung instead of being sorted
+ */
+#define LADDER_THRESHOLD 50
+
+/*
+ * One rung of a ladder queue
+ * Bucket i holds unsorted the events in [start+i*width, start+(i+1)*width)
+ *
+ * @field struct eventNode **buckets, the bucket lists
+ * @field int *counts, the number of events in each bucket
+ * @field int numBuckets, the number of buckets in use
+ * @field int maxBuckets, the size of the bucket arrays
+ * @field double start, the time the first bucket starts at
+ * @field double width, the length of time covered by one bucket
+ * @field int cur, the first bucket that has not been emptied
+ * @field int count, the number of events on the rung
+ */
+struct rung {
+    struct eventNode **buckets;
+    int *counts;
+    int numBuckets;
+    int maxBuckets;
+    double start;
+    double width;
+    int cur;
+    int count;
+};
+
+/*
+ * The ladder queue structure (Tang, Goh and Thng, 2005)
+ * New far-future events go unsorted into top, the ladder spreads
+ * events over rungs of buckets that are each finer than the last,
+ * and bottom holds the earliest events sorted
+ *
+ * @field int theSize, the number of events
+ * @field struct eventNode *top, the unsorted future events
+ * @field int topCount, the number of events in top
+ * @field double topMin, the smallest time in top
+ * @field double topMax, the largest time in top
+ * @field double topStart, events at or after this time go in top
+ * @field struct rung rungs[], the rungs, rungs[0] is the coarsest
+ * @field int numRungs, the number of rungs in use
+ * @field struct eventNode *bottom, the earliest events, sorted
+ * @field int bottomCount, the number of events in bottom
+ * @field struct nodePool nodes, the pool nodes are allocated from
+ */
+struct ladder {
+    int theSize;
+    struct eventNode *top;
+    int topCount;
+    double topMin;
+    double topMax;
+    double topStart;
+    struct rung rungs[LADDER_RUNGS];
+    int numRungs;
+    struct eventNode *bottom;
+    int bottomCount;
+    struct nodePool nodes;
+};
+
+/*
+ * A function to allocate and initialize an empty ladder queue
+ *
+ * @return struct ladder *, reference to the queue
+ */
+struct ladder *newLadder();
+/*
+ * A function to add an element to a ladder queue
+ *
+ * @param struct ladder *lq, the queue
+ * @param struct event ev, the element to add
+ */
+void ladderInsert(struct ladder *lq, struct event ev);
+/*
+ * A function to remove the smallest element from a ladder queue
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event ladderDeleteMin(struct ladder *lq);
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @return struct event, the element
+ */
+struct event ladderGetMin(struct ladder *lq);
+/*
+ * A function to free a ladder queue
+ *
+ * @param struct ladder *lq, the queue
+ *
+ * @return struct ladder *, reference to the freed queue (NULL)
+ */
+struct ladder *freeLadder(struct ladder *lq);
+
+#endif
@@ -0,0 +1,129 @@
+/***************************************************************
+  Paul Lewis
+  File Name: libsimulation.c
+  Simulation
+
+  The entry points of libsimulation
+***************************************************************/
+
+#include "model.h"
+#include "replication.h"
+
+/*
+ * A session, a warm thread pool and the runs its workers reuse
+ *
+ * @field struct threadPool *tp, the workers
+ * @field struct runCache cache, finished runs kept for reuse
+ */
+struct simSession {
+    struct threadPool *tp;
+    struct runCache cache;
+};
+
+/*
+ * A function to fill a config with the defaults: lambda 4, mu 3, M 2,
+ * N 5000, seed 1, binary heap, ziggurat, one replication, one thread
+ * per processor, no stopping rule, warm-up detection, variance reduction, trace or log
+ *
+ * @param struct simConfig *cfg, the config to fill
+ */
+void defaultConfig(struct simConfig *cfg) {
+    cfg->lambda = 4;
+    cfg->mu = 3;
+    cfg->m = 2;
+    cfg->n = 5000;
+    cfg->seed = 1;
+    cfg->engine = EVENTSET_BINARY;
+    cfg->method = VARIATE_ZIGGURAT;
+    cfg->replications = 1;
+    cfg->threads = 0;
+    cfg->tolerance = 0.0;
+    cfg->stopOn = SIM_STOP_WQ;
+    cfg->warmup = 0;
+    cfg->antithetic = 0;
+    cfg->control = 0;
+    cfg->trace = NULL;
+    cfg->log = NULL;
+    cfg->logThread = 0;
+    cfg->checkpoint = NULL;
+    cfg->checkpointEvery = 10000000;
+    cfg->restore = NULL;
+    cfg->progress = NULL;
+}
+/*
+ * A function to run the simulation described by a config
+ *
+ * @param const struct simConfig *cfg, the run
+ * @param struct simResults *res, where to store the results
+ *
+ * @return int, 0, or -1 if the config is invalid or its checkpoint cannot be restored
+ */
+int simulate(const struct simConfig *cfg, struct simResults *res) {
+    if(!validConfig(cfg) || (cfg->restore != NULL && checkCheckpoint(cfg) != 0))
+        return -1;
+    runReplications(cfg, res);
+    return 0;
+}
+/*
+ * A function to start a session, a pool of threads kept warm for
+ * any number of asynchronous runs
+ *
+ * @param int threads, the number of threads, 0 for one per processor
+ *
+ * @local struct simSession *s, the new session
+ *
+ * @return struct simSession *, reference to the session
+ */
+struct simSession *newSession(int threads) {
+    struct simSession *s = (struct simSession *) malloc(sizeof(struct simSession));
+    if(s == NULL) {
+        perror("malloc error. cannot create session.\n");
+        exit(1);
+    }
+    s->tp = newThreadPool(threads);
+    initRunCache(&s->cache);
+    return s;
+}
+/*
+ * A function to start the run described by a config on a session
+ * and return at once. Its replications are spread over the session's
+ * threads, cfg->threads is ignored. When the last one finishes, done
+ * is called on that thread with the results, which are only valid
+ * during the call
+ *
+ * @param struct simSession *s, the session
+ * @param const struct simConfig *cfg, the run, copied
+ * @param void (*done)(struct simResults *, void *), called with the results
+ * @param void *arg, passed to done
+ *
+ * @return int, 0, or -1 if the config is invalid or its checkpoint cannot be restored
+ */
+int simulateAsync(struct simSession *s, const struct simConfig *cfg,
+        void (*done)(struct simResults *, void *), void *arg) {
+    if(!validConfig(cfg) || (cfg->restore != NULL && checkCheckpoint(cfg) != 0))
+        return -1;
+    submitReplications(s->tp, &s->cache, cfg, done, arg);
+    return 0;
+}
+/*
+ * A function to wait until every run started on a session has finished
+ *
+ * @param struct simSession *s, the session
+ */
+void waitSession(struct simSession *s) {
+    waitThreadPool(s->tp);
+}
+/*
+ * A function to finish the runs of a session and free it
+ *
+ * @param struct simSession *s, the session
+ *
+ * @return struct simSession *, reference to the freed session (NULL)
+ */
+struct simSession *freeSession(struct simSession *s) {
+    s->tp = freeThreadPool(s->tp);
+    clearRunCache(&s->cache);
+    free(s);
+    s = NULL;
+    return s;
+}
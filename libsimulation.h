@@ -0,0 +1,521 @@
+/***************************************************************
+  Paul Lewis
+  File Name: libsimulation.h
+  Simulation
+
+  The interface to libsimulation, the simulation as a library.
+  A run is described by a struct simConfig and its statistics
+  come back in a struct simResults. The library keeps no global
+  state and does not write to stdout or touch files, other than
+  a trace it is asked to map, a log it is asked to write, a
+  checkpoint it is asked to write or restore or shared memory it
+  is asked to publish to, so runs may be made from any number of
+  threads at once
+***************************************************************/
+
+#include <stdint.h>
+
+#ifndef _libsimulation_h
+#define _libsimulation_h
+
+#define SIM_STATES 64   // P(n) is kept for n up to SIM_STATES - 2, the last entry is n >= SIM_STATES - 1
+#define SIM_STOP_WQ 0   // sequential stopping on the time spent waiting in queue
+#define SIM_STOP_W 1    // sequential stopping on the time spent in the system
+#define SIM_CONTROL_UNITS 4     // the fewest replications, or antithetic pairs, control variates are fitted to
+
+#define SIM_PHASE_RUN 0         // the whole event loop
+#define SIM_PHASE_ARRIVAL 1     // handling an arrival, the phases below included
+#define SIM_PHASE_DEPARTURE 2   // handling a departure, likewise
+#define SIM_PHASE_EVENTSET 3    // scheduling and taking events
+#define SIM_PHASE_FIFO 4        // putting customers in and taking them from the queue
+#define SIM_PHASE_VARIATE 5     // taking an interval from its batch
+#define SIM_PHASE_REFILL 6      // taking an interval that refilled the batch first
+#define SIM_PHASES 7
+
+/*
+ * The a priori statistics of M/M/c
+ *
+ * @field double po, the percentage of idle time
+ * @field double l, the average number in the system
+ * @field double w, the average time spent in the system
+ * @field double lq, the average number waiting in queue
+ * @field double wq, the average time spent waiting in queue
+ * @field double rho, the utilization
+ * @field double pWait, the probability of having to wait for service (Erlang C)
+ * Where rho >= 1 the queue grows without bound, Po is 0, P(wait) 1,
+ * and L, W, Lq and Wq are infinite
+ */
+struct analytic {
+    double po;
+    double l;
+    double w;
+    double lq;
+    double wq;
+    double rho;
+    double pWait;
+};
+
+/*
+ * The a posteriori statistics of a run
+ *
+ * @field double po, the percentage of idle time
+ * @field double w, the average time spent in the system
+ * @field double wq, the average time spent waiting in queue
+ * @field double pWait, the probability of having to wait for service
+ * @field double l, the time-weighted average number in the system
+ * @field double lq, the time-weighted average number waiting in queue
+ * @field double utilization, the fraction of time each server is busy, the busy
+ *  servers over m, as the servers are identical and not told apart
+ */
+struct results {
+    double po;
+    double w;
+    double wq;
+    double pWait;
+    double l;
+    double lq;
+    double utilization;
+};
+
+/*
+ * Quantiles of a time, from a log-bucketed histogram, each within 0.4%
+ *
+ * @field double p95, the 95th percentile
+ * @field double p99, the 99th percentile
+ * @field double p999, the 99.9th percentile
+ */
+struct quantiles {
+    double p95;
+    double p99;
+    double p999;
+};
+
+/*
+ * Where the event loop spent its time, only filled by a build with
+ * SIM_PROFILE defined (make PROFILE=1)
+ *
+ * @field int enabled, boolean, whether the build is profiled
+ * @field uint64_t cycles[], the cycles spent in each SIM_PHASE_, nanoseconds
+ *  on processors without a cycle counter
+ * @field long calls[], the times each phase was entered, for the run that is
+ *  the runs, for arrivals and departures the events
+ * @field long peakEvents, the most events pending at once
+ * @field long peakQueue, the most customers waiting at once
+ */
+struct simProfile {
+    int enabled;
+    uint64_t cycles[SIM_PHASES];
+    long calls[SIM_PHASES];
+    long peakEvents;
+    long peakQueue;
+};
+
+/*
+ * A description of a run, start from defaultConfig()
+ *
+ * @field double lambda, the average number of arrivals per time unit
+ * @field double mu, the average number of customers to service per time unit
+ * @field int m, the number of servers
+ * @field long n, total number of arrivals to service in each replication
+ * @field uint64_t seed, the seed, the same seed always gives the same results
+ * @field int engine, the future event set, one of the EVENTSET_ values (0 binary heap)
+ * @field int method, how intervals are generated, one of the VARIATE_ values (0 ziggurat)
+ * @field int replications, the number of independent replications
+ * @field int threads, the number of threads to run replications on, 0 for one per processor
+ * @field double tolerance, 0 to serve n customers, otherwise each replication stops taking
+ *  arrivals once the batch means 95% half-width of stopOn is below tolerance times
+ *  its mean, and n is the most customers it may take
+ * @field int stopOn, the time the stopping rule watches, SIM_STOP_WQ or SIM_STOP_W
+ * @field int warmup, boolean, whether each replication finds the end of its warm-up
+ *  with MSER-5 on the times waited in queue, at least the queue's relaxation time from
+ *  empty, and leaves it out of every statistic
+ * @field int antithetic, boolean, whether replications 2k and 2k+1 are an antithetic
+ *  pair, drawing by inversion from U and 1-U, replications must then be even
+ * @field int control, boolean, whether the means are corrected with the observed
+ *  mean service and interarrival times as control variates, replications (pairs with
+ *  antithetic) must then be at least SIM_CONTROL_UNITS
+ * @field const struct simTrace *trace, NULL to draw the intervals, or a trace from
+ *  openTrace() to replay instead, replication r taking n customers from record r*n
+ *  on and wrapping to the start, lambda and mu are then only used a priori and
+ *  antithetic and control must be 0
+ * @field const char *log, NULL, or a file to write every customer's arrival, start
+ *  of service and departure to, with ".r" added for replication r if there are
+ *  several, see eventlog.h for the format
+ * @field int logThread, boolean, whether each log is written on a thread of its own
+ *  while the run goes on
+ * @field const char *checkpoint, NULL, or a file to keep a checkpoint of the run in,
+ *  replaced every checkpointEvery arrivals on a thread of its own, replications
+ *  must then be 1 and log NULL
+ * @field long checkpointEvery, the arrivals between checkpoints
+ * @field const char *restore, NULL, or a checkpoint to go on from, written by a run
+ *  of the same build with the same config, replications must then be 1 and log NULL
+ * @field const char *progress, NULL, or a shared memory name to publish a snapshot of
+ *  each replication to every few thousand arrivals, see progress.h and simwatch
+ */
+struct simConfig {
+    double lambda;
+    double mu;
+    int m;
+    long n;
+    uint64_t seed;
+    int engine;
+    int method;
+    int replications;
+    int threads;
+    double tolerance;
+    int stopOn;
+    int warmup;
+    int antithetic;
+    int control;
+    const struct simTrace *trace;
+    const char *log;
+    int logThread;
+    const char *checkpoint;
+    long checkpointEvery;
+    const char *restore;
+    const char *progress;
+};
+
+/*
+ * The results of a run
+ *
+ * @field struct analytic analytic, the a priori statistics
+ * @field struct results mean, the a posteriori statistics, averaged over the replications
+ * @field struct results halfWidth, the half-width of the 95% confidence interval
+ *  of each statistic, 0 with one replication
+ * @field struct results reduction, how many times smaller the variance of each mean
+ *  is than with independent replications, 1 without antithetic pairs or controls
+ * @field int replications, the number of replications run
+ * @field struct quantiles w, quantiles of the time spent in the system, over every
+ *  customer of every replication
+ * @field struct quantiles wq, quantiles of the time spent waiting in queue, likewise
+ * @field double pn[], the fraction of time with n in the system, averaged over
+ *  the replications, the last entry is n >= SIM_STATES - 1
+ * @field double analyticPn[], the a priori Pn for the same states,
+ *  all 0 where rho >= 1
+ * @field long customers, the customers served, over every replication
+ * @field double precision, the largest relative half-width any replication stopped at,
+ *  0 without a tolerance
+ * @field long truncated, the customers left out as warm-up, over every replication
+ * @field long logged, the customers written to the logs, over every replication,
+ *  fewer than customers if a log could not be written
+ * @field long restored, the arrivals the run was restored at, 0 if it was not restored,
+ *  -1 if the checkpoint changed after it was checked and the run started over
+ * @field long checkpoints, the checkpoints written
+ * @field long peakCustomers, the most customer records live at once in any replication
+ * @field long allocations, the most customer records allocated by any replication
+ * @field int published, boolean, whether snapshots were published to cfg->progress
+ * @field struct simProfile profile, where the event loop spent its time, over every
+ *  replication
+ */
+struct simResults {
+    struct analytic analytic;
+    struct results mean;
+    struct results halfWidth;
+    struct results reduction;
+    int replications;
+    struct quantiles w;
+    struct quantiles wq;
+    double pn[SIM_STATES];
+    double analyticPn[SIM_STATES];
+    long customers;
+    double precision;
+    long truncated;
+    long logged;
+    long restored;
+    long checkpoints;
+    long peakCustomers;
+    long allocations;
+    int published;
+    struct simProfile profile;
+};
+
+/*
+ * Waiting time targets for optimizeStaffing(), a target of 0 is not used
+ *
+ * @field double wq, the average time spent waiting in queue must be below this
+ * @field double pWait, the probability of having to wait must be below this
+ */
+struct staffingTarget {
+    double wq;
+    double pWait;
+};
+
+/*
+ * The answer of optimizeStaffing()
+ *
+ * @field int m, the fewest servers that meet the targets
+ * @field int analyticM, the fewest servers that meet them by Erlang C
+ * @field int confirmed, boolean, whether M-1 was shown to miss the targets,
+ *  rather than left undecided at the most replications
+ * @field int replications, the replications run over every M tried
+ * @field struct simResults res, the results for m
+ */
+struct staffingResult {
+    int m;
+    int analyticM;
+    int confirmed;
+    int replications;
+    struct simResults res;
+};
+
+/*
+ * The answer of compareServers()
+ *
+ * @field int m[], the two server counts
+ * @field int replications, the replications run of each
+ * @field struct results mean[], the mean of each statistic for each server count
+ * @field struct results difference, the mean of the first less the second
+ * @field struct results halfWidth, the half-width of the 95% confidence interval
+ *  of each difference
+ * @field struct results reduction, how many times smaller the variance of each
+ *  difference is than it would be with independent streams
+ */
+struct simComparison {
+    int m[2];
+    int replications;
+    struct results mean[2];
+    struct results difference;
+    struct results halfWidth;
+    struct results reduction;
+};
+
+/*
+ * A route of an open network
+ *
+ * @field int from, the station customers leave
+ * @field int to, the station they go on to
+ * @field double p, the fraction of the customers leaving from that go to to
+ */
+struct simRoute {
+    int from;
+    int to;
+    double p;
+};
+
+/*
+ * An open (Jackson) network of M/M/c stations, numbered from 0
+ * What is left of 1 once the routes from a station are taken away
+ * is the fraction of its customers that leave the network
+ *
+ * @field int stations, the number of stations
+ * @field const double *lambda, the arrival rate from outside at each station, 0 for none
+ * @field const double *mu, the service rate of each station
+ * @field const int *m, the number of servers of each station
+ * @field int routes, the number of routes
+ * @field const struct simRoute *route, the routes
+ */
+struct simNetwork {
+    int stations;
+    const double *lambda;
+    const double *mu;
+    const int *m;
+    int routes;
+    const struct simRoute *route;
+};
+
+/*
+ * The results of one station of a network
+ *
+ * @field double gamma, its arrival rate, from outside and routed, by the traffic equations
+ * @field struct analytic analytic, the a priori statistics, M/M/c at gamma
+ * @field struct results mean, the a posteriori statistics, averaged over the replications
+ * @field struct results halfWidth, the half-width of the 95% confidence interval
+ *  of each statistic, 0 with one replication
+ */
+struct simStation {
+    double gamma;
+    struct analytic analytic;
+    struct results mean;
+    struct results halfWidth;
+};
+
+/*
+ * The answer of simulateNetwork()
+ *
+ * @field int replications, the number of replications run
+ * @field long customers, the customers through the network, over every replication
+ * @field double lambda, the arrival rate from outside the network
+ * @field double w, double wHalfWidth, double analyticW, the average time in the network,
+ *  the half-width of its 95% confidence interval and its product form value
+ * @field double l, double lHalfWidth, double analyticL, the average number in the network, likewise
+ * @field double visits, double visitsHalfWidth, double analyticVisits, the average visits
+ *  to stations per customer, likewise
+ * @field long peakEvents, the most events in the future event set at once in any replication
+ * @field struct simStation *station, the results of each station, allocated by the caller
+ *  with one entry per station
+ */
+struct simNetworkResults {
+    int replications;
+    long customers;
+    double lambda;
+    double w;
+    double wHalfWidth;
+    double analyticW;
+    double l;
+    double lHalfWidth;
+    double analyticL;
+    double visits;
+    double visitsHalfWidth;
+    double analyticVisits;
+    long peakEvents;
+    struct simStation *station;
+};
+
+/*
+ * A session, a pool of threads kept warm across asynchronous runs
+ */
+struct simSession;
+/*
+ * A trace of recorded interarrival and service times, mapped into memory
+ */
+struct simTrace;
+
+/*
+ * A function to fill a config with the defaults: lambda 4, mu 3, M 2,
+ * N 5000, seed 1, binary heap, ziggurat, one replication, one thread
+ * per processor, no stopping rule, warm-up detection, variance reduction, trace, log,
+ * checkpoints or progress, checkpointEvery 10000000
+ *
+ * @param struct simConfig *cfg, the config to fill
+ */
+void defaultConfig(struct simConfig *cfg);
+/*
+ * A function to calculate a priori statistics for the simulation
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ *
+ * @return struct analytic, the statistics
+ */
+struct analytic preCalc(double lambda, double mu, int m);
+/*
+ * A function to run the simulation described by a config
+ *
+ * @param const struct simConfig *cfg, the run
+ * @param struct simResults *res, where to store the results
+ *
+ * @return int, 0, or -1 if the config is invalid or its checkpoint cannot be restored
+ */
+int simulate(const struct simConfig *cfg, struct simResults *res);
+/*
+ * A function to find the smallest number of servers that meets the
+ * targets. Erlang C gives a first guess, then M and M-1 are simulated,
+ * adding replications only while a 95% confidence interval straddles
+ * a target, moving M until M meets the targets and M-1 does not
+ * cfg->m is ignored, cfg->replications is the number each M starts with,
+ * no log or checkpoint is kept
+ *
+ * @param const struct simConfig *cfg, the run
+ * @param const struct staffingTarget *target, the targets
+ * @param struct staffingResult *out, where to store the result
+ *
+ * @return int, 0, 1 if no M up to 4 times the Erlang C answer meets
+ *  the targets, or -1 if the config or targets are invalid
+ */
+int optimizeStaffing(const struct simConfig *cfg, const struct staffingTarget *target, struct staffingResult *out);
+/*
+ * A function to compare cfg->m servers with m2 servers under common
+ * random numbers: replication r of both draws from the same arrival
+ * and service streams, and as service starts in arrival order the
+ * k-th customer has the same interarrival and service time in both,
+ * so the difference of each pair of replications is all that varies
+ *
+ * @param const struct simConfig *cfg, the run, cfg->replications pairs,
+ *  at least 2, antithetic and control are not used
+ * @param int m2, the other number of servers
+ * @param struct simComparison *out, where to store the comparison
+ *
+ * @return int, 0, or -1 if the config is invalid
+ */
+int compareServers(const struct simConfig *cfg, int m2, struct simComparison *out);
+/*
+ * A function to simulate an open (Jackson) network. Every station has
+ * its own servers, queue and streams and all share one future event
+ * set, so an event costs O(log events) however many stations there are
+ * Each station's a priori statistics are those of M/M/c at the arrival
+ * rate the traffic equations give it, as the product form promises
+ *
+ * @param const struct simConfig *cfg, the run, cfg->n arrivals from outside the
+ *  network, with its seed, engine, method, replications and threads; lambda, mu, m,
+ *  the stopping rule, warm-up, variance reduction, trace, log, checkpoints and
+ *  progress are not used
+ * @param const struct simNetwork *net, the network
+ * @param struct simNetworkResults *out, where to store the results, out->station
+ *  must hold net->stations entries
+ *
+ * @return int, 0, or -1 if the config or network is invalid, some
+ *  customers would never leave the network or a station would be unstable,
+ *  its gamma not below m mu
+ */
+int simulateNetwork(const struct simConfig *cfg, const struct simNetwork *net, struct simNetworkResults *out);
+/*
+ * A function to map a trace file, written by tracecvt, into memory
+ * It may be replayed by any number of runs at once
+ *
+ * @param const char *path, the trace file
+ *
+ * @return struct simTrace *, reference to the trace, or NULL with errno
+ *  set if the file cannot be mapped or is not a trace
+ */
+struct simTrace *openTrace(const char *path);
+/*
+ * A function to get the size and rates of a trace
+ *
+ * @param const struct simTrace *t, the trace
+ * @param double *lambda, where to store the arrival rate
+ * @param double *mu, where to store the service rate
+ *
+ * @return long, the number of customers
+ */
+long traceInfo(const struct simTrace *t, double *lambda, double *mu);
+/*
+ * A function to unmap a trace once no run is replaying it
+ *
+ * @param struct simTrace *t, the trace
+ *
+ * @return struct simTrace *, reference to the freed trace (NULL)
+ */
+struct simTrace *closeTrace(struct simTrace *t);
+/*
+ * A function to start a session, a pool of threads kept warm for
+ * any number of asynchronous runs
+ *
+ * @param int threads, the number of threads, 0 for one per processor
+ *
+ * @return struct simSession *, reference to the session
+ */
+struct simSession *newSession(int threads);
+/*
+ * A function to start the run described by a config on a session
+ * and return at once. Its replications are spread over the session's
+ * threads, cfg->threads is ignored. When the last one finishes, done
+ * is called on that thread with the results, which are only valid
+ * during the call
+ *
+ * @param struct simSession *s, the session
+ * @param const struct simConfig *cfg, the run, copied
+ * @param void (*done)(struct simResults *, void *), called with the results
+ * @param void *arg, passed to done
+ *
+ * @return int, 0, or -1 if the config is invalid or its checkpoint cannot be restored
+ */
+int simulateAsync(struct simSession *s, const struct simConfig *cfg,
+        void (*done)(struct simResults *, void *), void *arg);
+/*
+ * A function to wait until every run started on a session has finished
+ *
+ * @param struct simSession *s, the session
+ */
+void waitSession(struct simSession *s);
+/*
+ * A function to finish the runs of a session and free it
+ *
+ * @param struct simSession *s, the session
+ *
+ * @return struct simSession *, reference to the freed session (NULL)
+ */
+struct simSession *freeSession(struct simSession *s);
+
+#endif
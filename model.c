@@ -0,0 +1,638 @@
+/***************************************************************
+  Paul Lewis
+  File Name: model.c
+  Simulation
+
+  The M/M/c model: one run of arrivals and departures with a given
+  number of server nodes, and the a priori and a posteriori
+  statistics. All the state of a run is in struct simulation
+***************************************************************/
+
+#include "model.h"
+
+/*
+ * Where each statistic of struct results is, in order
+ */
+static const size_t resultOffsets[RESULT_STATS] = {
+    offsetof(struct results, po), offsetof(struct results, w), offsetof(struct results, wq),
+    offsetof(struct results, pWait), offsetof(struct results, l), offsetof(struct results, lq),
+    offsetof(struct results, utilization)
+};
+
+/*
+ * A function for generating a random time interval.
+ * Intervals are taken from a buffer that is refilled a batch at a time
+ * 
+ * @param struct variates *v, the buffer for either lambda or mu
+ *
+ * @return double, the time interval 
+ */
+double getNextRandomInterval(struct variates *v) {
+    return nextVariate(v);
+}
+#ifdef SIM_PROFILE
+/*
+ * A function for taking a time interval in a run, timed as a refill
+ * when it empties the batch and otherwise as a variate
+ *
+ * @param struct simulation *sim, the run
+ * @param struct variates *v, the buffer for either lambda or mu
+ *
+ * @local int phase, the phase it is timed as
+ * @local double x, the time interval
+ *
+ * @return double, the time interval
+ */
+static inline double takeInterval(struct simulation *sim, struct variates *v) {
+    int phase = v->next == VARIATE_BATCH ? SIM_PHASE_REFILL : SIM_PHASE_VARIATE;
+    double x;
+    PROFILE_BEGIN(t);
+    x = getNextRandomInterval(v);
+    PROFILE_END(&sim->prof, phase, t);
+    return x;
+}
+/*
+ * A function for scheduling an event in a run, timed
+ *
+ * @param struct simulation *sim, the run
+ * @param struct event ev, the event
+ */
+static inline void scheduleEvent(struct simulation *sim, struct event ev) {
+    PROFILE_BEGIN(t);
+    schedule(sim->es, ev);
+    PROFILE_END(&sim->prof, SIM_PHASE_EVENTSET, t);
+    PROFILE_PEAK(sim->prof.peakEvents, sim->es->theSize);
+}
+#else
+#define takeInterval(sim, v) getNextRandomInterval(v)
+#define scheduleEvent(sim, ev) schedule((sim)->es, ev)
+#endif
+/*
+ * A function for scheduling the next arrival into a priority queue
+ * Only one arrival is ever pending, each processed arrival schedules
+ * its successor, so the event set holds at most m+1 events
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @local struct event ev, the arrival event
+ */
+void generateArrivals(struct simulation *sim) {
+    struct event ev;
+    if(sim->numberOfCustomers < sim->n) {
+        sim->totalTime += takeInterval(sim, &sim->arrivals);   // keep track of absolute time
+        ev.time = sim->totalTime;
+        ev.id = newCustomer(sim->p, sim->totalTime, 1);
+        scheduleEvent(sim, ev);
+        sim->numberOfCustomers++;   // keep track of number of customers   
+    }
+}
+/*
+ * A function to pass one observed time to the stopping rule
+ * Once the batch means are precise enough no more arrivals are
+ * taken, and the customers already there are served. While the warm-up
+ * is still being looked for the run is not stopped
+ *
+ * @param struct simulation *sim, the run
+ * @param double x, the time
+ */
+static void observe(struct simulation *sim, double x) {
+    if(addBatchSample(&sim->batches, x) && sim->warmup != WARMUP_WATCHING
+            && batchPrecision(&sim->batches) < sim->tolerance)
+        sim->n = sim->numberOfCustomers;
+}
+/*
+ * A function to zero every statistic of a run
+ *
+ * @param struct simulation *sim, the run
+ */
+static void clearStatistics(struct simulation *sim) {
+    sim->totalServiceTime = 0.0;
+    sim->totalWaitTime = 0.0;
+    sim->numInQueue = 0;
+    sim->measured = 0;
+    sim->clock = 0.0;
+    sim->areaSystem = 0.0;
+    sim->areaQueue = 0.0;
+    memset(sim->stateTime, 0, sizeof(sim->stateTime));
+    clearHistogram(sim->wHist);
+    clearHistogram(sim->wqHist);
+    initBatchMeans(&sim->batches, BATCH_FIRST_SIZE);
+}
+/*
+ * A function to take the statistics of a run at a candidate truncation
+ * point of the warm-up detection, as the last customer before it starts
+ * service
+ *
+ * @param struct simulation *sim, the run
+ * @param struct warmupMark *mk, where to store the statistics
+ * @param double arrival, the arrival time of the customer starting service
+ */
+static void markWarmup(struct simulation *sim, struct warmupMark *mk, double arrival) {
+    mk->clock = sim->clock;
+    mk->arrival = arrival;
+    mk->totalServiceTime = sim->totalServiceTime;
+    mk->totalWaitTime = sim->totalWaitTime;
+    mk->areaSystem = sim->areaSystem;
+    mk->areaQueue = sim->areaQueue;
+    memcpy(mk->stateTime, sim->stateTime, sizeof(mk->stateTime));
+    mk->waited = sim->numInQueue - getSize(sim->q);    // those still waiting arrived after it
+}
+/*
+ * A function to take the warm-up out of every statistic at the candidate
+ * point it was found to end at. The statistics marked at that point are
+ * taken away, so the means, P(wait), L, Lq and Pn are those of the customers
+ * and the time after it. The quantiles and the stopping rule cannot be taken
+ * apart in bounded memory, so they restart from now
+ *
+ * @param struct simulation *sim, the run
+ * @param long cut, the customers to delete, a candidate point or 0
+ *
+ * @local struct warmupMark *mk, the statistics where the warm-up ended
+ * @local int i, a counter
+ */
+static void truncateWarmup(struct simulation *sim, long cut) {
+    struct warmupMark *mk;
+    int i;
+    sim->warmup = WARMUP_DONE;
+    if(cut == 0)                // every batch is kept
+        return;
+    for(i=0;sim->warmupMser.at[i]*MSER_SIZE != cut;i++)
+        ;
+    mk = &sim->warmupMarks[i];
+    sim->warmupTime = mk->clock;
+    sim->warmupArrival = mk->arrival;
+    sim->truncated = cut;
+    sim->measured -= cut;
+    sim->numInQueue -= mk->waited;
+    sim->totalServiceTime -= mk->totalServiceTime;
+    sim->totalWaitTime -= mk->totalWaitTime;
+    sim->areaSystem -= mk->areaSystem;
+    sim->areaQueue -= mk->areaQueue;
+    for(i=0;i<SIM_STATES;i++)
+        sim->stateTime[i] -= mk->stateTime[i];
+    clearHistogram(sim->wHist);
+    clearHistogram(sim->wqHist);
+    initBatchMeans(&sim->batches, BATCH_FIRST_SIZE);
+}
+/*
+ * A function to pass one waiting time to the warm-up detection, as
+ * the customer starts service after its statistics are counted
+ * The statistics are marked at every candidate point of MSER-5, and
+ * the warm-up is taken out at the first point past half of the n
+ * customers, so that MSER-5 sees the run rather than its transient.
+ * The waits of a start from empty lie within the spread of those that
+ * follow, so MSER-5 alone seldom deletes them: the warm-up is cut at the
+ * later of its point and the first candidate past the relaxation time,
+ * but never past half of what was batched
+ *
+ * @param struct simulation *sim, the run
+ * @param double x, the time waited in queue
+ * @param double arrival, the arrival time of the customer
+ *
+ * @local struct mser *m, the rule
+ * @local long cut, the customers to delete
+ * @local long point, a candidate point, in customers
+ * @local int i, a counter
+ */
+static void watchWarmup(struct simulation *sim, double x, double arrival) {
+    struct mser *m = &sim->warmupMser;
+    long cut, point;
+    int i;
+    if(!addMserSample(m, x))
+        return;
+    markWarmup(sim, &sim->warmupMarks[m->marks - 1], arrival);
+    if(2*m->batches*MSER_SIZE < sim->n)
+        return;
+    cut = mserTruncation(m);    // -1 if its point is past half, when the relaxation time is all there is
+    for(i=0;i<m->marks && sim->relaxation > 0 && 2*m->at[i] <= m->batches;i++) {
+        point = m->at[i]*MSER_SIZE;
+        if(point > cut)
+            cut = point;
+        if(point >= sim->relaxation)
+            break;
+    }
+    truncateWarmup(sim, cut < 0 ? 0 : cut);
+}
+/* 
+ * A function for processing the next event in the priority queue
+ * May be an arrival or a departure. May need to put an arrival
+ * in a FIFO queue. In profiled builds the event set, the queue,
+ * the intervals and the handling of each event are timed
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @local double temp, a random interval
+ * @local double temp2, the difference between start of service time and arrival time
+ * @local double dt, the time since the previous event
+ * @local struct event event, the event to process
+ * @local struct customerPool *p, the pool holding the customer columns
+ * @local int c, the customer the event belongs to
+ * @local int cust, a customer to process from FIFO queue
+ * @local int waiting, the number waiting in queue until this event
+ * @local int inSystem, the number in the system until this event
+ * @local uint64_t t, handling, fifo, the cycle counts phases started at, when profiled
+ */
+void processNextEvent(struct simulation *sim) {
+    double temp, temp2, dt;
+    struct event event;
+    struct customerPool *p = sim->p;
+    int c, cust, waiting, inSystem;
+    PROFILE_BEGIN(t);
+    event = nextEvent(sim->es);         // get next event from priority queue
+    PROFILE_END(&sim->prof, SIM_PHASE_EVENTSET, t);
+    PROFILE_BEGIN(handling);
+    c = event.id;
+    waiting = getSize(sim->q);          // advance the time-weighted statistics to this event
+    inSystem = sim->m - sim->serviceAvailable + waiting;
+    dt = event.time - sim->clock;
+    sim->areaSystem += inSystem * dt;
+    sim->areaQueue += waiting * dt;
+    sim->stateTime[inSystem < SIM_STATES - 1 ? inSystem : SIM_STATES - 1] += dt;
+    sim->clock = event.time;
+    if(p->departureTime[c] < 0) {       // if arrival
+        generateArrivals(sim);          // schedule the next arrival
+        sim->measured++;
+        if(sim->serviceAvailable > 0) {
+            sim->serviceAvailable--;
+            p->startOfServiceTime[c] = p->arrivalTime[c];
+            recordValue(sim->wqHist, 0.0);  // served without waiting
+            if(sim->stopOn == SIM_STOP_WQ)
+                observe(sim, 0.0);
+            temp = takeInterval(sim, &sim->services);
+            sim->totalServiceTime += temp;  // keep track of total service time
+            if(sim->warmup == WARMUP_WATCHING)
+                watchWarmup(sim, 0.0, p->arrivalTime[c]);
+            p->departureTime[c] = p->arrivalTime[c] + temp;
+            if(sim->log != NULL)
+                logCustomer(sim->log, p->arrivalTime[c], p->startOfServiceTime[c], p->departureTime[c]);
+            event.time = p->departureTime[c];
+            scheduleEvent(sim, event);  // add event back to priority queue as departure event
+        } else {
+            PROFILE_BEGIN(fifo);
+            enqueue(sim->q,c);          // place in FIFO queue
+            PROFILE_END(&sim->prof, SIM_PHASE_FIFO, fifo);
+            PROFILE_PEAK(sim->prof.peakQueue, sim->q->size);
+            sim->numInQueue++;          // keep track of number of customers going into FIFO queue
+        }
+        PROFILE_END(&sim->prof, SIM_PHASE_ARRIVAL, handling);
+    } else {
+        if(p->arrivalTime[c] > sim->warmupArrival) {    // customers from the warm-up are not counted
+            recordValue(sim->wHist, p->departureTime[c] - p->arrivalTime[c]);
+            if(sim->stopOn == SIM_STOP_W)
+                observe(sim, p->departureTime[c] - p->arrivalTime[c]);
+        }
+        sim->serviceAvailable++;
+        if(waiting > 0) {       // check if customer in FIFO queue
+            PROFILE_BEGIN(fifo);
+            cust = dequeue(sim->q);     // get next customer in FIFO queue
+            PROFILE_END(&sim->prof, SIM_PHASE_FIFO, fifo);
+            p->startOfServiceTime[cust] = event.time;
+            temp = takeInterval(sim, &sim->services);
+            temp2 = p->startOfServiceTime[cust] - p->arrivalTime[cust];
+            if(p->arrivalTime[cust] > sim->warmupArrival) {
+                sim->totalServiceTime += temp;  // keep track of total service time
+                sim->totalWaitTime += temp2;    // keep track of total wait time
+                recordValue(sim->wqHist, temp2);
+                if(sim->stopOn == SIM_STOP_WQ)
+                    observe(sim, temp2);
+            }
+            if(sim->warmup == WARMUP_WATCHING)
+                watchWarmup(sim, temp2, p->arrivalTime[cust]);
+            p->departureTime[cust] = p->startOfServiceTime[cust] + temp;
+            if(sim->log != NULL)
+                logCustomer(sim->log, p->arrivalTime[cust], p->startOfServiceTime[cust], p->departureTime[cust]);
+            event.time = p->departureTime[cust];
+            event.id = cust;
+            scheduleEvent(sim, event);  // add event back to priority queue as departure event
+            sim->serviceAvailable--;
+        }
+        freeCustomer(p, c);             // return customer to the pool
+        PROFILE_END(&sim->prof, SIM_PHASE_DEPARTURE, handling);
+    }
+}
+/*
+ * A function to allocate and initialize a run
+ * Replication rep draws from its own arrival and service streams
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
+ * @param int engine, the future event set engine, one of the EVENTSET_ values
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication
+ *
+ * @local struct simulation *sim, the new run
+ *
+ * @return struct simulation *, reference to the run
+ */
+struct simulation *newSimulation(double lambda, double mu, int m, long n, int engine, int method, uint64_t seed, int rep) {
+    struct simulation *sim = (struct simulation *) malloc(sizeof(struct simulation));
+    if(sim == NULL) {
+        perror("malloc error. cannot create simulation.\n");
+        exit(1);
+    }
+    sim->es = NULL;
+    sim->q = newQueue();                // create FIFO queue
+    sim->p = newPool();                 // create customer pool
+    sim->wHist = newHistogram();
+    sim->wqHist = newHistogram();
+    sim->next = NULL;
+    resetSimulation(sim, lambda, mu, m, n, engine, method, seed, rep);
+    return sim;
+}
+/*
+ * A function to set up a run for another set of values
+ * The FIFO queue and customer pool of the last run are kept with
+ * the capacity they grew to, the histograms are emptied and the
+ * event set is made afresh
+ *
+ * @param struct simulation *sim, the run
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
+ * @param int engine, the future event set engine, one of the EVENTSET_ values
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication
+ *
+ * @local struct rng r, used to seed the streams
+ */
+void resetSimulation(struct simulation *sim, double lambda, double mu, int m, long n, int engine, int method, uint64_t seed, int rep) {
+    struct rng r;
+    sim->lambda = lambda;
+    sim->mu = mu;
+    sim->m = m;
+    sim->n = n;
+    if(sim->es != NULL)
+        freeEventSet(sim->es);
+    sim->es = newEventSet(engine);      // create priority queue
+    sim->q->size = 0;
+    sim->q->head = 0;
+    resetPool(sim->p);
+    seedStream(&r, seed, rep, RNG_STREAM_ARRIVALS);
+    initVariates(&sim->arrivals, &r, lambda, method);
+    seedStream(&r, seed, rep, RNG_STREAM_SERVICES);
+    initVariates(&sim->services, &r, mu, method);
+    /* initialize statistics */
+    sim->totalTime = 0.0;
+    sim->stopOn = SIM_STOP_NONE;
+    sim->tolerance = 0.0;
+    sim->warmup = WARMUP_OFF;
+    sim->warmupTime = 0.0;
+    sim->warmupArrival = -1.0;
+    sim->truncated = 0;
+    sim->relaxation = 0;
+    sim->log = NULL;
+    sim->ckpt = NULL;
+    sim->nextCheckpoint = LONG_MAX;
+    sim->progress.slot = NULL;
+    sim->nextProgress = LONG_MAX;
+    memset(&sim->prof, 0, sizeof(sim->prof));
+    sim->prof.enabled = PROFILE_ENABLED;
+    clearStatistics(sim);
+    sim->serviceAvailable = m;
+    sim->numberOfCustomers = 0;
+}
+/*
+ * A function to make a run stop once a time is known precisely enough,
+ * rather than after n customers, which becomes the most it may take
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param int stopOn, the time to watch, SIM_STOP_WQ or SIM_STOP_W
+ * @param double tolerance, the relative 95% half-width to reach, 0 for no rule
+ */
+static void stopAtPrecision(struct simulation *sim, int stopOn, double tolerance) {
+    sim->stopOn = tolerance > 0 ? stopOn : SIM_STOP_NONE;
+    sim->tolerance = tolerance;
+}
+/*
+ * A function to make a run find the end of its warm-up with MSER-5 on
+ * the times waited in queue, and leave the warm-up out of its statistics
+ * The relaxation time from empty is that of the queue above M, a birth
+ * and death process of rates lambda and M mu, 1/(sqrt(M mu) - sqrt(lambda))^2
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param int on, boolean, whether to look for the warm-up
+ *
+ * @local double gap, sqrt(M mu) - sqrt(lambda)
+ */
+static void detectWarmup(struct simulation *sim, int on) {
+    double gap = sqrt(sim->m*sim->mu) - sqrt(sim->lambda);
+    sim->warmup = on ? WARMUP_WATCHING : WARMUP_OFF;
+    sim->relaxation = gap > 0 ? (long) fmin(sim->lambda/(gap*gap), (double) sim->n) : sim->n;
+    initMser(&sim->warmupMser);
+}
+/*
+ * A function to give replication rep of an antithetic pair its streams
+ * Replications 2k and 2k+1 both draw from the streams of replication k,
+ * by inversion, and the odd one uses 1-U for every U the even one uses
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication
+ *
+ * @local struct rng r, the stream being seeded
+ * @local int method, the variate method of this half of the pair
+ */
+static void pairStreams(struct simulation *sim, uint64_t seed, int rep) {
+    struct rng r;
+    int method = rep % 2 ? VARIATE_ANTITHETIC : VARIATE_INVERSION;
+    seedStream(&r, seed, rep/2, RNG_STREAM_ARRIVALS);
+    initVariates(&sim->arrivals, &r, sim->lambda, method);
+    seedStream(&r, seed, rep/2, RNG_STREAM_SERVICES);
+    initVariates(&sim->services, &r, sim->mu, method);
+}
+/*
+ * A function to make replication rep replay a trace: n customers from
+ * record rep*n onwards, wrapping to the start past the last record
+ * Customers start service in the order they arrive, so the k-th
+ * service time goes to the k-th arrival as it did in the trace
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simTrace *t, the trace
+ * @param int rep, the replication
+ *
+ * @local long start, the first record replayed
+ */
+static void replayTrace(struct simulation *sim, const struct simTrace *t, int rep) {
+    long start = (long) ((unsigned long) rep * (unsigned long) sim->n % (unsigned long) t->records);
+    initTraceVariates(&sim->arrivals, t->gaps, t->records, start);
+    initTraceVariates(&sim->services, t->services, t->records, start);
+}
+/*
+ * A function to set up the options of a config on a new or reset run
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simConfig *cfg, the config
+ * @param int rep, the replication
+ */
+void applyConfig(struct simulation *sim, const struct simConfig *cfg, int rep) {
+    stopAtPrecision(sim, cfg->stopOn, cfg->tolerance);
+    detectWarmup(sim, cfg->warmup);
+    if(cfg->antithetic)
+        pairStreams(sim, cfg->seed, rep);
+    if(cfg->trace != NULL)
+        replayTrace(sim, cfg->trace, rep);
+}
+/*
+ * A function to get the precision a finished run reached
+ *
+ * @param struct simulation *sim, the finished run
+ *
+ * @return double, the relative 95% half-width of the watched time,
+ *  0 without a stopping rule
+ */
+double runPrecision(struct simulation *sim) {
+    if(sim->stopOn == SIM_STOP_NONE)
+        return 0.0;
+    return batchPrecision(&sim->batches);
+}
+/*
+ * A function to call other functions to run the simulation
+ * A run restored from a checkpoint goes on from where it was, and
+ * checkpoints are taken and snapshots published between events once
+ * enough customers arrived
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @local uint64_t t, the cycle count the run started at, when profiled
+ */
+void runSimulation(struct simulation *sim) {
+    PROFILE_BEGIN(t);
+    if(sim->numberOfCustomers == 0)
+        generateArrivals(sim);          // schedule first arrival
+    while(!isEmptyEventSet(sim->es)) {
+        processNextEvent(sim);          // process events
+        if(sim->numberOfCustomers >= sim->nextCheckpoint)
+            takeCheckpoint(sim);
+        if(sim->numberOfCustomers >= sim->nextProgress)
+            publishProgress(sim);
+    }
+    PROFILE_END(&sim->prof, SIM_PHASE_RUN, t);
+}
+/*
+ * A function to free a run
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @return struct simulation *, reference to the freed run (NULL)
+ */
+struct simulation *freeSimulation(struct simulation *sim) {
+    freeEventSet(sim->es);  // free memory of priority queue
+    freeFIFOqueue(sim->q);  // free memory of FIFO queue
+    freePool(sim->p);       // free memory of every customer
+    freeHistogram(sim->wHist);
+    freeHistogram(sim->wqHist);
+    free(sim);
+    sim = NULL;
+    return sim;
+}
+/*
+ * A function to calculate a priori statistics for the simulation
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ *
+ * @return struct analytic, the statistics
+ */
+struct analytic preCalc(double lambda, double mu, int m) {
+    return erlangC(lambda, mu, m);
+}
+/*
+ * A function to calculate a posteriori statistics for the simulation
+ *
+ * @param struct simulation *sim, the finished run
+ *
+ * @local struct results r, the statistics
+ * @local double span, the time measured, after the warm-up
+ *
+ * @return struct results, the statistics
+ */
+struct results postCalc(struct simulation *sim) {
+    struct results r;
+    double span = sim->clock - sim->warmupTime;
+    r.po = sim->stateTime[0]/span;
+    r.w = (sim->totalWaitTime + sim->totalServiceTime)/(double)sim->measured;
+    r.wq = sim->totalWaitTime/(double)sim->measured;
+    r.pWait = sim->numInQueue/(double)sim->measured;
+    r.l = sim->areaSystem/span;
+    r.lq = sim->areaQueue/span;
+    r.utilization = (sim->areaSystem - sim->areaQueue)/(sim->m * span);  // the servers are identical, counted not named
+    return r;
+}
+/*
+ * A function to get one of the statistics of struct results by number,
+ * so that every statistic can be summarized in a loop
+ *
+ * @param struct results *r, the statistics
+ * @param int i, the statistic, 0 to RESULT_STATS - 1 in the order of the struct
+ *
+ * @return double *, the statistic
+ */
+double *resultStat(struct results *r, int i) {
+    return (double *) ((char *) r + resultOffsets[i]);
+}
+/*
+ * A function to get the fraction of time a finished run spent with
+ * each number in the system
+ *
+ * @param struct simulation *sim, the finished run
+ * @param double *pn, where to store SIM_STATES fractions
+ *
+ * @local int i, a counter
+ */
+void fillStates(struct simulation *sim, double *pn) {
+    int i;
+    for(i=0;i<SIM_STATES;i++)
+        pn[i] = sim->stateTime[i]/(sim->clock - sim->warmupTime);
+}
+/*
+ * A function to get the control variates of a finished run: its mean
+ * service time and mean interarrival time, less their known means
+ * Only customers after the warm-up count, so the interarrival times are
+ * taken from the arrival of the last customer discarded with it
+ *
+ * @param struct simulation *sim, the finished run
+ * @param double *c, where to store the two controls
+ */
+void fillControls(struct simulation *sim, double *c) {
+    c[0] = sim->totalServiceTime/sim->measured - 1.0/sim->mu;
+    c[1] = (sim->totalTime - (sim->truncated > 0 ? sim->warmupArrival : 0.0))/sim->measured - 1.0/sim->lambda;
+}
+/*
+ * A function to read the quantiles reported for a time from its histogram
+ *
+ * @param struct quantiles *q, where to store the quantiles
+ * @param const struct histogram *h, the histogram
+ */
+void fillQuantiles(struct quantiles *q, const struct histogram *h) {
+    q->p95 = histogramQuantile(h, 0.95);
+    q->p99 = histogramQuantile(h, 0.99);
+    q->p999 = histogramQuantile(h, 0.999);
+}
+/*
+ * A function to check that a config describes a run
+ *
+ * @param const struct simConfig *cfg, the config
+ *
+ * @return int, boolean, whether the config is valid
+ */
+int validConfig(const struct simConfig *cfg) {
+    return cfg->lambda > 0 && cfg->mu > 0 && cfg->m > 0 && cfg->n > 0
+        && cfg->engine >= 0 && cfg->engine < EVENTSET_ENGINES
+        && (cfg->method == VARIATE_ZIGGURAT || cfg->method == VARIATE_INVERSION)
+        && cfg->replications > 0 && cfg->threads >= 0
+        && cfg->tolerance >= 0 && (cfg->stopOn == SIM_STOP_WQ || cfg->stopOn == SIM_STOP_W)
+        && (cfg->warmup == 0 || cfg->warmup == 1)
+        && (cfg->antithetic == 0 || (cfg->antithetic == 1 && cfg->replications % 2 == 0))
+        && (cfg->control == 0 || (cfg->control == 1
+            && cfg->replications / (cfg->antithetic ? 2 : 1) >= SIM_CONTROL_UNITS))
+        && (cfg->trace == NULL || (cfg->antithetic == 0 && cfg->control == 0))
+        && (cfg->logThread == 0 || cfg->logThread == 1)
+        && ((cfg->checkpoint == NULL && cfg->restore == NULL) || (cfg->replications == 1 && cfg->log == NULL))
+        && (cfg->checkpoint == NULL || cfg->checkpointEvery > 0);
+}
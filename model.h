@@ -0,0 +1,252 @@
+/***************************************************************
+  Paul Lewis
+  File Name: model.h
+  Simulation
+
+  Contains struct definitions, function prototypes, and #includes for model.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <math.h>
+#include <errno.h>
+#include <string.h>
+#include <stddef.h>
+#include <limits.h>
+#include "libsimulation.h"
+#include "customer.h"
+#include "eventset.h"
+#include "FIFOqueue.h"
+#include "rng.h"
+#include "variate.h"
+#include "erlang.h"
+#include "histogram.h"
+#include "stats.h"
+#include "trace.h"
+#include "eventlog.h"
+#include "checkpoint.h"
+#include "profile.h"
+#include "progress.h"
+
+#ifndef _model_h
+#define _model_h
+
+#define SIM_STOP_NONE -1    // no stopping rule, every one of n customers is served
+
+#define RESULT_STATS 7      // the statistics in struct results
+
+#define WARMUP_OFF 0        // every customer is measured
+#define WARMUP_WATCHING 1   // the end of the warm-up has not been found yet
+#define WARMUP_DONE 2       // it has, and the warm-up has been taken out of the statistics
+
+/*
+ * The statistics of a run at a candidate truncation point of the warm-up
+ * detection, taken as the last customer before it starts service. Customers
+ * start service in the order they arrive, so the statistics less these
+ * are exactly those of the customers after the batch
+ *
+ * @field double clock, the time
+ * @field double arrival, the arrival time of that customer
+ * @field double totalServiceTime, double totalWaitTime, of the customers up to here
+ * @field double areaSystem, double areaQueue, double stateTime[], the time-weighted statistics up to clock
+ * @field long waited, the customers up to here that had to wait
+ */
+struct warmupMark {
+    double clock;
+    double arrival;
+    double totalServiceTime;
+    double totalWaitTime;
+    double areaSystem;
+    double areaQueue;
+    double stateTime[SIM_STATES];
+    long waited;
+};
+
+/*
+ * The state of one run of the simulation, everything a run touches lives
+ * here so that several runs may proceed at once on different threads
+ */
+struct simulation {
+    double lambda;                  // the average number of arrivals per time unit
+    double mu;                      // the average number of customers to service per time unit
+    int m;                          // the number of servers
+    long n;                         // total number of arrivals to service, lowered by the stopping rule
+    struct eventSet *es;            // the priority queue
+    struct FIFOqueue *q;            // the FIFO queue
+    struct customerPool *p;         // the customer columns
+    struct variates arrivals;       // interarrival times
+    struct variates services;       // service times
+    double totalTime;               // time of the latest arrival
+    double totalServiceTime;
+    double totalWaitTime;
+    double clock;                   // time of the latest event
+    double areaSystem;              // number in the system integrated over time
+    double areaQueue;               // number waiting in queue integrated over time
+    double stateTime[SIM_STATES];   // time spent with n in the system
+    int serviceAvailable;           // number of free servers
+    long numberOfCustomers;         // arrivals generated so far
+    long numInQueue;                // arrivals that had to wait
+    long measured;                  // arrivals counted in the statistics, those after the warm-up
+    struct histogram *wHist;        // time each customer spent in the system
+    struct histogram *wqHist;       // time each customer waited in queue
+    int stopOn;                     // the time the stopping rule watches, or SIM_STOP_NONE
+    double tolerance;               // the relative half-width it stops at
+    struct batchMeans batches;      // batch means of that time
+    int warmup;                     // one of the WARMUP_ values
+    double warmupTime;              // when the warm-up ended, 0 if none was discarded
+    double warmupArrival;           // arrival time of the last customer discarded with it, -1 if none was
+    long truncated;                 // arrivals discarded with the warm-up
+    long relaxation;                // the a priori relaxation time from empty, in arrivals, the fewest discarded
+    struct mser warmupMser;         // waiting times for MSER-5
+    struct warmupMark warmupMarks[MSER_MARKS];      // the statistics at each of its candidate points
+    struct eventLog *log;           // where each customer is written as service starts, or NULL
+    struct checkpointer *ckpt;      // the checkpoints taken of the run, or NULL
+    long nextCheckpoint;            // the arrivals at which the next is taken, LONG_MAX if none
+    struct simProfile prof;         // where the event loop spent its time, with SIM_PROFILE
+    struct progressWriter progress; // where snapshots of the run are published
+    long nextProgress;              // the arrivals at which the next is published, LONG_MAX if none
+    struct simulation *next;        // links runs kept for reuse
+};
+
+/*
+ * A function for generating a random time interval.
+ * Intervals are taken from a buffer that is refilled a batch at a time
+ * 
+ * @param struct variates *v, the buffer for either lambda or mu
+ *
+ * @return double, the time interval 
+ */
+double getNextRandomInterval(struct variates *v);
+/*
+ * A function for scheduling the next arrival into a priority queue
+ * Only one arrival is ever pending, each processed arrival schedules
+ * its successor, so the event set holds at most m+1 events
+ *
+ * @param struct simulation *sim, the run
+ */
+void generateArrivals(struct simulation *sim);
+/* 
+ * A function for processing the next event in the priority queue
+ * May be an arrival or a departure. May need to put an arrival
+ * in a FIFO queue
+ *
+ * @param struct simulation *sim, the run
+ */
+void processNextEvent(struct simulation *sim);
+/*
+ * A function to allocate and initialize a run
+ * Replication rep draws from its own arrival and service streams
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
+ * @param int engine, the future event set engine, one of the EVENTSET_ values
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication
+ *
+ * @return struct simulation *, reference to the run
+ */
+struct simulation *newSimulation(double lambda, double mu, int m, long n, int engine, int method, uint64_t seed, int rep);
+/*
+ * A function to set up a run for another set of values
+ * The FIFO queue and customer pool of the last run are kept with
+ * the capacity they grew to, the histograms are emptied and the
+ * event set is made afresh
+ *
+ * @param struct simulation *sim, the run
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
+ * @param int engine, the future event set engine, one of the EVENTSET_ values
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param uint64_t seed, the seed
+ * @param int rep, the replication
+ */
+void resetSimulation(struct simulation *sim, double lambda, double mu, int m, long n, int engine, int method, uint64_t seed, int rep);
+/*
+ * A function to set up the options of a config on a new or reset run:
+ * the stopping rule, warm-up detection and antithetic streams
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simConfig *cfg, the config
+ * @param int rep, the replication
+ */
+void applyConfig(struct simulation *sim, const struct simConfig *cfg, int rep);
+/*
+ * A function to get the precision a finished run reached
+ *
+ * @param struct simulation *sim, the finished run
+ *
+ * @return double, the relative 95% half-width of the watched time,
+ *  0 without a stopping rule
+ */
+double runPrecision(struct simulation *sim);
+/*
+ * A function to call other functions to run the simulation
+ * A run restored from a checkpoint goes on from where it was
+ *
+ * @param struct simulation *sim, the run
+ */
+void runSimulation(struct simulation *sim);
+/*
+ * A function to free a run
+ *
+ * @param struct simulation *sim, the run
+ *
+ * @return struct simulation *, reference to the freed run (NULL)
+ */
+struct simulation *freeSimulation(struct simulation *sim);
+/*
+ * A function to calculate a posteriori statistics for the simulation
+ *
+ * @param struct simulation *sim, the finished run
+ *
+ * @return struct results, the statistics
+ */
+struct results postCalc(struct simulation *sim);
+/*
+ * A function to get one of the statistics of struct results by number,
+ * so that every statistic can be summarized in a loop
+ *
+ * @param struct results *r, the statistics
+ * @param int i, the statistic, 0 to RESULT_STATS - 1 in the order of the struct
+ *
+ * @return double *, the statistic
+ */
+double *resultStat(struct results *r, int i);
+/*
+ * A function to get the fraction of time a finished run spent with
+ * each number in the system
+ *
+ * @param struct simulation *sim, the finished run
+ * @param double *pn, where to store SIM_STATES fractions
+ */
+void fillStates(struct simulation *sim, double *pn);
+/*
+ * A function to get the control variates of a finished run: its mean
+ * service time and mean interarrival time, less their known means
+ *
+ * @param struct simulation *sim, the finished run
+ * @param double *c, where to store the two controls
+ */
+void fillControls(struct simulation *sim, double *c);
+/*
+ * A function to read the quantiles reported for a time from its histogram
+ *
+ * @param struct quantiles *q, where to store the quantiles
+ * @param const struct histogram *h, the histogram
+ */
+void fillQuantiles(struct quantiles *q, const struct histogram *h);
+/*
+ * A function to check that a config describes a run
+ *
+ * @param const struct simConfig *cfg, the config
+ *
+ * @return int, boolean, whether the config is valid
+ */
+int validConfig(const struct simConfig *cfg);
+
+#endif
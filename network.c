@@ -0,0 +1,194 @@
+/***************************************************************
+  Paul Lewis
+  File Name: network.c
+  Simulation
+
+  Runs an open network of stations read from a file, such as a
+  chain of front end, application and database pools with
+  retries routed back, and prints every station and the network
+  as a whole next to the values the product form gives them
+***************************************************************/
+
+#include "simulation.h"
+
+/*
+ * The size of the buffer for a line of a network file
+ */
+#define NETWORK_LINE 256
+
+/*
+ * A function to read the next line of a network file that is not
+ * blank or a comment
+ *
+ * @param char *line, the buffer
+ * @param int size, the size of the buffer
+ * @param FILE *fp, the file
+ *
+ * @local char *c, the first character that is not a space
+ *
+ * @return char *, the line, NULL at the end of the file
+ */
+static char *nextLine(char *line, int size, FILE *fp) {
+    char *c;
+    while(fgets(line, size, fp) != NULL) {
+        for(c=line;*c==' ' || *c=='\t';c++)
+            ;
+        if(*c != '#' && *c != '\n' && *c != '\r' && *c != '\0')
+            return line;
+    }
+    return NULL;
+}
+/*
+ * A function to stop with a message about a network file
+ *
+ * @param const char *file, the file
+ * @param const char *message, what is wrong with it
+ */
+static void badNetwork(const char *file, const char *message) {
+    fprintf(stderr, "%s: %s\n", file, message);
+    exit(1);
+}
+/*
+ * A function to print one end to end statistic of a network, with its
+ * 95% confidence half-width when there are several replications
+ *
+ * @param const char *name, the statistic
+ * @param double mean, its mean over the replications
+ * @param double halfWidth, its half-width
+ * @param double analytic, its product form value
+ * @param int replications, the number of replications
+ */
+static void printEndToEnd(const char *name, double mean, double halfWidth, double analytic, int replications) {
+    if(replications > 1)
+        printf("%s = %5.4f +/- %5.4f, a priori %5.4f\n", name, mean, halfWidth, analytic);
+    else
+        printf("%s = %5.4f, a priori %5.4f\n", name, mean, analytic);
+}
+/*
+ * A function to simulate an open network of stations read from a file
+ * and print each station's and the end to end statistics against their
+ * product form values
+ * The file holds a line "stations N [seed]", then a line "lambda mu M"
+ * for each station, lambda being its arrivals from outside the network,
+ * then any number of routes "from to p", stations numbered from 1.
+ * Blank lines and lines starting with # are skipped
+ *
+ * @param const char *file, the file holding the network
+ * @param const struct simConfig *base, the engine, method, replications and
+ *  threads the network is run with
+ *
+ * @local int i, a counter
+ * @local int k, the number of stations
+ * @local int capacity, the routes the route array can hold
+ * @local long n, the arrivals from outside the network
+ * @local int fields, the values read from a line
+ * @local char line[], the buffer for reading the file
+ * @local unsigned long long seed, the seed
+ * @local FILE *fp, the network file
+ * @local double *lambda, *mu, the rates of each station
+ * @local int *m, the servers of each station
+ * @local struct simRoute *route, the routes
+ * @local struct simNetwork net, the network
+ * @local struct simConfig cfg, the run
+ * @local struct simNetworkResults out, the results
+ * @local struct simStation *st, a station's results
+ */
+void runNetworkFile(const char *file, const struct simConfig *base) {
+    int i, k, capacity = 16, fields;
+    long n;
+    char line[NETWORK_LINE];
+    unsigned long long seed;
+    FILE *fp;
+    double *lambda, *mu;
+    int *m;
+    struct simRoute *route;
+    struct simNetwork net;
+    struct simConfig cfg = *base;
+    struct simNetworkResults out;
+    struct simStation *st;
+
+    fp = fopen(file, "r");
+    if(fp == NULL) {
+        perror("Unable to open network file\n");
+        exit(1);
+    }
+    if(nextLine(line, sizeof(line), fp) == NULL
+            || (fields = sscanf(line, "%d %ld %llu", &k, &n, &seed)) < 2 || k <= 0 || n <= 0)
+        badNetwork(file, "the first line must hold the number of stations and N, and optionally a seed");
+    if(fields < 3)
+        seed = (unsigned long long) time(0);
+    lambda = (double *) malloc(k * sizeof(double));
+    mu = (double *) malloc(k * sizeof(double));
+    m = (int *) malloc(k * sizeof(int));
+    route = (struct simRoute *) malloc(capacity * sizeof(struct simRoute));
+    out.station = (struct simStation *) malloc(k * sizeof(struct simStation));
+    if(lambda == NULL || mu == NULL || m == NULL || route == NULL || out.station == NULL) {
+        perror("malloc error. cannot create network.\n");
+        exit(1);
+    }
+    for(i=0;i<k;i++) {
+        if(nextLine(line, sizeof(line), fp) == NULL || sscanf(line, "%lf %lf %d", &lambda[i], &mu[i], &m[i]) != 3)
+            badNetwork(file, "each station needs a line \"lambda mu M\"");
+    }
+    net.routes = 0;
+    while(nextLine(line, sizeof(line), fp) != NULL) {
+        if(net.routes == capacity) {
+            capacity *= 2;
+            route = (struct simRoute *) realloc(route, capacity * sizeof(struct simRoute));
+            if(route == NULL) {
+                perror("malloc error. cannot grow network.\n");
+                exit(1);
+            }
+        }
+        if(sscanf(line, "%d %d %lf", &route[net.routes].from, &route[net.routes].to, &route[net.routes].p) != 3)
+            badNetwork(file, "each route needs a line \"from to p\"");
+        route[net.routes].from--;       // numbered from 0 in the library
+        route[net.routes].to--;
+        net.routes++;
+    }
+    fclose(fp);
+    net.stations = k;
+    net.lambda = lambda;
+    net.mu = mu;
+    net.m = m;
+    net.route = route;
+
+    cfg.n = n;
+    cfg.seed = seed;
+    if(simulateNetwork(&cfg, &net, &out) != 0) {
+        fprintf(stderr, "%s: mu and M must be positive and lambda at least 0 but not all 0, routes must join stations 1 to %d\n"
+            "with p from 0 to 1 and at most 1 in all from a station, every customer must be able to leave,\n"
+            "and every station must be stable, its gamma below M mu\n",
+            file, k);
+        exit(1);
+    }
+    printf("\nseed = %llu\n", seed);
+    printf("network = %s, %d stations, %d routes, lambda = %g, N = %ld\n", file, k, net.routes, out.lambda, n);
+    printf("\nPrinting each station, a priori (product form) and a posteriori over %d replication%s...\n\n",
+        out.replications, out.replications > 1 ? "s" : "");
+    printf("%7s %9s %9s %9s %5s %7s %7s %9s %9s %9s %9s ", "station", "lambda", "gamma", "mu", "M",
+        "Rho", "simRho", "L", "simL", "W", "simW");
+    if(out.replications > 1)
+        printf("%9s ", "+/-");
+    printf("%9s %9s\n", "Wq", "simWq");
+    for(i=0;i<k;i++) {
+        st = &out.station[i];
+        printf("%7d %9g %9.4f %9g %5d %7.4f %7.4f %9.4f %9.4f %9.4f %9.4f ", i + 1, lambda[i], st->gamma, mu[i],
+            m[i], st->analytic.rho, st->mean.utilization, st->analytic.l, st->mean.l, st->analytic.w, st->mean.w);
+        if(out.replications > 1)
+            printf("%9.4f ", st->halfWidth.w);
+        printf("%9.4f %9.4f\n", st->analytic.wq, st->mean.wq);
+    }
+    printf("\nPrinting the network end to end...\n\n");
+    printEndToEnd("Average time spent in the network (W)", out.w, out.wHalfWidth, out.analyticW, out.replications);
+    printEndToEnd("Average number in the network (L)", out.l, out.lHalfWidth, out.analyticL, out.replications);
+    printEndToEnd("Average visits per customer", out.visits, out.visitsHalfWidth, out.analyticVisits,
+        out.replications);
+    printf("Customers through the network = %ld\n", out.customers);
+    printf("Most events pending at once = %ld\n\n", out.peakEvents);
+    free(out.station);
+    free(route);
+    free(m);
+    free(mu);
+    free(lambda);
+}
@@ -0,0 +1,25 @@
+/***************************************************************
+  Paul Lewis
+  File Name: network.h
+  Simulation
+
+  Contains function prototypes, #defines, and #includes for network.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _network_h
+#define _network_h
+
+/*
+ * A function to simulate an open network of stations read from a file
+ * and print each station's and the end to end statistics against their
+ * product form values
+ *
+ * @param const char *file, the file holding the network
+ * @param const struct simConfig *base, the engine, method, replications and
+ *  threads the network is run with
+ */
+void runNetworkFile(const char *file, const struct simConfig *base);
+
+#endif
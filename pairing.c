@@ -0,0 +1,136 @@
+/***************************************************************
+  Paul Lewis
+  File Name: pairing.c
+  Simulation
+
+  Contains functions for creating, using, and freeing a pairing heap
+***************************************************************/
+
+#include "pairing.h"
+
+/*
+ * A function to allocate and initialize an empty pairing heap
+ *
+ * @local struct pairingHeap *ph, reference to new heap
+ *
+ * @return struct pairingHeap *, reference to the heap
+ */
+struct pairingHeap *newPairingHeap() {
+    struct pairingHeap *ph = (struct pairingHeap *) malloc(sizeof(struct pairingHeap));
+    if(ph == NULL) {
+        perror("malloc failed. cannot construct pairing heap.\n");
+        exit(1);
+    }
+    ph->theSize = 0;
+    ph->root = NULL;
+    initNodePool(&ph->nodes);
+    return ph;
+}
+/*
+ * A function to link two heap-ordered trees, the larger root
+ * becomes the first child of the smaller
+ *
+ * @param struct eventNode *a, root of the first tree, may be NULL
+ * @param struct eventNode *b, root of the second tree
+ *
+ * @local struct eventNode *tmp, used to swap a and b
+ *
+ * @return struct eventNode *, root of the combined tree
+ */
+static struct eventNode *meld(struct eventNode *a, struct eventNode *b) {
+    struct eventNode *tmp;
+    if(a == NULL)
+        return b;
+    if(b->ev.time < a->ev.time) {
+        tmp = a;
+        a = b;
+        b = tmp;
+    }
+    b->next = a->child;
+    a->child = b;
+    return a;
+}
+/*
+ * A function to add an element to a pairing heap
+ *
+ * @param struct pairingHeap *ph, the heap
+ * @param struct event ev, the element to add
+ */
+void pairingInsert(struct pairingHeap *ph, struct event ev) {
+    ph->root = meld(ph->root, newNode(&ph->nodes, ev));
+    ph->theSize++;
+}
+/*
+ * A function to remove the smallest element from a pairing heap
+ * The children of the root are melded in pairs left to right,
+ * then the pairs are melded right to left
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @local struct eventNode *old, the root being removed
+ * @local struct eventNode *a, struct eventNode *b, the pair being melded
+ * @local struct eventNode *rest, the children not yet paired
+ * @local struct eventNode *pairs, the melded pairs, last pair first
+ * @local struct event min, the element to return
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event pairingDeleteMin(struct pairingHeap *ph) {
+    struct eventNode *old, *a, *b, *rest, *pairs = NULL;
+    struct event min;
+    if(ph->theSize == 0) {
+        min.id = -1;
+        return min;
+    }
+    old = ph->root;
+    min = old->ev;
+    rest = old->child;
+    while(rest != NULL) {           // first pass, meld children in pairs
+        a = rest;
+        b = a->next;
+        if(b == NULL) {
+            a->next = pairs;
+            pairs = a;
+            break;
+        }
+        rest = b->next;
+        a->next = NULL;
+        b->next = NULL;
+        a = meld(a, b);
+        a->next = pairs;
+        pairs = a;
+    }
+    ph->root = NULL;
+    while(pairs != NULL) {          // second pass, meld pairs from the last to the first
+        a = pairs;
+        pairs = a->next;
+        a->next = NULL;
+        ph->root = meld(ph->root, a);
+    }
+    freeNode(&ph->nodes, old);
+    ph->theSize--;
+    return min;
+}
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @return struct event, the element
+ */
+struct event pairingGetMin(struct pairingHeap *ph) {
+    return ph->root->ev;
+}
+/*
+ * A function to free a pairing heap
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @return struct pairingHeap *, reference to the freed heap (NULL)
+ */
+struct pairingHeap *freePairingHeap(struct pairingHeap *ph) {
+    clearNodePool(&ph->nodes);
+    free(ph);
+    ph = NULL;
+    return ph;
+}
@@ -0,0 +1,69 @@
+/***************************************************************
+  Paul Lewis
+  File Name: pairing.h
+  Simulation
+
+  Contains struct definitions, function prototypes, and #includes for pairing.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include "customer.h"
+#include "eventnode.h"
+
+#ifndef _pairing_h
+#define _pairing_h
+
+/*
+ * The pairing heap structure
+ * A node's children are linked through child and next
+ *
+ * @field int theSize, the number of elements
+ * @field struct eventNode *root, the node holding the smallest element
+ * @field struct nodePool nodes, the pool nodes are allocated from
+ */
+struct pairingHeap {
+    int theSize;
+    struct eventNode *root;
+    struct nodePool nodes;
+};
+
+/*
+ * A function to allocate and initialize an empty pairing heap
+ *
+ * @return struct pairingHeap *, reference to the heap
+ */
+struct pairingHeap *newPairingHeap();
+/*
+ * A function to add an element to a pairing heap
+ *
+ * @param struct pairingHeap *ph, the heap
+ * @param struct event ev, the element to add
+ */
+void pairingInsert(struct pairingHeap *ph, struct event ev);
+/*
+ * A function to remove the smallest element from a pairing heap
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @return struct event, the removed element, id -1 if empty
+ */
+struct event pairingDeleteMin(struct pairingHeap *ph);
+/*
+ * A function to return the smallest element without removing it
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @return struct event, the element
+ */
+struct event pairingGetMin(struct pairingHeap *ph);
+/*
+ * A function to free a pairing heap
+ *
+ * @param struct pairingHeap *ph, the heap
+ *
+ * @return struct pairingHeap *, reference to the freed heap (NULL)
+ */
+struct pairingHeap *freePairingHeap(struct pairingHeap *ph);
+
+#endif
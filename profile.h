@@ -0,0 +1,70 @@
+/***************************************************************
+  Paul Lewis
+  File Name: profile.h
+  Simulation
+
+  Contains #defines and inline functions for timing the phases of
+  the event loop. They are only compiled in when SIM_PROFILE is
+  defined (make PROFILE=1), otherwise they compile to nothing
+***************************************************************/
+
+#include <stdint.h>
+#include "libsimulation.h"
+#ifdef SIM_PROFILE
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#else
+#include <time.h>
+#endif
+#endif
+
+#ifndef _profile_h
+#define _profile_h
+
+#ifdef SIM_PROFILE
+
+#define PROFILE_ENABLED 1
+
+/*
+ * A function to read the cycle counter, or nanoseconds where there is none
+ *
+ * @local struct timespec ts, the time
+ *
+ * @return uint64_t, the count
+ */
+static inline uint64_t profileClock() {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec*1000000000ULL + ts.tv_nsec;
+#endif
+}
+/*
+ * A function to add the cycles since a start to a phase
+ *
+ * @param struct simProfile *p, the profile
+ * @param int phase, one of the SIM_PHASE_ values
+ * @param uint64_t start, the cycle count the phase started at
+ */
+static inline void profilePhase(struct simProfile *p, int phase, uint64_t start) {
+    p->cycles[phase] += profileClock() - start;
+    p->calls[phase]++;
+}
+
+#define PROFILE_BEGIN(t) uint64_t t = profileClock()
+#define PROFILE_END(p, phase, t) profilePhase(p, phase, t)
+#define PROFILE_PEAK(peak, x) do { if((x) > (peak)) (peak) = (x); } while(0)
+
+#else
+
+#define PROFILE_ENABLED 0
+
+#define PROFILE_BEGIN(t)
+#define PROFILE_END(p, phase, t)
+#define PROFILE_PEAK(peak, x)
+
+#endif
+
+#endif
@@ -0,0 +1,303 @@
+/***************************************************************
+  Paul Lewis
+  File Name: progress.c
+  Simulation
+
+  Contains functions for publishing snapshots of running
+  replications to a shared memory segment, and for reading them
+  from another process. Each replication has a slot guarded by a
+  seqlock, so a run only ever pays for an occasional write and
+  never waits for a reader
+***************************************************************/
+
+#include <fcntl.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "model.h"
+#include "progress.h"
+
+#define PROGRESS_TRIES 1000     // reads of a slot before a reader gives up
+
+/*
+ * A function to return the wall clock time in seconds
+ *
+ * @local struct timespec ts, the time
+ *
+ * @return double, the time
+ */
+static double wallClock() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+/*
+ * A function to make the shared memory name of a segment, which must
+ * start with /
+ *
+ * @param const char *name, the name asked for
+ *
+ * @local char *full, the name
+ *
+ * @return char *, the name, to be freed
+ */
+static char *segmentName(const char *name) {
+    char *full = (char *) malloc(strlen(name) + 2);
+    if(full == NULL) {
+        perror("malloc error. cannot create progress.\n");
+        exit(1);
+    }
+    sprintf(full, "%s%s", name[0] == '/' ? "" : "/", name);
+    return full;
+}
+/*
+ * A function to allocate a progress segment handle
+ *
+ * @param const char *name, the name asked for
+ * @param int owner, boolean, whether this process creates the segment
+ *
+ * @local struct progress *pr, the new handle
+ *
+ * @return struct progress *, reference to the handle
+ */
+static struct progress *newProgress(const char *name, int owner) {
+    struct progress *pr = (struct progress *) malloc(sizeof(struct progress));
+    if(pr == NULL) {
+        perror("malloc error. cannot create progress.\n");
+        exit(1);
+    }
+    pr->name = segmentName(name);
+    pr->head = NULL;
+    pr->slots = NULL;
+    pr->size = 0;
+    pr->owner = owner;
+    return pr;
+}
+/*
+ * A function to create a progress segment for the replications of a config
+ * Every slot starts empty, so a reader sees replications not yet started
+ *
+ * @param const struct simConfig *cfg, the config, cfg->progress is the name
+ *
+ * @local struct progress *pr, the segment
+ * @local int fd, the shared memory
+ * @local void *map, the mapping
+ *
+ * @return struct progress *, reference to the segment, NULL if it cannot be created
+ */
+struct progress *openProgress(const struct simConfig *cfg) {
+    struct progress *pr = newProgress(cfg->progress, 1);
+    int fd;
+    void *map;
+    pr->size = sizeof(struct progressHeader) + cfg->replications * sizeof(struct progressSlot);
+    fd = shm_open(pr->name, O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if(fd < 0 || ftruncate(fd, pr->size) != 0
+            || (map = mmap(NULL, pr->size, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        if(fd >= 0) {
+            close(fd);
+            shm_unlink(pr->name);
+        }
+        pr->owner = 0;
+        closeProgress(pr);
+        return NULL;
+    }
+    close(fd);
+    pr->head = (struct progressHeader *) map;
+    pr->slots = (struct progressSlot *) (pr->head + 1);
+    memset(map, 0, pr->size);       // every slot empty with an even sequence
+    pr->head->version = PROGRESS_VERSION;
+    pr->head->slots = cfg->replications;
+    pr->head->pid = getpid();
+    pr->head->lambda = cfg->lambda;
+    pr->head->mu = cfg->mu;
+    pr->head->m = cfg->m;
+    atomic_thread_fence(memory_order_release);
+    memcpy(pr->head->magic, PROGRESS_MAGIC, sizeof(pr->head->magic));  // last, so a reader sees a whole header
+    return pr;
+}
+/*
+ * A function to map the progress segment of a running process
+ *
+ * @param const char *name, the shared memory name, / is added if it is missing
+ *
+ * @local struct progress *pr, the segment
+ * @local int fd, the shared memory
+ * @local struct stat st, its size
+ * @local void *map, the mapping
+ *
+ * @return struct progress *, reference to the segment, NULL with errno set
+ *  if it cannot be mapped or is not a progress segment
+ */
+struct progress *attachProgress(const char *name) {
+    struct progress *pr = newProgress(name, 0);
+    int fd;
+    struct stat st;
+    void *map;
+    if((fd = shm_open(pr->name, O_RDONLY, 0)) < 0) {
+        closeProgress(pr);
+        return NULL;
+    }
+    if(fstat(fd, &st) != 0 || st.st_size < (off_t) sizeof(struct progressHeader)
+            || (map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0)) == MAP_FAILED) {
+        close(fd);
+        closeProgress(pr);
+        errno = EINVAL;
+        return NULL;
+    }
+    close(fd);
+    pr->head = (struct progressHeader *) map;
+    pr->slots = (struct progressSlot *) (pr->head + 1);
+    pr->size = st.st_size;
+    if(memcmp(pr->head->magic, PROGRESS_MAGIC, sizeof(pr->head->magic)) != 0
+            || pr->head->version != PROGRESS_VERSION
+            || pr->size < sizeof(struct progressHeader) + pr->head->slots * sizeof(struct progressSlot)) {
+        closeProgress(pr);
+        errno = EINVAL;
+        return NULL;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    return pr;
+}
+/*
+ * A function to read a snapshot, without ever making the writer wait
+ * The copy is kept only if the sequence was even before it and the
+ * same after it, otherwise the writer was busy and it is tried again
+ *
+ * @param const struct progress *pr, the segment
+ * @param int rep, the replication
+ * @param struct progressSnapshot *s, where to store the snapshot
+ *
+ * @local struct progressSlot *slot, the replication's slot
+ * @local uint32_t before, after, the sequence before and after the copy
+ * @local int i, a counter
+ *
+ * @return int, 0, or -1 if the writer kept changing it
+ */
+int readProgress(const struct progress *pr, int rep, struct progressSnapshot *s) {
+    struct progressSlot *slot = &pr->slots[rep];
+    uint32_t before, after;
+    int i;
+    for(i=0;i<PROGRESS_TRIES;i++) {
+        before = atomic_load_explicit(&slot->seq, memory_order_acquire);
+        if(before & 1) {
+            sched_yield();
+            continue;
+        }
+        memcpy(s, (const void *) &slot->snapshot, sizeof(*s));
+        atomic_thread_fence(memory_order_acquire);
+        after = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+        if(before == after)
+            return 0;
+    }
+    return -1;
+}
+/*
+ * A function to unmap a progress segment, and remove it if this
+ * process created it. Readers that have it mapped keep the last snapshots
+ *
+ * @param struct progress *pr, the segment
+ *
+ * @return struct progress *, reference to the freed segment (NULL)
+ */
+struct progress *closeProgress(struct progress *pr) {
+    if(pr->head != NULL)
+        munmap(pr->head, pr->size);
+    if(pr->owner)
+        shm_unlink(pr->name);
+    free(pr->name);
+    free(pr);
+    pr = NULL;
+    return pr;
+}
+/*
+ * A function to write a snapshot to a slot under its seqlock
+ *
+ * @param struct progressSlot *slot, the slot
+ * @param const struct progressSnapshot *s, the snapshot
+ *
+ * @local uint32_t seq, the sequence before the write
+ */
+static void writeSnapshot(struct progressSlot *slot, const struct progressSnapshot *s) {
+    uint32_t seq = atomic_load_explicit(&slot->seq, memory_order_relaxed);
+    atomic_store_explicit(&slot->seq, seq + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    memcpy((void *) &slot->snapshot, s, sizeof(*s));
+    atomic_store_explicit(&slot->seq, seq + 2, memory_order_release);
+}
+/*
+ * A function to take a snapshot of a run and publish it
+ *
+ * @param struct simulation *sim, the run
+ * @param int done, boolean, whether the run has finished
+ *
+ * @local struct progressWriter *pw, the run's publishing state
+ * @local struct progressSnapshot s, the snapshot
+ * @local struct results r, the statistics so far
+ * @local double now, the wall clock time
+ * @local long events, the events processed
+ */
+static void snapshot(struct simulation *sim, int done) {
+    struct progressWriter *pw = &sim->progress;
+    struct progressSnapshot s;
+    struct results r;
+    double now = wallClock();
+    long events;
+    memset(&s, 0, sizeof(s));
+    s.queue = sim->q->size;
+    s.inSystem = sim->m - sim->serviceAvailable + s.queue;
+    s.served = sim->p->allocations - sim->p->live;
+    s.customers = s.served + s.inSystem;
+    s.target = sim->n;
+    s.clock = sim->clock;
+    s.elapsed = now - pw->start;
+    events = s.customers + s.served;
+    if(pw->events >= 0 && now > pw->last)
+        s.eventsPerSec = (events - pw->events)/(now - pw->last);
+    pw->last = now;
+    pw->events = events;
+    if(sim->measured > 0 && sim->clock > sim->warmupTime) {
+        r = postCalc(sim);
+        s.w = r.w;
+        s.wq = r.wq;
+        s.po = r.po;
+    }
+    s.started = 1;
+    s.done = done;
+    writeSnapshot(pw->slot, &s);
+}
+/*
+ * A function to start publishing the snapshots of a run
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param struct progress *pr, the segment
+ * @param int rep, the replication
+ */
+void startProgress(struct simulation *sim, struct progress *pr, int rep) {
+    sim->progress.slot = &pr->slots[rep];
+    sim->progress.start = wallClock();
+    sim->progress.last = sim->progress.start;
+    sim->progress.events = -1;      // no rate until the next snapshot
+    snapshot(sim, 0);
+    sim->nextProgress = sim->numberOfCustomers + PROGRESS_EVERY;
+}
+/*
+ * A function to publish a snapshot of a run between two events
+ *
+ * @param struct simulation *sim, the run
+ */
+void publishProgress(struct simulation *sim) {
+    sim->nextProgress += PROGRESS_EVERY;
+    snapshot(sim, 0);
+}
+/*
+ * A function to publish the last snapshot of a finished run
+ *
+ * @param struct simulation *sim, the finished run
+ */
+void finishProgress(struct simulation *sim) {
+    snapshot(sim, 1);
+    sim->progress.slot = NULL;
+    sim->nextProgress = LONG_MAX;
+}
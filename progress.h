@@ -0,0 +1,182 @@
+/***************************************************************
+  Paul Lewis
+  File Name: progress.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for progress.c
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdatomic.h>
+#include "libsimulation.h"
+
+#ifndef _progress_h
+#define _progress_h
+
+#define PROGRESS_MAGIC "SIMPROG1"  // the first 8 bytes of every progress segment
+#define PROGRESS_VERSION 1
+#define PROGRESS_EVERY 65536        // arrivals between snapshots
+
+struct simulation;
+
+/*
+ * A snapshot of one replication while it runs
+ *
+ * @field double clock, the simulated time
+ * @field double elapsed, the seconds since the replication started
+ * @field double eventsPerSec, the events processed per second since the last snapshot
+ * @field double w, double wq, double po, the a posteriori statistics so far
+ * @field int64_t customers, the arrivals processed
+ * @field int64_t served, the departures processed
+ * @field int64_t target, the most customers the replication takes, lowered by the stopping rule
+ * @field int32_t queue, the customers waiting
+ * @field int32_t inSystem, the customers waiting or in service
+ * @field int32_t started, boolean, whether the replication has started
+ * @field int32_t done, boolean, whether it has finished
+ */
+struct progressSnapshot {
+    double clock;
+    double elapsed;
+    double eventsPerSec;
+    double w;
+    double wq;
+    double po;
+    int64_t customers;
+    int64_t served;
+    int64_t target;
+    int32_t queue;
+    int32_t inSystem;
+    int32_t started;
+    int32_t done;
+};
+
+/*
+ * The snapshot of one replication behind a seqlock. The sequence is
+ * odd while the snapshot is written, so a reader copies it and keeps
+ * the copy only if the sequence was even and has not moved, and the
+ * writer never waits for a reader
+ *
+ * @field _Atomic uint32_t seq, the sequence
+ * @field uint32_t reserved, 0
+ * @field struct progressSnapshot snapshot, the snapshot
+ */
+struct progressSlot {
+    _Atomic uint32_t seq;
+    uint32_t reserved;
+    struct progressSnapshot snapshot;
+};
+
+/*
+ * The header of a progress segment, followed by one struct progressSlot
+ * per replication
+ *
+ * @field char magic[], PROGRESS_MAGIC, not terminated
+ * @field uint32_t version, PROGRESS_VERSION
+ * @field uint32_t slots, the replications
+ * @field int64_t pid, the process running them
+ * @field double lambda, double mu, int32_t m, the run
+ * @field int32_t reserved, 0
+ */
+struct progressHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t slots;
+    int64_t pid;
+    double lambda;
+    double mu;
+    int32_t m;
+    int32_t reserved;
+};
+
+/*
+ * A progress segment mapped into memory, by the run publishing to it
+ * or by a reader
+ *
+ * @field char *name, the shared memory name, starting with /
+ * @field struct progressHeader *head, the header
+ * @field struct progressSlot *slots, the slot of each replication
+ * @field size_t size, the bytes mapped
+ * @field int owner, boolean, whether this process created the segment
+ */
+struct progress {
+    char *name;
+    struct progressHeader *head;
+    struct progressSlot *slots;
+    size_t size;
+    int owner;
+};
+
+/*
+ * What a run keeps to publish its snapshots
+ *
+ * @field struct progressSlot *slot, its slot, NULL if it is not published
+ * @field double start, the wall clock time it started
+ * @field double last, the wall clock time of the last snapshot
+ * @field long events, the events processed at the last snapshot, -1 before the first
+ */
+struct progressWriter {
+    struct progressSlot *slot;
+    double start;
+    double last;
+    long events;
+};
+
+/*
+ * A function to create a progress segment for the replications of a config
+ *
+ * @param const struct simConfig *cfg, the config, cfg->progress is the name
+ *
+ * @return struct progress *, reference to the segment, NULL if it cannot be created
+ */
+struct progress *openProgress(const struct simConfig *cfg);
+/*
+ * A function to map the progress segment of a running process
+ *
+ * @param const char *name, the shared memory name, / is added if it is missing
+ *
+ * @return struct progress *, reference to the segment, NULL with errno set
+ *  if it cannot be mapped or is not a progress segment
+ */
+struct progress *attachProgress(const char *name);
+/*
+ * A function to read a snapshot, without ever making the writer wait
+ *
+ * @param const struct progress *pr, the segment
+ * @param int rep, the replication
+ * @param struct progressSnapshot *s, where to store the snapshot
+ *
+ * @return int, 0, or -1 if the writer kept changing it
+ */
+int readProgress(const struct progress *pr, int rep, struct progressSnapshot *s);
+/*
+ * A function to unmap a progress segment, and remove it if this
+ * process created it. Readers that have it mapped keep the last snapshots
+ *
+ * @param struct progress *pr, the segment
+ *
+ * @return struct progress *, reference to the freed segment (NULL)
+ */
+struct progress *closeProgress(struct progress *pr);
+/*
+ * A function to start publishing the snapshots of a run
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param struct progress *pr, the segment
+ * @param int rep, the replication
+ */
+void startProgress(struct simulation *sim, struct progress *pr, int rep);
+/*
+ * A function to publish a snapshot of a run between two events
+ *
+ * @param struct simulation *sim, the run
+ */
+void publishProgress(struct simulation *sim);
+/*
+ * A function to publish the last snapshot of a finished run
+ *
+ * @param struct simulation *sim, the finished run
+ */
+void finishProgress(struct simulation *sim);
+
+#endif
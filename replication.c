@@ -0,0 +1,384 @@
+/***************************************************************
+  Paul Lewis
+  File Name: replication.c
+  Simulation
+
+  Runs independent replications of the simulation in parallel.
+  Replication r seeds its streams with seedStream(seed, r, ...),
+  so every replication is independent of the others and of the
+  number of threads, and results are identical for a given seed
+***************************************************************/
+
+#include "model.h"
+#include "replication.h"
+#include "stats.h"
+
+struct batch;
+
+/*
+ * One replication, filled in by the worker thread that runs it
+ */
+struct replication {
+    struct batch *b;
+    int rep;
+    struct results r;
+    double pn[SIM_STATES];
+    double controls[2];
+    long customers;
+    double precision;
+    long truncated;
+    long logged;
+    long restored;
+    long checkpoints;
+    long peakCustomers;
+    long allocations;
+    struct simProfile profile;
+};
+
+/*
+ * The replications of one config, freed when the last one finishes
+ */
+struct batch {
+    struct simConfig cfg;
+    struct replication *jobs;
+    int remaining;
+    pthread_mutex_t lock;
+    struct runCache *cache;
+    void (*done)(struct simResults *, void *);
+    void *arg;
+    struct histogram *wHist;
+    struct histogram *wqHist;
+    struct progress *progress;
+    struct simResults res;
+};
+
+/*
+ * A function to initialize an empty cache of runs
+ *
+ * @param struct runCache *cache, the cache
+ */
+void initRunCache(struct runCache *cache) {
+    cache->head = NULL;
+    pthread_mutex_init(&cache->lock, NULL);
+}
+/*
+ * A function to free every run in a cache
+ *
+ * @param struct runCache *cache, the cache
+ *
+ * @local struct simulation *sim, a run
+ */
+void clearRunCache(struct runCache *cache) {
+    struct simulation *sim;
+    while(cache->head != NULL) {
+        sim = cache->head;
+        cache->head = sim->next;
+        freeSimulation(sim);
+    }
+    pthread_mutex_destroy(&cache->lock);
+}
+/*
+ * A function to get a run for a replication, from the cache if it has one
+ *
+ * @param struct runCache *cache, the cache, or NULL
+ * @param const struct simConfig *cfg, the run
+ * @param int rep, the replication
+ *
+ * @local struct simulation *sim, the run
+ *
+ * @return struct simulation *, the run, ready to start
+ */
+static struct simulation *takeRun(struct runCache *cache, const struct simConfig *cfg, int rep) {
+    struct simulation *sim = NULL;
+    if(cache != NULL) {
+        pthread_mutex_lock(&cache->lock);
+        sim = cache->head;
+        if(sim != NULL)
+            cache->head = sim->next;
+        pthread_mutex_unlock(&cache->lock);
+    }
+    if(sim == NULL)
+        sim = newSimulation(cfg->lambda, cfg->mu, cfg->m, cfg->n, cfg->engine, cfg->method, cfg->seed, rep);
+    else
+        resetSimulation(sim, cfg->lambda, cfg->mu, cfg->m, cfg->n, cfg->engine, cfg->method, cfg->seed, rep);
+    applyConfig(sim, cfg, rep);
+    return sim;
+}
+/*
+ * A function to give back a finished run, to the cache if there is one
+ *
+ * @param struct runCache *cache, the cache, or NULL
+ * @param struct simulation *sim, the run
+ */
+static void returnRun(struct runCache *cache, struct simulation *sim) {
+    if(cache == NULL) {
+        freeSimulation(sim);
+        return;
+    }
+    pthread_mutex_lock(&cache->lock);
+    sim->next = cache->head;
+    cache->head = sim;
+    pthread_mutex_unlock(&cache->lock);
+}
+/*
+ * A function to add the profile of one replication to the total
+ *
+ * @param struct simProfile *to, the total
+ * @param const struct simProfile *from, the replication's profile
+ *
+ * @local int i, a counter
+ */
+static void addProfile(struct simProfile *to, const struct simProfile *from) {
+    int i;
+    for(i=0;i<SIM_PHASES;i++) {
+        to->cycles[i] += from->cycles[i];
+        to->calls[i] += from->calls[i];
+    }
+    if(from->peakEvents > to->peakEvents)
+        to->peakEvents = from->peakEvents;
+    if(from->peakQueue > to->peakQueue)
+        to->peakQueue = from->peakQueue;
+}
+/*
+ * A function to summarize the replications of a batch into its results
+ *
+ * @param struct batch *b, the batch, every replication finished
+ *
+ * @local int i, n, counters
+ * @local int reps, the number of replications
+ * @local struct simResults *res, the results
+ * @local double *y, one statistic of every replication
+ * @local double *c, the controls of every replication, NULL without control variates
+ */
+static void summarize(struct batch *b) {
+    int i, n, reps = b->cfg.replications;
+    struct simResults *res = &b->res;
+    double *y, *c = NULL;
+    y = (double *) malloc(reps * sizeof(double));
+    if(b->cfg.control)
+        c = (double *) malloc(2 * reps * sizeof(double));
+    if(y == NULL || (b->cfg.control && c == NULL)) {
+        perror("malloc error. cannot summarize replications.\n");
+        exit(1);
+    }
+    res->analytic = preCalc(b->cfg.lambda, b->cfg.mu, b->cfg.m);
+    erlangStates(b->cfg.lambda, b->cfg.mu, b->cfg.m, res->analytic.po, res->analyticPn, SIM_STATES);
+    memset(res->pn, 0, sizeof(res->pn));
+    res->customers = 0;
+    res->precision = 0.0;
+    res->truncated = 0;
+    res->logged = 0;
+    res->restored = 0;
+    res->checkpoints = 0;
+    res->peakCustomers = 0;
+    res->allocations = 0;
+    res->published = b->progress != NULL;
+    memset(&res->profile, 0, sizeof(res->profile));
+    res->profile.enabled = PROFILE_ENABLED;
+    for(i=0;i<reps;i++) {   // aggregate in replication order so the results are deterministic
+        for(n=0;n<SIM_STATES;n++)
+            res->pn[n] += b->jobs[i].pn[n];
+        if(c != NULL) {
+            c[2*i] = b->jobs[i].controls[0];
+            c[2*i+1] = b->jobs[i].controls[1];
+        }
+        res->customers += b->jobs[i].customers;
+        res->truncated += b->jobs[i].truncated;
+        res->logged += b->jobs[i].logged;
+        res->restored += b->jobs[i].restored;
+        res->checkpoints += b->jobs[i].checkpoints;
+        if(b->jobs[i].precision > res->precision)
+            res->precision = b->jobs[i].precision;
+        if(b->jobs[i].peakCustomers > res->peakCustomers)
+            res->peakCustomers = b->jobs[i].peakCustomers;
+        if(b->jobs[i].allocations > res->allocations)
+            res->allocations = b->jobs[i].allocations;
+        addProfile(&res->profile, &b->jobs[i].profile);
+    }
+    for(n=0;n<RESULT_STATS;n++) {
+        for(i=0;i<reps;i++)
+            y[i] = *resultStat(&b->jobs[i].r, n);
+        estimateMean(y, c, reps, b->cfg.antithetic, resultStat(&res->mean, n),
+            resultStat(&res->halfWidth, n), resultStat(&res->reduction, n));
+    }
+    res->replications = reps;
+    for(n=0;n<SIM_STATES;n++)
+        res->pn[n] /= reps;
+    fillQuantiles(&res->w, b->wHist);
+    fillQuantiles(&res->wq, b->wqHist);
+    free(y);
+    free(c);
+}
+/*
+ * A function to start the log of a replication, if the config has one
+ * Replication r of several writes to the file named with ".r" added
+ *
+ * @param struct simulation *sim, the run, before it is started
+ * @param const struct simConfig *cfg, the run
+ * @param int rep, the replication
+ *
+ * @local char *path, the file of this replication
+ */
+static void startLog(struct simulation *sim, const struct simConfig *cfg, int rep) {
+    char *path;
+    if(cfg->log == NULL)
+        return;
+    if(cfg->replications == 1) {
+        sim->log = openEventLog(cfg->log, cfg->logThread);
+        return;
+    }
+    path = (char *) malloc(strlen(cfg->log) + 16);
+    if(path == NULL) {
+        perror("malloc error. cannot create log.\n");
+        exit(1);
+    }
+    sprintf(path, "%s.%d", cfg->log, rep);
+    sim->log = openEventLog(path, cfg->logThread);
+    free(path);
+}
+/*
+ * A function run by a worker thread for one replication
+ * Its histograms are merged into the batch's, and the thread that
+ * finishes the last replication of a batch reports it
+ *
+ * @param void *arg, the struct replication to run
+ *
+ * @local struct replication *job, the replication
+ * @local struct batch *b, the batch it belongs to
+ * @local struct simulation *sim, the run
+ * @local int last, boolean, whether this was the last replication
+ */
+static void replicate(void *arg) {
+    struct replication *job = (struct replication *) arg;
+    struct batch *b = job->b;
+    struct simulation *sim;
+    int last;
+    sim = takeRun(b->cache, &b->cfg, job->rep);
+    job->restored = 0;
+    if(b->cfg.restore != NULL && (job->restored = restoreCheckpoint(sim, &b->cfg)) < 0) {
+        returnRun(b->cache, sim);       // the checkpoint changed since it was checked, start over
+        sim = takeRun(b->cache, &b->cfg, job->rep);
+    }
+    if(b->cfg.checkpoint != NULL)
+        startCheckpoints(sim, &b->cfg);
+    if(b->progress != NULL)
+        startProgress(sim, b->progress, job->rep);
+    startLog(sim, &b->cfg, job->rep);
+    runSimulation(sim);
+    if(sim->progress.slot != NULL)
+        finishProgress(sim);
+    job->logged = 0;
+    if(sim->log != NULL)
+        sim->log = closeEventLog(sim->log, &job->logged);
+    job->checkpoints = 0;
+    if(sim->ckpt != NULL)
+        job->checkpoints = stopCheckpoints(sim);
+    job->r = postCalc(sim);
+    fillStates(sim, job->pn);
+    fillControls(sim, job->controls);
+    job->customers = sim->numberOfCustomers;
+    job->precision = runPrecision(sim);
+    job->truncated = sim->truncated;
+    job->peakCustomers = sim->p->peakLive;
+    job->allocations = sim->p->allocations;
+    job->profile = sim->prof;
+
+    pthread_mutex_lock(&b->lock);
+    mergeHistogram(b->wHist, sim->wHist);
+    mergeHistogram(b->wqHist, sim->wqHist);
+    last = --b->remaining == 0;
+    pthread_mutex_unlock(&b->lock);
+    returnRun(b->cache, sim);
+    if(!last)
+        return;
+    summarize(b);
+    b->done(&b->res, b->arg);
+    pthread_mutex_destroy(&b->lock);
+    freeHistogram(b->wHist);
+    freeHistogram(b->wqHist);
+    if(b->progress != NULL)
+        b->progress = closeProgress(b->progress);
+    free(b->jobs);
+    free(b);
+}
+/*
+ * A function to queue independent replications of the simulation on a
+ * thread pool. When the last one finishes, the mean and 95% confidence
+ * interval of each statistic are passed to done on the thread that ran it
+ * With a single replication and no pool, the run is made on the calling thread
+ *
+ * @param struct threadPool *tp, the pool, or NULL for a single replication
+ * @param struct runCache *cache, the runs to reuse, or NULL to allocate each run
+ * @param const struct simConfig *cfg, the run, cfg->replications of them, copied
+ * @param void (*done)(struct simResults *, void *), called with the results
+ * @param void *arg, passed to done
+ *
+ * @local int i, a counter
+ * @local int reps, the number of replications
+ * @local struct batch *b, the replications
+ */
+void submitReplications(struct threadPool *tp, struct runCache *cache, const struct simConfig *cfg,
+        void (*done)(struct simResults *, void *), void *arg) {
+    int i, reps = cfg->replications;
+    struct batch *b = (struct batch *) malloc(sizeof(struct batch));
+    if(b == NULL) {
+        perror("malloc error. cannot create replications.\n");
+        exit(1);
+    }
+    b->jobs = (struct replication *) malloc(reps * sizeof(struct replication));
+    if(b->jobs == NULL) {
+        perror("malloc error. cannot create replications.\n");
+        exit(1);
+    }
+    b->cfg = *cfg;
+    b->remaining = reps;
+    pthread_mutex_init(&b->lock, NULL);
+    b->cache = cache;
+    b->done = done;
+    b->arg = arg;
+    b->wHist = newHistogram();
+    b->wqHist = newHistogram();
+    b->progress = cfg->progress != NULL ? openProgress(cfg) : NULL;
+    for(i=0;i<reps;i++) {
+        b->jobs[i].b = b;
+        b->jobs[i].rep = i;
+    }
+    if(tp == NULL) {            // run in place, b is freed by the last replication
+        for(i=0;i<reps;i++)
+            replicate(&b->jobs[i]);
+        return;
+    }
+    for(i=0;i<reps;i++)
+        submitTask(tp, replicate, &b->jobs[i]);
+}
+/*
+ * A function to copy finished results to where runReplications wants them
+ *
+ * @param struct simResults *res, the results
+ * @param void *arg, the struct simResults to fill
+ */
+static void storeResults(struct simResults *res, void *arg) {
+    *(struct simResults *) arg = *res;
+}
+/*
+ * A function to run independent replications of the simulation on a
+ * pool of threads and store the mean and 95% confidence interval of
+ * each a posteriori statistic
+ * A single replication is run on the calling thread
+ *
+ * @param const struct simConfig *cfg, the run, cfg->replications of them
+ * @param struct simResults *res, where to store the results
+ *
+ * @local struct threadPool *tp, the workers
+ */
+void runReplications(const struct simConfig *cfg, struct simResults *res) {
+    struct threadPool *tp;
+    if(cfg->replications == 1) {
+        submitReplications(NULL, NULL, cfg, storeResults, res);
+        return;
+    }
+    tp = newThreadPool(cfg->threads);
+    submitReplications(tp, NULL, cfg, storeResults, res);
+    waitThreadPool(tp);
+    tp = freeThreadPool(tp);
+}
@@ -0,0 +1,64 @@
+/***************************************************************
+  Paul Lewis
+  File Name: replication.h
+  Simulation
+
+  Contains struct definitions, function prototypes, and #includes for replication.c
+***************************************************************/
+
+#include <pthread.h>
+#include "libsimulation.h"
+#include "threadpool.h"
+
+#ifndef _replication_h
+#define _replication_h
+
+/*
+ * Finished runs kept for reuse, so their FIFO queue and customer pool
+ * do not have to be grown again by the next run
+ *
+ * @field struct simulation *head, the runs, linked through next
+ * @field pthread_mutex_t lock, guards head
+ */
+struct runCache {
+    struct simulation *head;
+    pthread_mutex_t lock;
+};
+
+/*
+ * A function to initialize an empty cache of runs
+ *
+ * @param struct runCache *cache, the cache
+ */
+void initRunCache(struct runCache *cache);
+/*
+ * A function to free every run in a cache
+ *
+ * @param struct runCache *cache, the cache
+ */
+void clearRunCache(struct runCache *cache);
+/*
+ * A function to queue independent replications of the simulation on a
+ * thread pool. When the last one finishes, the mean and 95% confidence
+ * interval of each statistic are passed to done on the thread that ran it
+ * With a single replication and no pool, the run is made on the calling thread
+ *
+ * @param struct threadPool *tp, the pool, or NULL for a single replication
+ * @param struct runCache *cache, the runs to reuse, or NULL to allocate each run
+ * @param const struct simConfig *cfg, the run, cfg->replications of them, copied
+ * @param void (*done)(struct simResults *, void *), called with the results
+ * @param void *arg, passed to done
+ */
+void submitReplications(struct threadPool *tp, struct runCache *cache, const struct simConfig *cfg,
+        void (*done)(struct simResults *, void *), void *arg);
+/*
+ * A function to run independent replications of the simulation on a
+ * pool of threads and store the mean and 95% confidence interval of
+ * each a posteriori statistic
+ *
+ * @param const struct simConfig *cfg, the run, cfg->replications of them
+ * @param struct simResults *res, where to store the results
+ */
+void runReplications(const struct simConfig *cfg, struct simResults *res);
+
+#endif
@@ -0,0 +1,142 @@
+/***************************************************************
+  Paul Lewis
+  File Name: rng.c
+  Simulation
+
+  Contains functions for seeding, drawing from, and jumping ahead
+  a xoshiro256++ random number generator
+***************************************************************/
+
+#include "rng.h"
+
+/*
+ * The jump polynomials for 2^128 and 2^192 draws
+ */
+static const uint64_t JUMP[4] = {
+    0x180ec6d33cfd0abaULL, 0xd5a61266f0c9392cULL, 0xa9582618e03fc9aaULL, 0x39abdc4529b1661cULL
+};
+static const uint64_t LONG_JUMP[4] = {
+    0x76e15d3efefdcbbfULL, 0xc5004e441c522fb3ULL, 0x77710069854ee241ULL, 0x39109bb02acbe635ULL
+};
+
+/*
+ * A function to rotate bits left
+ *
+ * @param uint64_t x, the bits
+ * @param int k, the distance
+ *
+ * @return uint64_t, the rotated bits
+ */
+static inline uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+}
+/*
+ * A function to seed a generator, the seed is expanded with splitmix64
+ *
+ * @param struct rng *r, the generator
+ * @param uint64_t seed, the seed
+ *
+ * @local int i, a counter
+ * @local uint64_t z, the splitmix64 output
+ */
+void seedRng(struct rng *r, uint64_t seed) {
+    int i;
+    uint64_t z;
+    for(i=0;i<4;i++) {      // splitmix64 never yields an all zero state from four outputs
+        seed += 0x9e3779b97f4a7c15ULL;
+        z = seed;
+        z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+        z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+        r->s[i] = z ^ (z >> 31);
+    }
+}
+/*
+ * A function to seed a generator as one stream of a family
+ * Replication rep, stream k starts rep long jumps and k jumps after seedRng
+ *
+ * @param struct rng *r, the generator
+ * @param uint64_t seed, the seed shared by the family
+ * @param int rep, the replication
+ * @param int stream, the stream, one of the RNG_STREAM_ values
+ *
+ * @local int i, a counter
+ */
+void seedStream(struct rng *r, uint64_t seed, int rep, int stream) {
+    int i;
+    seedRng(r, seed);
+    for(i=0;i<rep;i++)
+        longJumpRng(r);
+    for(i=0;i<stream;i++)
+        jumpRng(r);
+}
+/*
+ * A function to draw the next 64 random bits
+ *
+ * @param struct rng *r, the generator
+ *
+ * @local uint64_t result, the bits
+ * @local uint64_t t, a temporary
+ *
+ * @return uint64_t, the bits
+ */
+uint64_t nextRandom(struct rng *r) {
+    uint64_t result = rotl(r->s[0] + r->s[3], 23) + r->s[0];
+    uint64_t t = r->s[1] << 17;
+    r->s[2] ^= r->s[0];
+    r->s[3] ^= r->s[1];
+    r->s[1] ^= r->s[2];
+    r->s[0] ^= r->s[3];
+    r->s[2] ^= t;
+    r->s[3] = rotl(r->s[3], 45);
+    return result;
+}
+/*
+ * A function to draw a uniform double on the open interval (0,1)
+ * The top 53 bits are centered in their interval, so 0 and 1 never occur
+ *
+ * @param struct rng *r, the generator
+ *
+ * @return double, the uniform
+ */
+double uniformOpen(struct rng *r) {
+    return ((nextRandom(r) >> 11) + 0.5) * 0x1.0p-53;
+}
+/*
+ * A function to apply a jump polynomial to a generator
+ *
+ * @param struct rng *r, the generator
+ * @param const uint64_t poly[], the jump polynomial
+ *
+ * @local uint64_t s[], the new state
+ * @local int i, int b, int k, counters
+ */
+static void applyJump(struct rng *r, const uint64_t poly[4]) {
+    uint64_t s[4] = { 0, 0, 0, 0 };
+    int i, b, k;
+    for(i=0;i<4;i++) {
+        for(b=0;b<64;b++) {
+            if(poly[i] & (1ULL << b))
+                for(k=0;k<4;k++)
+                    s[k] ^= r->s[k];
+            nextRandom(r);
+        }
+    }
+    for(k=0;k<4;k++)
+        r->s[k] = s[k];
+}
+/*
+ * A function to advance a generator 2^128 draws
+ *
+ * @param struct rng *r, the generator
+ */
+void jumpRng(struct rng *r) {
+    applyJump(r, JUMP);
+}
+/*
+ * A function to advance a generator 2^192 draws
+ *
+ * @param struct rng *r, the generator
+ */
+void longJumpRng(struct rng *r) {
+    applyJump(r, LONG_JUMP);
+}
@@ -0,0 +1,78 @@
+/***************************************************************
+  Paul Lewis
+  File Name: rng.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for rng.c
+***************************************************************/
+
+#include <stdint.h>
+
+#ifndef _rng_h
+#define _rng_h
+
+/*
+ * The streams drawn from by a simulation run
+ * Each stream starts 2^128 draws after the one before it
+ */
+#define RNG_STREAM_ARRIVALS 0
+#define RNG_STREAM_SERVICES 1
+#define RNG_STREAMS 2
+
+/*
+ * A xoshiro256++ random number generator (Blackman and Vigna)
+ * Period 2^256-1, the state must not be all zero
+ *
+ * @field uint64_t s[], the state
+ */
+struct rng {
+    uint64_t s[4];
+};
+
+/*
+ * A function to seed a generator, the seed is expanded with splitmix64
+ *
+ * @param struct rng *r, the generator
+ * @param uint64_t seed, the seed
+ */
+void seedRng(struct rng *r, uint64_t seed);
+/*
+ * A function to seed a generator as one stream of a family
+ * Replication rep, stream k starts rep long jumps and k jumps after seedRng
+ *
+ * @param struct rng *r, the generator
+ * @param uint64_t seed, the seed shared by the family
+ * @param int rep, the replication
+ * @param int stream, the stream, one of the RNG_STREAM_ values
+ */
+void seedStream(struct rng *r, uint64_t seed, int rep, int stream);
+/*
+ * A function to draw the next 64 random bits
+ *
+ * @param struct rng *r, the generator
+ *
+ * @return uint64_t, the bits
+ */
+uint64_t nextRandom(struct rng *r);
+/*
+ * A function to draw a uniform double on the open interval (0,1)
+ *
+ * @param struct rng *r, the generator
+ *
+ * @return double, the uniform
+ */
+double uniformOpen(struct rng *r);
+/*
+ * A function to advance a generator 2^128 draws
+ *
+ * @param struct rng *r, the generator
+ */
+void jumpRng(struct rng *r);
+/*
+ * A function to advance a generator 2^192 draws
+ *
+ * @param struct rng *r, the generator
+ */
+void longJumpRng(struct rng *r);
+
+#endif
@@ -0,0 +1,205 @@
+/***************************************************************
+  Paul Lewis
+  File Name: server.c
+  Simulation
+
+  A long lived mode that reads scenarios one per line from stdin
+  or a named pipe and streams back one CSV record per scenario.
+  Scenarios run concurrently on one session, so the threads and
+  the runs' queues and pools stay warm from one to the next.
+  Records come back in the order the scenarios finish, each
+  tagged with its request id
+***************************************************************/
+
+#include <string.h>
+#include <pthread.h>
+#include "simulation.h"
+#include "server.h"
+
+/*
+ * The state shared by the reader and the workers
+ */
+struct server {
+    pthread_mutex_t lock;           // guards inflight and the output
+    pthread_cond_t room;            // signalled when a scenario finishes
+    int inflight;                   // the number of scenarios in progress
+};
+
+/*
+ * A scenario in progress, freed when its record is written
+ */
+struct scenario {
+    struct server *srv;
+    char id[SERVER_ID];
+    struct simConfig cfg;
+};
+
+/*
+ * A function to write a record, one whole line at a time
+ *
+ * @param struct server *srv, the server
+ * @param const char *record, the line to write
+ */
+static void writeRecord(struct server *srv, const char *record) {
+    pthread_mutex_lock(&srv->lock);
+    fputs(record, stdout);
+    fflush(stdout);
+    pthread_mutex_unlock(&srv->lock);
+}
+/*
+ * A function called by a worker when a scenario finishes, writing its record
+ *
+ * @param struct simResults *res, the results
+ * @param void *arg, the struct scenario
+ *
+ * @local struct scenario *sc, the scenario
+ * @local struct server *srv, the server
+ * @local struct simConfig *cfg, the config of the scenario
+ * @local char record[], the line to write
+ */
+static void finishScenario(struct simResults *res, void *arg) {
+    struct scenario *sc = (struct scenario *) arg;
+    struct server *srv = sc->srv;
+    struct simConfig *cfg = &sc->cfg;
+    char record[SERVER_LINE * 4];
+    snprintf(record, sizeof(record),
+        "%s,%g,%g,%d,%ld,%llu,%d,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%ld,%ld\n",
+        sc->id, cfg->lambda, cfg->mu, cfg->m, cfg->n, (unsigned long long) cfg->seed, res->replications,
+        res->analytic.po, res->analytic.l, res->analytic.w, res->analytic.lq, res->analytic.wq, res->analytic.rho, res->analytic.pWait,
+        res->mean.po, res->mean.w, res->mean.wq, res->mean.pWait,
+        res->halfWidth.po, res->halfWidth.w, res->halfWidth.wq, res->halfWidth.pWait,
+        res->w.p95, res->w.p99, res->w.p999, res->wq.p95, res->wq.p99, res->wq.p999,
+        res->mean.l, res->mean.lq, res->mean.utilization, res->halfWidth.l, res->halfWidth.lq, res->halfWidth.utilization,
+        res->customers, res->truncated);
+    writeRecord(srv, record);
+    free(sc);
+    pthread_mutex_lock(&srv->lock);
+    srv->inflight--;
+    pthread_cond_signal(&srv->room);
+    pthread_mutex_unlock(&srv->lock);
+}
+/*
+ * A function to parse a scenario line
+ * "lambda mu M N seed [replications]", optionally preceded by "id:"
+ *
+ * @param char *line, the line, a trailing newline is removed
+ * @param long lineNumber, the id when the line gives none
+ * @param struct scenario *sc, the scenario to fill
+ *
+ * @local char *colon, the end of the id
+ * @local char *values, the start of the values
+ * @local unsigned long long seed, the seed
+ * @local int k, the number of values read
+ *
+ * @return int, boolean, whether the line held a scenario
+ */
+static int parseScenario(char *line, long lineNumber, struct scenario *sc) {
+    char *colon, *values = line;
+    unsigned long long seed;
+    int k;
+    line[strcspn(line, "\r\n")] = '\0';
+    colon = strchr(line, ':');
+    if(colon != NULL && colon - line < SERVER_ID) {
+        memcpy(sc->id, line, colon - line);
+        sc->id[colon - line] = '\0';
+        values = colon + 1;
+    } else {
+        snprintf(sc->id, SERVER_ID, "%ld", lineNumber);
+    }
+    k = sscanf(values, "%lf %lf %d %ld %llu %d", &sc->cfg.lambda, &sc->cfg.mu, &sc->cfg.m, &sc->cfg.n,
+        &seed, &sc->cfg.replications);
+    if(k < 5)
+        return 0;
+    sc->cfg.seed = seed;
+    return 1;
+}
+/*
+ * A function to read scenarios one per line and write one CSV record
+ * per scenario as soon as it finishes, until the input ends
+ * Blank lines and lines starting with # are skipped
+ *
+ * @param const char *file, the file or named pipe to read, "-" for stdin
+ * @param const struct simConfig *base, the engine, method, threads, stopping
+ *  rule and warm-up detection every scenario is run with, and the replications
+ *  of a scenario that does not give its own
+ *
+ * @local FILE *fp, the input
+ * @local char line[], the buffer for reading a line
+ * @local char record[], an error record
+ * @local long lineNumber, the number of the line read
+ * @local struct server srv, the server
+ * @local struct simSession *session, the warm pool the scenarios run on
+ * @local struct scenario *sc, a scenario
+ */
+void runServer(const char *file, const struct simConfig *base) {
+    FILE *fp;
+    char line[SERVER_LINE], record[SERVER_LINE + SERVER_ID];
+    long lineNumber = 0;
+    struct server srv;
+    struct simSession *session;
+    struct scenario *sc;
+
+    fp = strcmp(file, "-") == 0 ? stdin : fopen(file, "r");
+    if(fp == NULL) {
+        perror("Unable to open scenario input\n");
+        exit(1);
+    }
+    pthread_mutex_init(&srv.lock, NULL);
+    pthread_cond_init(&srv.room, NULL);
+    srv.inflight = 0;
+    session = newSession(base->threads);
+    writeRecord(&srv, "id,lambda,mu,M,N,seed,replications,Po,L,W,Lq,Wq,Rho,PWait,"
+        "simPo,simW,simWq,simPWait,ciPo,ciW,ciWq,ciPWait,"
+        "simWp95,simWp99,simWp999,simWqp95,simWqp99,simWqp999,simL,simLq,simRho,ciL,ciLq,ciRho,customers,truncated\n");
+
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        lineNumber++;
+        if(line[strspn(line, " \t\r\n")] == '\0' || line[0] == '#')
+            continue;
+        sc = (struct scenario *) malloc(sizeof(struct scenario));
+        if(sc == NULL) {
+            perror("malloc error. cannot create scenario.\n");
+            exit(1);
+        }
+        sc->srv = &srv;
+        sc->cfg = *base;            // -r replications unless the line gives its own
+        if(!parseScenario(line, lineNumber, sc)) {
+            snprintf(record, sizeof(record), "%s,error,expected lambda mu M N seed [replications]\n", sc->id);
+            writeRecord(&srv, record);
+            free(sc);
+            continue;
+        }
+        if(sc->cfg.antithetic && sc->cfg.replications % 2 != 0) {
+            snprintf(record, sizeof(record), "%s,error,antithetic pairs need an even number of replications\n", sc->id);
+            writeRecord(&srv, record);
+            free(sc);
+            continue;
+        }
+        if(sc->cfg.control && sc->cfg.replications / (sc->cfg.antithetic ? 2 : 1) < SIM_CONTROL_UNITS) {
+            snprintf(record, sizeof(record), "%s,error,control variates need at least %d replications (or %d antithetic pairs)\n",
+                sc->id, SIM_CONTROL_UNITS, SIM_CONTROL_UNITS);
+            writeRecord(&srv, record);
+            free(sc);
+            continue;
+        }
+        pthread_mutex_lock(&srv.lock);
+        while(srv.inflight >= SERVER_INFLIGHT)
+            pthread_cond_wait(&srv.room, &srv.lock);
+        srv.inflight++;
+        pthread_mutex_unlock(&srv.lock);
+        if(simulateAsync(session, &sc->cfg, finishScenario, sc) != 0) {
+            snprintf(record, sizeof(record), "%s,error,lambda, mu, M, N and replications must be positive\n", sc->id);
+            writeRecord(&srv, record);
+            free(sc);
+            pthread_mutex_lock(&srv.lock);
+            srv.inflight--;
+            pthread_mutex_unlock(&srv.lock);
+        }
+    }
+    waitSession(session);
+    session = freeSession(session);
+    pthread_mutex_destroy(&srv.lock);
+    pthread_cond_destroy(&srv.room);
+    if(fp != stdin)
+        fclose(fp);
+}
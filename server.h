@@ -0,0 +1,36 @@
+/***************************************************************
+  Paul Lewis
+  File Name: server.h
+  Simulation
+
+  Contains function prototypes, #defines, and #includes for server.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _server_h
+#define _server_h
+
+/*
+ * The most scenarios that may be in progress at once, reading
+ * stops until one finishes
+ */
+#define SERVER_INFLIGHT 1024
+/*
+ * The longest scenario line, and the longest request id
+ */
+#define SERVER_LINE 256
+#define SERVER_ID 64
+
+/*
+ * A function to read scenarios one per line and write one CSV record
+ * per scenario as soon as it finishes, until the input ends
+ *
+ * @param const char *file, the file or named pipe to read, "-" for stdin
+ * @param const struct simConfig *base, the engine, method, threads, stopping
+ *  rule and warm-up detection every scenario is run with, and the replications
+ *  of a scenario that does not give its own
+ */
+void runServer(const char *file, const struct simConfig *base);
+
+#endif
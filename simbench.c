@@ -0,0 +1,595 @@
+/***************************************************************
+  Paul Lewis
+  File Name: simbench.c
+  Simulation
+
+  A program for timing the parts of the simulation one at a
+  time: the event set under the hold model, the FIFO queue, the
+  customer pool, the random streams and whole runs. Each case is
+  warmed up, then timed a number of times, and the spread of the
+  times is printed as CSV so that builds and engines can be
+  compared by a script. It also checks that the exponential
+  variates of every method follow 1 - exp(-lambda x), by the AVX2
+  and the scalar kernels alike and bit for bit the same, and that a
+  start from empty at high load is truncated past its transient
+***************************************************************/
+
+#include <unistd.h>
+#include <time.h>
+#include "model.h"
+
+#define BENCH_REPEATS 11    // timed repetitions of each case, by default
+#define BENCH_OPS 200000    // operations in one repetition of each case
+#define KS_SAMPLE 1000000   // variates drawn from each method for the goodness of fit check
+#define KS_SEED 20240101    // the fixed seed of the check, so its D and p repeat
+#define KS_LAMBDA 2.0       // the rate of the variates checked, not 1 so the scaling is checked too
+#define KS_TERMS 100        // the most terms of the Kolmogorov series summed
+#define KS_ALPHA 0.01       // the p value below which a method fails the check
+#define KS_LINE 256         // the buffer for a row of the scalar kernels' check
+#define WARMUP_SEEDS 8      // the seeds each queue of the warm-up check is run with
+#define WARMUP_N 400000     // the customers of each run of the warm-up check
+
+/*
+ * The pending event counts to hold, about those of 1, 64 and 4096 servers
+ */
+static const int populations[] = { 2, 64, 4096 };
+/*
+ * The queue lengths and live customer counts to churn at
+ */
+static const int depths[] = { 1, 64, 4096 };
+/*
+ * The queues of the warm-up check, lambda, mu and M, at load 0.95 and
+ * 0.99, whose relaxation times are about 1500 and 40000 customers
+ */
+static const double highLoads[][3] = { { 19, 20, 1 }, { 99, 1, 100 } };
+/*
+ * The server counts of whole runs, each at load 0.9
+ */
+static const int servers[] = { 2, 256 };
+
+/*
+ * Where the benchmarks leave a value that depends on their work,
+ * so that the compiler keeps it
+ */
+static volatile double sink;
+
+/*
+ * A function to return the current time in seconds
+ *
+ * @local struct timespec ts, the time
+ *
+ * @return double, the time
+ */
+static double now() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return ts.tv_sec + ts.tv_nsec*1e-9;
+}
+/*
+ * A function to compare two doubles for qsort
+ *
+ * @param const void *a, const void *b, the doubles
+ *
+ * @return int, negative, 0 or positive as a is below, equal to or above b
+ */
+static int compareTimes(const void *a, const void *b) {
+    double x = *(const double *) a, y = *(const double *) b;
+    return (x > y) - (x < y);
+}
+/*
+ * A function to read a percentile of sorted times by nearest rank
+ *
+ * @param const double *t, the times, sorted
+ * @param int n, the number of times
+ * @param double p, the percentile, 0 to 100
+ *
+ * @local int k, the rank
+ *
+ * @return double, the percentile
+ */
+static double percentile(const double *t, int n, double p) {
+    int k = (int) ceil(p/100.0*n) - 1;
+    if(k < 0)
+        k = 0;
+    return t[k];
+}
+/*
+ * A function to print the times of one case as a row of CSV
+ *
+ * @param const char *bench, the part timed
+ * @param const char *variant, the engine or method
+ * @param long size, the population, depth or servers
+ * @param double *t, the nanoseconds per operation of each repetition, sorted here
+ * @param int repeats, the number of repetitions
+ * @param long ops, the operations in each repetition
+ *
+ * @local double median, the median
+ */
+static void report(const char *bench, const char *variant, long size, double *t, int repeats, long ops) {
+    double median;
+    qsort(t, repeats, sizeof(double), compareTimes);
+    median = percentile(t, repeats, 50);
+    printf("%s,%s,%ld,%d,%ld,%.2f,%.2f,%.2f,%.2f,%.2f,%.0f\n", bench, variant, size, repeats, ops,
+        t[0], percentile(t, repeats, 10), median, percentile(t, repeats, 90), t[repeats-1], 1e9/median);
+    fflush(stdout);
+}
+/*
+ * A function to time the hold model on an event set: remove the
+ * earliest event, then schedule it again a random interval later
+ *
+ * @param int engine, the event set engine
+ * @param int population, the number of pending events
+ * @param long ops, the number of holds
+ * @param struct rng *r, the stream for intervals
+ *
+ * @local struct eventSet *es, the event set
+ * @local struct event ev, the event being held
+ * @local long i, a counter
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per hold
+ */
+static double holdModel(int engine, int population, long ops, struct rng *r) {
+    struct eventSet *es = newEventSet(engine);
+    struct event ev;
+    long i;
+    double start;
+    for(i=0;i<population;i++) {
+        ev.time = -log(uniformOpen(r));
+        ev.id = i;
+        schedule(es, ev);
+    }
+    start = now();
+    for(i=0;i<ops;i++) {
+        ev = nextEvent(es);
+        ev.time += -log(uniformOpen(r));
+        schedule(es, ev);
+    }
+    start = now() - start;
+    sink = ev.time;
+    freeEventSet(es);
+    return start*1e9/ops;
+}
+/*
+ * A function to time a FIFO queue held at a length, each operation
+ * an enqueue followed by a dequeue
+ *
+ * @param int depth, the length
+ * @param long ops, the number of operations
+ *
+ * @local struct FIFOqueue *q, the queue
+ * @local long i, a counter
+ * @local long sum, the customers dequeued, added up
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per operation
+ */
+static double fifoChurn(int depth, long ops) {
+    struct FIFOqueue *q = newQueue();
+    long i, sum = 0;
+    double start;
+    for(i=0;i<depth;i++)
+        enqueue(q, i);
+    start = now();
+    for(i=0;i<ops;i++) {
+        enqueue(q, i);
+        sum += dequeue(q);
+    }
+    start = now() - start;
+    sink = sum;
+    freeFIFOqueue(q);
+    return start*1e9/ops;
+}
+/*
+ * A function to time a customer pool held at a number of live
+ * customers, each operation freeing the oldest and taking a new one
+ *
+ * @param int live, the live customers
+ * @param long ops, the number of operations
+ *
+ * @local struct customerPool *p, the pool
+ * @local int *ring, the live customers, oldest first
+ * @local long i, a counter
+ * @local int head, the oldest customer's place in ring
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per operation
+ */
+static double customerChurn(int live, long ops) {
+    struct customerPool *p = newPool();
+    int *ring = (int *) malloc(sizeof(int) * live), head = 0;
+    long i;
+    double start;
+    if(ring == NULL) {
+        perror("malloc error. cannot create benchmark.\n");
+        exit(1);
+    }
+    for(i=0;i<live;i++)
+        ring[i] = newCustomer(p, (double) i, 1);
+    start = now();
+    for(i=0;i<ops;i++) {
+        freeCustomer(p, ring[head]);
+        ring[head] = newCustomer(p, (double) i, 1);
+        if(++head == live)
+            head = 0;
+    }
+    start = now() - start;
+    sink = p->arrivalTime[ring[0]];
+    free(ring);
+    freePool(p);
+    return start*1e9/ops;
+}
+/*
+ * A function to time the raw 64 bit random stream
+ *
+ * @param long ops, the number of values
+ * @param struct rng *r, the stream
+ *
+ * @local long i, a counter
+ * @local uint64_t x, the values, combined
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per value
+ */
+static double rngThroughput(long ops, struct rng *r) {
+    long i;
+    uint64_t x = 0;
+    double start = now();
+    for(i=0;i<ops;i++)
+        x ^= nextRandom(r);
+    start = now() - start;
+    sink = (double) x;
+    return start*1e9/ops;
+}
+/*
+ * A function to time exponential intervals as the simulation takes them
+ *
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param long ops, the number of intervals
+ * @param struct rng *r, the stream, copied into the buffer
+ *
+ * @local struct variates v, the buffer
+ * @local long i, a counter
+ * @local double sum, the intervals, added up
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per interval
+ */
+static double variateThroughput(int method, long ops, struct rng *r) {
+    struct variates v;
+    long i;
+    double sum = 0.0, start;
+    initVariates(&v, r, 1.0, method);
+    start = now();
+    for(i=0;i<ops;i++)
+        sum += getNextRandomInterval(&v);
+    start = now() - start;
+    sink = sum;
+    return start*1e9/ops;
+}
+/*
+ * A function to time a whole run at load 0.9, from the first arrival
+ * to the last departure
+ *
+ * @param int engine, the event set engine
+ * @param int m, the number of servers
+ * @param long customers, the customers to serve
+ * @param int rep, the replication, so each repetition draws afresh
+ *
+ * @local struct simConfig cfg, the run
+ * @local struct simulation *sim, the run
+ * @local double start, the start time
+ *
+ * @return double, nanoseconds per event, an arrival or a departure
+ */
+static double wholeRun(int engine, int m, long customers, int rep) {
+    struct simConfig cfg;
+    struct simulation *sim;
+    double start;
+    defaultConfig(&cfg);
+    cfg.mu = 1.0;
+    cfg.lambda = 0.9*m;
+    cfg.m = m;
+    cfg.n = customers;
+    cfg.engine = engine;
+    sim = newSimulation(cfg.lambda, cfg.mu, cfg.m, cfg.n, cfg.engine, cfg.method, cfg.seed, rep);
+    applyConfig(sim, &cfg, rep);
+    start = now();
+    runSimulation(sim);
+    start = now() - start;
+    sink = sim->totalWaitTime;
+    freeSimulation(sim);
+    return start*1e9/(2*customers);
+}
+/*
+ * A function to find the p value of the Kolmogorov-Smirnov statistic,
+ * the chance of a D this large from a sample of the distribution, by
+ * the asymptotic series 2 sum (-1)^(k-1) exp(-2 k^2 t^2) with Stephens'
+ * correction for the sample size
+ *
+ * @param double d, the statistic
+ * @param long n, the sample size
+ *
+ * @local double t, the scaled statistic
+ * @local double term, a term of the series
+ * @local double sum, the series
+ * @local int k, a counter
+ *
+ * @return double, the p value
+ */
+static double kolmogorovP(double d, long n) {
+    double t = (sqrt((double) n) + 0.12 + 0.11/sqrt((double) n))*d, term, sum = 0.0;
+    int k;
+    if(t < 0.2)
+        return 1.0;             // the series is 1 to every digit a double holds
+    for(k=1;k<=KS_TERMS;k++) {
+        term = exp(-2.0*k*k*t*t);
+        sum += (k % 2 ? 2.0 : -2.0)*term;
+        if(term < 1e-16*sum)
+            break;
+    }
+    return sum < 0.0 ? 0.0 : sum > 1.0 ? 1.0 : sum;
+}
+/*
+ * A function to check the exponential intervals of a method against
+ * 1 - exp(-lambda x) by the one sample Kolmogorov-Smirnov test and print
+ * a row of CSV with the kernels used, a digest of the intervals in the
+ * order drawn, the largest gap D between the sample's and the exponential
+ * distribution functions and its p value
+ *
+ * @param int method, the variate method, one of the VARIATE_ values
+ * @param long n, the sample size
+ * @param double *x, room for the sample
+ * @param uint64_t *digest, where to store the digest, FNV-1a over the bits
+ *  of every interval
+ *
+ * @local struct rng r, the stream, seeded the same for every method
+ * @local struct variates v, the buffer
+ * @local long i, a counter
+ * @local uint64_t bits, the bits of an interval
+ * @local double f, the exponential distribution function at a variate
+ * @local double d, the largest gap
+ * @local double p, its p value
+ *
+ * @return int, boolean, whether the method fails, p below KS_ALPHA
+ */
+static int ksCheck(int method, long n, double *x, uint64_t *digest) {
+    struct rng r;
+    struct variates v;
+    long i;
+    uint64_t bits;
+    double f, d = 0.0, p;
+    seedRng(&r, KS_SEED);
+    initVariates(&v, &r, KS_LAMBDA, method);
+    *digest = 14695981039346656037ULL;
+    for(i=0;i<n;i++) {
+        x[i] = getNextRandomInterval(&v);
+        memcpy(&bits, &x[i], sizeof(bits));
+        *digest = (*digest ^ bits) * 1099511628211ULL;
+    }
+    qsort(x, n, sizeof(double), compareTimes);
+    for(i=0;i<n;i++) {
+        f = -expm1(-KS_LAMBDA*x[i]);
+        d = fmax(d, fmax((double) (i + 1)/n - f, f - (double) i/n));
+    }
+    p = kolmogorovP(d, n);
+    printf("%s,%s,%g,%ld,%llu,%016llx,%.6f,%.4f\n", method == VARIATE_ZIGGURAT ? "ziggurat" : "inversion",
+        variatesVectorized() ? "avx2" : "scalar", KS_LAMBDA, n, (unsigned long long) KS_SEED,
+        (unsigned long long) *digest, d, p);
+    fflush(stdout);
+    return p < KS_ALPHA;
+}
+/*
+ * A function to run the check again on the scalar kernels, in a copy of
+ * this program with SIMULATION_SCALAR set, as the kernels are chosen once
+ * per process, print its rows and compare its digests with these
+ *
+ * @param const char *self, the path this program was run by
+ * @param const uint64_t *digest, the digest of each method on the AVX2 kernels
+ *
+ * @local char command[], the command run
+ * @local char line[], a row of its output
+ * @local char method[], the method of a row
+ * @local unsigned long long scalar, the digest of a row
+ * @local FILE *fp, its output
+ * @local int e, the method of a row
+ * @local int failed, the rows that failed or differ
+ * @local int rows, the rows read
+ *
+ * @return int, the methods that failed, differ or were not checked
+ */
+static int scalarCheck(const char *self, const uint64_t *digest) {
+    char command[KS_LINE], line[KS_LINE], method[KS_LINE];
+    unsigned long long scalar;
+    FILE *fp;
+    int e, failed = 0, rows = 0;
+    snprintf(command, sizeof(command), "SIMULATION_SCALAR=1 '%s' ks", self);
+    fp = popen(command, "r");
+    if(fp == NULL) {
+        perror("Unable to run the scalar kernels' check\n");
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), fp) != NULL) {
+        if(sscanf(line, "%255[^,],scalar,%*[^,],%*[^,],%*[^,],%llx", method, &scalar) != 2)
+            continue;           // the header
+        fputs(line, stdout);
+        e = strcmp(method, "ziggurat") == 0 ? VARIATE_ZIGGURAT : VARIATE_INVERSION;
+        if(scalar != digest[e]) {
+            fprintf(stderr, "%s: the scalar and AVX2 kernels drew different intervals from seed %llu\n", method,
+                (unsigned long long) KS_SEED);
+            failed++;
+        }
+        rows++;
+    }
+    if(pclose(fp) != 0)
+        failed++;
+    return failed + (VARIATE_INVERSION - VARIATE_ZIGGURAT + 1 - rows);
+}
+/*
+ * A function to check that runs of a queue from empty with -w leave out
+ * at least its relaxation time, lambda/(sqrt(M mu) - sqrt(lambda))^2
+ * customers, and print a row of CSV for each seed
+ *
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ *
+ * @local struct simConfig cfg, the run
+ * @local struct simResults res, its results
+ * @local long relaxation, the relaxation time in customers
+ * @local int seed, the seed
+ * @local int failed, the runs truncated short of the relaxation time
+ *
+ * @return int, the runs truncated short of the relaxation time
+ */
+static int warmupCheck(double lambda, double mu, int m) {
+    struct simConfig cfg;
+    struct simResults res;
+    long relaxation = (long) (lambda/pow(sqrt(m*mu) - sqrt(lambda), 2));
+    int seed, failed = 0;
+    defaultConfig(&cfg);
+    cfg.lambda = lambda;
+    cfg.mu = mu;
+    cfg.m = m;
+    cfg.n = WARMUP_N;
+    cfg.warmup = 1;
+    for(seed=1;seed<=WARMUP_SEEDS;seed++) {
+        cfg.seed = seed;
+        if(simulate(&cfg, &res) != 0) {
+            fprintf(stderr, "the warm-up check cannot run lambda = %g, mu = %g, M = %d\n", lambda, mu, m);
+            exit(1);
+        }
+        failed += res.truncated < relaxation;
+        printf("%g,%g,%d,%d,%d,%ld,%ld,%.6f,%.6f,%s\n", lambda, mu, m, WARMUP_N, seed, relaxation, res.truncated,
+            res.analytic.wq, res.mean.wq, res.truncated < relaxation ? "short" : "ok");
+        fflush(stdout);
+    }
+    return failed;
+}
+/*
+ * A function to tell whether a case is selected
+ *
+ * @param const char *filter, the benchmark asked for, NULL for every one
+ * @param const char *bench, the benchmark of the case
+ *
+ * @return int, boolean, whether to run it
+ */
+static int selected(const char *filter, const char *bench) {
+    return filter == NULL || strcmp(filter, bench) == 0;
+}
+/*
+ * A program to time the parts of the simulation
+ * Every case is run once untimed to warm the caches, the allocator
+ * and the branch predictors, then timed repeats times. A row of CSV
+ * is printed for each case with the minimum, 10th percentile, median,
+ * 90th percentile and maximum nanoseconds per operation, and the
+ * operations per second at the median
+ * Asked for ks, it instead checks the variates of every method fit the
+ * exponential distribution, one row of CSV per method and kernel, and that
+ * the kernels agree bit for bit, and asked for
+ * warmup that runs at high load are truncated past their transient
+ *
+ * @param int argc, the number of command line arguments
+ * @param char *argv[], the command line arguments, -r repeats and
+ *  optionally one of hold, fifo, customer, rng, variate, run, ks or warmup
+ *
+ * @local int repeats, the number of timed repetitions
+ * @local long ops, the operations in each repetition
+ * @local const char *filter, the benchmark asked for, NULL for every one
+ * @local double *t, the nanoseconds per operation of each repetition, or the
+ *  sample of the ks check
+ * @local uint64_t digest[], the digest of each method in the ks check
+ * @local struct rng r, the stream for the benchmarks that draw
+ * @local int opt, the command line option being read
+ * @local int e, i, k, counters
+ *
+ * @return int, 0, or 1 if the ks or warm-up check fails
+ */
+int main(int argc, char *argv[]) {
+    int repeats = BENCH_REPEATS, opt, e, i, k;
+    long ops = BENCH_OPS;
+    const char *filter = NULL;
+    double *t;
+    uint64_t digest[VARIATE_INVERSION + 1];
+    struct rng r;
+    while((opt = getopt(argc, argv, "r:n:")) != -1) {
+        if(opt == 'r' && (repeats = atoi(optarg)) > 0)
+            continue;
+        if(opt == 'n' && (ops = atol(optarg)) > 0)
+            continue;
+        fprintf(stderr, "usage: %s [-r repeats] [-n operations] [hold|fifo|customer|rng|variate|run|ks|warmup]\n", argv[0]);
+        exit(1);
+    }
+    if(optind < argc)
+        filter = argv[optind];
+    if(filter != NULL && strcmp(filter, "warmup") == 0) {
+        printf("lambda,mu,M,N,seed,relaxation,truncated,Wq,simWq,result\n");
+        for(i=k=0;i<(int)(sizeof(highLoads)/sizeof(highLoads[0]));i++)
+            k += warmupCheck(highLoads[i][0], highLoads[i][1], (int) highLoads[i][2]);
+        return k > 0;
+    }
+    if(filter != NULL && strcmp(filter, "ks") == 0) {
+        t = (double *) malloc(sizeof(double) * KS_SAMPLE);
+        if(t == NULL) {
+            perror("malloc error. cannot create sample.\n");
+            exit(1);
+        }
+        printf("method,kernel,lambda,n,seed,digest,D,p\n");
+        for(e=VARIATE_ZIGGURAT,k=0;e<=VARIATE_INVERSION;e++)
+            k += ksCheck(e, KS_SAMPLE, t, &digest[e]);
+        if(variatesVectorized())
+            k += scalarCheck(argv[0], digest);
+        else if(getenv("SIMULATION_SCALAR") == NULL)
+            fprintf(stderr, "this machine has no AVX2, only the scalar kernels were checked\n");
+        free(t);
+        return k > 0;
+    }
+    t = (double *) malloc(sizeof(double) * repeats);
+    if(t == NULL) {
+        perror("malloc error. cannot create benchmark.\n");
+        exit(1);
+    }
+    seedRng(&r, 1);
+
+    printf("benchmark,variant,size,repeats,ops,min_ns,p10_ns,median_ns,p90_ns,max_ns,ops_per_sec\n");
+    for(e=0;e<EVENTSET_ENGINES && selected(filter, "hold");e++)
+        for(i=0;i<(int)(sizeof(populations)/sizeof(populations[0]));i++) {
+            holdModel(e, populations[i], ops, &r);
+            for(k=0;k<repeats;k++)
+                t[k] = holdModel(e, populations[i], ops, &r);
+            report("hold", eventSetName(e), populations[i], t, repeats, ops);
+        }
+    for(i=0;i<(int)(sizeof(depths)/sizeof(depths[0])) && selected(filter, "fifo");i++) {
+        fifoChurn(depths[i], ops);
+        for(k=0;k<repeats;k++)
+            t[k] = fifoChurn(depths[i], ops);
+        report("fifo", "ring", depths[i], t, repeats, ops);
+    }
+    for(i=0;i<(int)(sizeof(depths)/sizeof(depths[0])) && selected(filter, "customer");i++) {
+        customerChurn(depths[i], ops);
+        for(k=0;k<repeats;k++)
+            t[k] = customerChurn(depths[i], ops);
+        report("customer", "pool", depths[i], t, repeats, ops);
+    }
+    if(selected(filter, "rng")) {
+        rngThroughput(ops, &r);
+        for(k=0;k<repeats;k++)
+            t[k] = rngThroughput(ops, &r);
+        report("rng", "xoshiro", 1, t, repeats, ops);
+    }
+    for(e=VARIATE_ZIGGURAT;e<=VARIATE_INVERSION && selected(filter, "variate");e++) {
+        variateThroughput(e, ops, &r);
+        for(k=0;k<repeats;k++)
+            t[k] = variateThroughput(e, ops, &r);
+        report("variate", e == VARIATE_ZIGGURAT ? "ziggurat" : "inversion", 1, t, repeats, ops);
+    }
+    for(e=0;e<EVENTSET_ENGINES && selected(filter, "run");e++)
+        for(i=0;i<(int)(sizeof(servers)/sizeof(servers[0]));i++) {
+            wholeRun(e, servers[i], ops/2, 0);
+            for(k=0;k<repeats;k++)
+                t[k] = wholeRun(e, servers[i], ops/2, k+1);
+            report("run", eventSetName(e), servers[i], t, repeats, ops);
+        }
+    free(t);
+    return 0;
+}
@@ -4,23 +4,12 @@
   Simulation
 
   A program for running a simulation of arrivals and departures
-  with a given number of server nodes for processing various statistics
+  with a given number of server nodes for processing various statistics.
+  The command line front end to libsimulation
 ***************************************************************/
 
+#include <string.h>
 #include "simulation.h"
-#include "FIFOqueue.h"
-#include "heap.h"
-
-/*
- * Global variables for keeping track of statistics
- */
-float totalTime;
-float totalServiceTime;
-float totalWaitTime;
-float idleTime;
-int serviceAvailable;
-int numberOfCustomers;
-int numInQueue;
 
 /* 
  * A program to run a simulation of arrivals and departures
@@ -30,367 +19,568 @@ int numInQueue;
  * @local int lambda, the average number of arrivals per time unit
  * @local int mu, the average number of customers to service per time unit
  * @local int m, the number of servers
- * @local int n, total number of arrivals to service
+ * @local long n, total number of arrivals to service
  * @local char line[], the buffer for getting values from file
- * @local int ar[], an array for holding the integer values from the file
+ * @local long ar[], an array for holding the integer values from the file
+ * @local uint64_t seed, the seed, from an optional fifth line of the file or the clock
  * @local FILE *fp, the file pointer to the file holding the values for lambda, mu, M, and N
+ * @local int opt, the command line option being read
+ * @local int engine, the future event set engine, chosen with -e
+ * @local int method, the variate method, chosen with -v
+ * @local int reps, the number of replications, chosen with -r
+ * @local int threads, the number of worker threads, chosen with -t
+ * @local char *sweep, the sweep file, chosen with -s
+ * @local char *serve, the scenario input, chosen with -S
+ * @local struct staffingTarget target, the targets to staff for, chosen with -o
+ * @local double tolerance, the precision to stop at, chosen with -p
+ * @local int stopOn, the time whose precision is watched, chosen with -p
+ * @local int warmup, boolean, whether to discard the warm-up, chosen with -w
+ * @local int antithetic, boolean, whether replications come in antithetic pairs, chosen with -R
+ * @local int control, boolean, whether to use control variates, chosen with -R
+ * @local int compare, the number of servers to compare M with, chosen with -c, 0 for none
+ * @local char *tracePath, the trace to replay, chosen with -T
+ * @local struct simTrace *trace, the trace mapped into memory
+ * @local char *log, the file to log every customer to, chosen with -l
+ * @local int logThread, boolean, whether the log is written on a thread of its own, chosen with -b
+ * @local char *checkpoint, the file to keep a checkpoint of the run in, chosen with -k
+ * @local long every, the customers between checkpoints, chosen with -K
+ * @local char *restore, the checkpoint to go on from, chosen with -x
+ * @local char *progress, the shared memory to publish progress to, chosen with -P
+ * @local char *network, the network file, chosen with -N
+ * @local long records, the number of customers in the trace
+ * @local struct simConfig cfg, the run
+ * @local struct simResults res, the results of the run
+ *
+ * @param int argc, the number of command line arguments
+ * @param char *argv[], the command line arguments
  *
  * @return 0 
  */
-int main(void) {
-    int i, lambda, mu, m, n;
+int main(int argc, char *argv[]) {
+    int i, m, opt;
+    double lambda, mu;
+    long n, records, every = 0;
+    int engine = EVENTSET_BINARY;
+    int method = VARIATE_ZIGGURAT;
+    int reps = 1, threads = 0;
+    char *sweep = NULL, *serve = NULL, *tracePath = NULL, *log = NULL, *checkpoint = NULL, *restore = NULL, *progress = NULL;
+    char *network = NULL;
+    struct simTrace *trace = NULL;
     char line[BUFFER_SIZE];
-    int ar[STATS];    
+    long ar[STATS];    
+    uint64_t seed;
     FILE *fp;
+    struct simConfig cfg;
+    struct simResults res;
+    struct staffingTarget target = {0.0, 0.0};
+    double tolerance = 0.0;
+    int stopOn = SIM_STOP_WQ, warmup = 0, antithetic = 0, control = 0, compare = 0, logThread = 0;
+    while((opt = getopt(argc, argv, "e:v:r:t:s:S:o:p:wR:c:T:l:bk:K:x:P:N:")) != -1) {
+        if(opt == 'e' && (engine = eventSetType(optarg)) >= 0)
+            continue;
+        if(opt == 'v' && (method = variateMethod(optarg)) >= 0)
+            continue;
+        if(opt == 'r' && (reps = atoi(optarg)) > 0)
+            continue;
+        if(opt == 't' && (threads = atoi(optarg)) >= 0)
+            continue;
+        if(opt == 's') {
+            sweep = optarg;
+            continue;
+        }
+        if(opt == 'S') {
+            serve = optarg;
+            continue;
+        }
+        if(opt == 'o' && strncmp(optarg, "wq=", 3) == 0 && (target.wq = atof(optarg + 3)) > 0)
+            continue;
+        if(opt == 'o' && strncmp(optarg, "pwait=", 6) == 0 && (target.pWait = atof(optarg + 6)) > 0)
+            continue;
+        if(opt == 'p' && strncmp(optarg, "wq=", 3) == 0 && (tolerance = atof(optarg + 3)) > 0) {
+            stopOn = SIM_STOP_WQ;
+            continue;
+        }
+        if(opt == 'p' && strncmp(optarg, "w=", 2) == 0 && (tolerance = atof(optarg + 2)) > 0) {
+            stopOn = SIM_STOP_W;
+            continue;
+        }
+        if(opt == 'w') {
+            warmup = 1;
+            continue;
+        }
+        if(opt == 'R' && strcmp(optarg, "antithetic") == 0) {
+            antithetic = 1;
+            continue;
+        }
+        if(opt == 'R' && strcmp(optarg, "control") == 0) {
+            control = 1;
+            continue;
+        }
+        if(opt == 'c' && (compare = atoi(optarg)) > 0)
+            continue;
+        if(opt == 'T') {
+            tracePath = optarg;
+            continue;
+        }
+        if(opt == 'l') {
+            log = optarg;
+            continue;
+        }
+        if(opt == 'b') {
+            logThread = 1;
+            continue;
+        }
+        if(opt == 'k') {
+            checkpoint = optarg;
+            continue;
+        }
+        if(opt == 'K' && (every = atol(optarg)) > 0)
+            continue;
+        if(opt == 'x') {
+            restore = optarg;
+            continue;
+        }
+        if(opt == 'P') {
+            progress = optarg;
+            continue;
+        }
+        if(opt == 'N') {
+            network = optarg;
+            continue;
+        }
+        fprintf(stderr, "usage: %s [-e binary|dary|pairing|calendar|ladder] [-v ziggurat|inversion] [-r replications] [-t threads] [-s sweepfile] [-S scenarios|-] [-o wq=target|pwait=target] [-p wq=tolerance|w=tolerance] [-w] [-R antithetic|control] [-c servers] [-T trace] [-l log [-b]] [-k checkpoint [-K customers]] [-x checkpoint] [-P name] [-N network]\n", argv[0]);
+        exit(1);
+    }
+    if(log != NULL && (sweep != NULL || serve != NULL || target.wq > 0 || target.pWait > 0 || compare > 0)) {
+        fprintf(stderr, "a log can only be written with simulation.txt, not with -s, -S, -o or -c\n");
+        exit(1);
+    }
+    if((checkpoint != NULL || restore != NULL) && (sweep != NULL || serve != NULL || target.wq > 0
+            || target.pWait > 0 || compare > 0 || reps > 1 || log != NULL)) {
+        fprintf(stderr, "checkpoints are only kept of one run of simulation.txt, not with -s, -S, -o, -c, -r or -l\n");
+        exit(1);
+    }
+    if(progress != NULL && (sweep != NULL || serve != NULL || target.wq > 0 || target.pWait > 0 || compare > 0)) {
+        fprintf(stderr, "progress can only be published for runs of simulation.txt, not with -s, -S, -o or -c\n");
+        exit(1);
+    }
+    if(network != NULL && (sweep != NULL || serve != NULL || target.wq > 0 || target.pWait > 0 || compare > 0
+            || tolerance > 0 || warmup || antithetic || control || tracePath != NULL || log != NULL
+            || checkpoint != NULL || restore != NULL || progress != NULL)) {
+        fprintf(stderr, "a network is run on its own, with -e, -v, -r and -t only\n");
+        exit(1);
+    }
+    if(tracePath != NULL && (sweep != NULL || serve != NULL || antithetic || control)) {
+        fprintf(stderr, "a trace cannot be swept, served, or used with -R\n");
+        exit(1);
+    }
+    if((antithetic || control) && (sweep != NULL || target.wq > 0 || target.pWait > 0 || compare > 0)) {
+        fprintf(stderr, "-R only applies to runs of simulation.txt and to -S, not to -s, -o or -c\n");
+        exit(1);
+    }
+    if(antithetic && reps % 2 != 0 && serve == NULL) {    // -S checks each scenario's replications
+        fprintf(stderr, "antithetic pairs need an even number of replications\n");
+        exit(1);
+    }
+    if(control && reps / (antithetic ? 2 : 1) < SIM_CONTROL_UNITS && serve == NULL) {
+        fprintf(stderr, "control variates need at least %d replications (or %d antithetic pairs)\n", SIM_CONTROL_UNITS,
+            SIM_CONTROL_UNITS);
+        exit(1);
+    }
+    defaultConfig(&cfg);
+    cfg.engine = engine;
+    cfg.method = method;
+    cfg.replications = reps;
+    cfg.threads = threads;
+    cfg.tolerance = tolerance;
+    cfg.stopOn = stopOn;
+    cfg.warmup = warmup;
+    cfg.antithetic = antithetic;
+    cfg.control = control;
+    cfg.log = log;
+    cfg.logThread = logThread;
+    cfg.checkpoint = checkpoint;
+    if(every > 0)
+        cfg.checkpointEvery = every;
+    cfg.restore = restore;
+    cfg.progress = progress;
+    if(sweep != NULL) {
+        runSweep(sweep, &cfg);
+        return 0;
+    }
+    if(serve != NULL) {
+        runServer(serve, &cfg);
+        return 0;
+    }
+    if(network != NULL) {
+        runNetworkFile(network, &cfg);
+        return 0;
+    }
     fp = fopen("simulation.txt", "r");
     if(fp == NULL) {
         perror("Unable to open file\n");
         exit(0);
     }
 
-    for(i=0;fgets(line,sizeof(line),fp)!=NULL;i++)      // get values from file to test 
-        ar[i] = atoi(line);
+    for(i=0;i<STATS && fgets(line,sizeof(line),fp)!=NULL;i++)  // get values from file to test 
+        ar[i] = atol(line);
+    if(i < STATS) {
+        fprintf(stderr, "simulation.txt must hold lambda, mu, M and N\n");
+        exit(1);
+    }
+    if(fgets(line,sizeof(line),fp) != NULL)     // optional seed
+        seed = strtoull(line, NULL, 10);
+    else
+        seed = (uint64_t) time(0);
+    fclose(fp);
 
     lambda = ar[0];
     mu = ar[1];
-    m = ar[2];
+    m = (int) ar[2];
     n = ar[3];
-    /* initialize global variables */
-    numberOfCustomers = 0;
-    totalTime = 0.0;
-    totalServiceTime = 0.0;
-    totalWaitTime = 0.0;
-    numInQueue = 0;
-    /* seed random number generator */
-    srand(time(0));    
     
-    printPreCalc(lambda, mu, m, n);
-
-    runSimulation(lambda, mu, m, n);
+    printf("\nseed = %llu\n", (unsigned long long) seed);
+    if(tracePath != NULL) {     // the trace's rates replace lambda and mu
+        if((trace = openTrace(tracePath)) == NULL) {
+            perror("Unable to open trace\n");
+            exit(1);
+        }
+        records = traceInfo(trace, &lambda, &mu);
+        printf("trace = %s, %ld customers\n", tracePath, records);
+        cfg.trace = trace;
+    }
+    cfg.lambda = lambda;
+    cfg.mu = mu;
+    cfg.m = m;
+    cfg.n = n;
+    cfg.seed = seed;
+    if(target.wq > 0 || target.pWait > 0)
+        printStaffing(&cfg, &target);
+    else if(compare > 0)
+        printComparison(&cfg, compare);
+    else
+        printRun(&cfg, &res);
+    if(trace != NULL)
+        trace = closeTrace(trace);
 
     return 0;
 }
 /*
- * A function for generating a random time interval.
- * 
- * @param float avg, either lambda or mu
+ * A function to run the simulation described by a config and print
+ * the a priori and a posteriori statistics
  *
- * @local float f, a random float (0..1] 
- * @local float intervalTime, the time average time interval
- *
- * @return float, the average time interval 
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, where to store the results
  */
-float getNextRandomInterval(float avg) {
-    float f = rand()/((float)RAND_MAX);
-    float intervalTime = -1 * (1.0/avg) * log(f);
-    return intervalTime;
+void printRun(struct simConfig *cfg, struct simResults *res) {
+    printPreCalc(cfg->lambda, cfg->mu, cfg->m, cfg->n);
+    if(cfg->progress != NULL) {
+        printf("Publishing progress, watch it with ./simwatch %s\n\n", cfg->progress);
+        fflush(stdout);
+    }
+    if(simulate(cfg, res) != 0) {
+        if(cfg->restore != NULL)
+            fprintf(stderr, "%s is not a whole checkpoint of this run, it must be written by this build with the same simulation.txt, seed included, and options\n", cfg->restore);
+        else
+            fprintf(stderr, "lambda, mu, M and N must all be positive\n");
+        exit(1);
+    }
+    if(cfg->replications > 1) {
+        printReplications(res);
+        printStates(res);
+        printStopping(cfg, res);
+        printWarmup(cfg, res);
+    } else {
+        printPostCalc(&res->mean);   // print a posteriori statistics
+        printQuantiles(res);
+        printStates(res);
+        printStopping(cfg, res);
+        printWarmup(cfg, res);
+        printf("Peak customer records in memory = %ld of %ld allocated\n\n", res->peakCustomers, res->allocations);
+    }
+    printProfile(res);
+    if(cfg->progress != NULL && !res->published)
+        fprintf(stderr, "unable to publish progress to shared memory %s\n", cfg->progress);
+    printLog(cfg, res);
+    printCheckpoints(cfg, res);
 }
 /*
- * A function for generating a given number of arrivals
- * into a priority queue
+ * A function to print where the event loop spent its time, in a
+ * build made with make PROFILE=1
  *
- * @param int lambda, the average number of arrivals per time unit
- * @param int n, the total number of arrivals
- * @param struct heap *h, the priority queue
+ * @param struct simResults *res, the results of the run
  *
+ * @local const char *names[], the name of each phase
  * @local int i, a counter
- * @local float temp, a random interval
+ * @local double run, the cycles of the whole event loop
  */
-void generateArrivals(int lambda, int n, struct heap *h) {
-    int i = h->theSize+1;
-    float temp;
-    while(numberOfCustomers < n && i<HEAPSIZE) {
-        temp = getNextRandomInterval((float)lambda);
-        totalTime += temp;      // keep track of absolute time
-        h->array[i] = newCustomer(totalTime, 1);
-        h->theSize++;           // increment size of priority queue
-        numberOfCustomers++;    // keep track of number of customers   
-        i++;
-    }
-    buildHeap(h);               // heapify, may be necessary if a departure event currently in priority queue has a lower priority pqTime than one of the added arrivals
+void printProfile(struct simResults *res) {
+    static const char *names[SIM_PHASES] = { "event loop", "arrivals", "departures", "event set",
+        "FIFO queue", "intervals", "refills" };
+    struct simProfile *p = &res->profile;
+    int i;
+    double run = (double) p->cycles[SIM_PHASE_RUN];
+    if(!p->enabled)
+        return;
+    printf("Printing profile...\n\n");
+    printf("%-12s %14s %12s %12s %8s\n", "phase", "cycles", "calls", "cycles/call", "share");
+    for(i=0;i<SIM_PHASES;i++)
+        printf("%-12s %14llu %12ld %12.1f %7.1f%%\n", names[i], (unsigned long long) p->cycles[i], p->calls[i],
+            p->calls[i] > 0 ? (double) p->cycles[i]/p->calls[i] : 0.0, run > 0 ? 100.0*p->cycles[i]/run : 0.0);
+    printf("Arrivals and departures include the event set, queue and interval phases they call\n");
+    printf("Peak events pending = %ld, peak customers waiting = %ld\n", p->peakEvents, p->peakQueue);
+    printf("Customer records allocated = %ld, peak live = %ld\n\n", res->allocations, res->peakCustomers);
 }
-/* 
- * A function for processing the next event in the priority queue
- * May be an arrival or a departure. May need to put an arrival
- * in a FIFO queue
- *
- * @param struct heap *h, the priority queue
- * @param struct FIFOqueue *q, the FIFO queue
- * @param int mu, the average number of customers to service per time unit
+/*
+ * A function to print how many customers were written to the log
  *
- * @local float temp, a random interval
- * @local float temp2, the difference between start of service time and arrival time
- * @local float idle, used to keep track of amount of idle time
- * @local struct customer *event, the event to process
- * @local struct customer *cust, a customer to process from FIFO queue
- * @local struct customer *check, used to check arrival time of next event in priority queue to keep track of idle time
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-void processNextEvent(struct heap *h, struct FIFOqueue *q, int mu, int m) {
-    float temp, temp2, idle;
-    struct customer *event;  
-    struct customer *cust;      
-    struct customer *check;
-    event = deleteMin(h);               // get next event from priority queue
-    if(event->departureTime < 0) {      // if arrival
-        if(serviceAvailable > 0) {
-            serviceAvailable--;
-            event->startOfServiceTime = event->arrivalTime;
-            temp = getNextRandomInterval((float)mu);
-            totalServiceTime += temp;   // keep track of total service time
-            event->departureTime = event->arrivalTime + temp;
-            event->pqTime = event->departureTime;
-            percolateUp(h,event);       // add event back to priority queue as departure event
-        } else {
-            enqueue(q,event);           // place in FIFO queue
-            numInQueue++;               // keep track of number of customers going into FIFO queue
-        }
-    } else {
-        serviceAvailable++;
-        if(serviceAvailable == m && getSize(q) == 0) {      // if all servers are available and FIFO is empty
-            check = getMin(h);                              // record idle time
-            idle = check->arrivalTime - event->departureTime;
-            idleTime += idle;
-        } 
-        if(getSize(q) > 0) {            // check if customer in FIFO queue
-            cust = dequeue(q);          // get next customer in FIFO queue
-            cust->startOfServiceTime = event->departureTime;
-            temp = getNextRandomInterval((float)mu);
-            totalServiceTime += temp;   // keep track of total service time
-            temp2 = cust->startOfServiceTime - cust->arrivalTime;
-            totalWaitTime += temp2;     // keep track of total wait time
-            cust->departureTime = cust->startOfServiceTime + temp;
-            cust->pqTime = cust->departureTime;
-            percolateUp(h,cust);        // add event back to priority queue as departure event
-            serviceAvailable--;
-        }
-        freeCustomer(event);        // free memory of event
-    }
+void printLog(struct simConfig *cfg, struct simResults *res) {
+    if(cfg->log == NULL)
+        return;
+    printf("Customers logged = %ld to %s%s\n\n", res->logged, cfg->log,
+        cfg->replications > 1 ? ".0 onwards" : "");
+    if(res->logged < res->customers)
+        fprintf(stderr, "unable to write every customer to %s\n", cfg->log);
 }
 /*
- * A function to call other functions to run the simulation
+ * A function to print where a run was restored and how many checkpoints it wrote
  *
- * @param int lambda, the average number of arrivals per time unit
- * @param int mu, the average number of customers to service per time unit
- * @param int m, the number of servers
- * @param int n, total number of arrivals to service
- *
- * @local int i, a counter
- * @local struct heap *h, the priority queue
- * @local struct FIFOqueue *q, the FIFO queue
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-void runSimulation(int lambda, int mu, int m, int n) {
-    int i;
-    struct heap *h = constructHeap(0, NULL);    // create priority queue
-    struct FIFOqueue *q = newQueue();           // create FIFO queue
-    generateArrivals(lambda, n, h);             // generate first arrivals
-    serviceAvailable = m;
-    for(i=0;i<m;i++)                            // process first m events
-        processNextEvent(h, q, mu, m);
-    while(h->theSize > 0) {
-        processNextEvent(h, q, mu, m);          // process events
-        if((numberOfCustomers < n) && (h->theSize <= m+1))
-            generateArrivals(lambda, n, h);     // add more events to priority queue when necessary
-    }
-    printPostCalc();        // print a posteriori statistics
-    freeHeap(h);            // free memory of priority queue
-    freeFIFOqueue(q);       // free memory of FIFO queue
+void printCheckpoints(struct simConfig *cfg, struct simResults *res) {
+    if(cfg->restore != NULL && res->restored >= 0)
+        printf("Restored at customer %ld from %s\n\n", res->restored, cfg->restore);
+    if(cfg->restore != NULL && res->restored < 0)
+        fprintf(stderr, "%s changed before it was restored, the run started over\n", cfg->restore);
+    if(cfg->checkpoint == NULL)
+        return;
+    printf("Checkpoints written = %ld to %s\n\n", res->checkpoints, cfg->checkpoint);
+    if(res->checkpoints == 0 && res->customers - res->restored >= cfg->checkpointEvery)
+        fprintf(stderr, "unable to write a checkpoint to %s\n", cfg->checkpoint);
 }
-/* 
- * A function to calculate Po
+/*
+ * A function to calculate and print a priori statistics for the simulation
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * 
- * @ local int i, j; counters
- * @ local float temp, temp, factorial, mfact, a, b, c, d, e, f;
- *   variables for compartmentalizing the equation for simplification
- * @ local float answer, the value to return
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
+ * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
  *
- * @return float, the value for Po
+ * @local struct analytic a, the statistics
  */
-float calculatePo(float lambda, float mu, float m) {
-    int i, j;
-    float temp, answer, factorial = 1, mfact =1;
-    for(i=0;i<=(m-1);i++) {     // calculate value for series (sigma i=M-1, i=0)(1/i!)(lambda/mu)^i
-        for(j=1;j<=i;j++) 
-            factorial *= (float)j;
-        temp += ((pow((lambda/mu),i))/factorial);                         
-    }
-    
-    for(j=1;j<=m;j++)           // calculate value for M!
-        mfact *= (float)j;   
-    
-    float a = 1.0/mfact;        // 1/M!
-    float b = lambda/mu;        // lambda/mu
-    float c = pow(b,m);         // (lamda/mu)^M
-    float d = m*mu;             // M*mu
-    float e = d-lambda;         // M*mu-lambda
-    float f = d/e;              // (M*mu)/(M*mu-lambda)
+void printPreCalc(double lambda, double mu, int m, long n) {
+    struct analytic a;
+    printf("\n");
+    printf("lambda = %g\n", lambda);
+    printf("mu = %g\n", mu);
+    printf("M = %d\n", m);
+    printf("\nPrinting a priori calculations...\n\n");
+
+    a = preCalc(lambda, mu, m);
+    printf("Po =  %5.4f\n", a.po);
+    printf("L = %5.4f\n", a.l);
+    printf("W = %5.4f\n", a.w);
+    printf("Lq = %5.4f\n", a.lq);
+    printf("Wq = %5.4f\n", a.wq);
+    printf("Rho = %5.4f\n", a.rho);
+    printf("P(wait) = %5.4f\n", a.pWait);
 
-    answer = (1.0/(temp+a*c*f));    //(1/((sigma i=M-1, i=0)(1/i!)(lambda/mu)^i)+1/M!(lamda/mu)^M(M*mu/M*mu-lambda)
-   
-    return answer;
 }
 /*
- * A function to calculate L
- * 
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * @param float po, the value of Po
+ * A function to print a posteriori statistics for the simulation
  *
- * @local int i, a counter
- * @local float fact, a, b, c, d, e;
- *  variables for compartmentalizing the equation for simplification
- * @local float answer, the value to return
- *
- * @return float, the value for L
+ * @param struct results *r, the statistics of the run
  */
-float calculateL(float lambda, float mu, float m, float po) {
-    int i;
-    float fact = 1, answer;
-    for(i=1;i<=(m-1);i++)           // calculate value for (M-1)!
-        fact *= (float)i;
-                           
-    float a = lambda*mu;            // lambda*mu
-    float b = lambda/mu;            // lambda/mu
-    float c = (m*mu)-lambda;        // M*mu-lambda
-    float d = pow(b,m);             // (lambda/mu)^M
-    float e = pow(c,2);             // (M*mu-lambda)^2
-    
-    answer = ((a*d)/(fact*e))*po+b; // ((lambda*mu)(lambda/mu)^M)/(M-1)!(M*mu-lambda)^2)*Po+lambda/mu
-
-    return answer;
+void printPostCalc(struct results *r) {
+    printf("\nPrinting a posteriori calculations...\n\n");
+    printf("Percentage of idle time (Po) = %5.4f\n", r->po);
+    printf("Average time spent in system (W) = %5.4f\n", r->w);
+    printf("Average time spent waiting in queue (Wq) = %5.4f\n", r->wq);
+    printf("Probability of having to wait for service = %5.4f\n", r->pWait);
+    printf("Probability of not having to wait for service = %5.4f\n", 1.0 - r->pWait);
+    printf("Average number in system (L) = %5.4f\n", r->l);
+    printf("Average number waiting in queue (Lq) = %5.4f\n", r->lq);
+    printf("Server utilization (Rho) = %5.4f\n\n", r->utilization);
 }
 /*
- * A function to calculate W
- * 
- * @param float lambda, the average number of arrivals per time unit
- * @param float l, the value for L
+ * A function to print the mean and confidence interval of one statistic
  *
- * @local float answer, the value to return
- *
- * @return float, the value for W
+ * @param const char *name, the label for the statistic
+ * @param double mean, the mean
+ * @param double h, the half-width of the interval
  */
-float calculateW(float lambda, float l) {
-    float answer;
-
-    answer = l/lambda;  // L/lambda
-    
-    return answer;
+static void printInterval(const char *name, double mean, double h) {
+    printf("%s = %5.4f +/- %5.4f  [%5.4f, %5.4f]\n", name, mean, h, mean - h, mean + h);
 }
 /*
- * A function to calculate Lq
+ * A function to print the mean and 95% confidence interval of each
+ * a posteriori statistic over several replications
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customer to service per time unit
- * @param float l, the value for L
+ * @param struct simResults *res, the results of the replications
+ */
+void printReplications(struct simResults *res) {
+    printf("\nPrinting a posteriori calculations over %d replications (mean +/- 95%% CI)...\n\n", res->replications);
+    printInterval("Percentage of idle time (Po)", res->mean.po, res->halfWidth.po);
+    printInterval("Average time spent in system (W)", res->mean.w, res->halfWidth.w);
+    printInterval("Average time spent waiting in queue (Wq)", res->mean.wq, res->halfWidth.wq);
+    printInterval("Probability of having to wait for service", res->mean.pWait, res->halfWidth.pWait);
+    printInterval("Average number in system (L)", res->mean.l, res->halfWidth.l);
+    printInterval("Average number waiting in queue (Lq)", res->mean.lq, res->halfWidth.lq);
+    printInterval("Server utilization (Rho)", res->mean.utilization, res->halfWidth.utilization);
+    printf("\n");
+    printReduction(&res->reduction);
+    printQuantiles(res);
+}
+/*
+ * A function to print how much antithetic pairs and control variates
+ * reduced the variance of each mean, if they were used
  *
- * @local float answer, the value to return
+ * @param struct results *r, the variance reduction of each statistic
+ */
+void printReduction(struct results *r) {
+    if(r->po == 1.0 && r->w == 1.0 && r->wq == 1.0 && r->pWait == 1.0 && r->l == 1.0 && r->lq == 1.0
+        && r->utilization == 1.0)
+        return;
+    printf("Variance reduction over independent replications (x):\n");
+    printf("Po %4.2f, W %4.2f, Wq %4.2f, P(wait) %4.2f, L %4.2f, Lq %4.2f, Rho %4.2f\n\n",
+        r->po, r->w, r->wq, r->pWait, r->l, r->lq, r->utilization);
+}
+/*
+ * A function to print the tail quantiles of the time in system and the
+ * time in queue over every customer of every replication
  *
- * @return float, the value or Lq
+ * @param struct simResults *res, the results of the run
  */
-float calculateLq(float lambda, float mu, float l) {
-    float answer;
-
-    answer = l - (lambda/mu);   // L-(lambda/mu
-
-    return answer;
+void printQuantiles(struct simResults *res) {
+    printf("Time spent in system (W) p95 = %5.4f p99 = %5.4f p99.9 = %5.4f\n", res->w.p95, res->w.p99, res->w.p999);
+    printf("Time spent waiting in queue (Wq) p95 = %5.4f p99 = %5.4f p99.9 = %5.4f\n\n", res->wq.p95, res->wq.p99, res->wq.p999);
 }
-/* 
- * A function to calculate Wq
+/*
+ * A function to print the simulated and a priori probability of each
+ * number in the system, up to where both tails are below 0.001
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float lq, the value for Lq
+ * @param struct simResults *res, the results of the run
  *
- * @local float answer, the value to return
+ * @local int n, the number in the system
+ * @local double simTail, the simulated probability of n or more
+ * @local double preTail, the a priori probability of n or more
+ */
+void printStates(struct simResults *res) {
+    int n;
+    double simTail = 1.0, preTail = 1.0;
+    printf("  n   P(n) simulated   P(n) a priori\n");
+    for(n=0;n<SIM_STATES-1 && (simTail >= 0.001 || preTail >= 0.001);n++) {
+        printf("%3d   %14.4f   %13.4f\n", n, res->pn[n], res->analyticPn[n]);
+        simTail -= res->pn[n];
+        preTail -= res->analyticPn[n];
+    }
+    printf(">=%-3d%15.4f   %13.4f\n\n", n, simTail > 0 ? simTail : 0.0, preTail > 0 ? preTail : 0.0);
+}
+/*
+ * A function to print where the stopping rule ended the replications
  *
- * @return float, the value for Wq
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-float calculateWq(float lambda, float lq) {
-    float answer;
-
-    answer = lq/lambda;     // Lq/lambda
-
-    return answer;
+void printStopping(struct simConfig *cfg, struct simResults *res) {
+    if(cfg->tolerance <= 0)
+        return;
+    printf("Stopped on %s at relative half-width %5.4f (tolerance %g) after %ld customers in %d replications\n\n",
+        cfg->stopOn == SIM_STOP_W ? "W" : "Wq", res->precision, cfg->tolerance, res->customers, res->replications);
 }
 /*
- * A function to calculate Rho
+ * A function to print how many customers were left out as warm-up
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * 
- * @local float answer, the value to return
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
+ */
+void printWarmup(struct simConfig *cfg, struct simResults *res) {
+    if(!cfg->warmup)
+        return;
+    printf("Warm-up truncated = %ld customers over %d replications (%ld per replication)\n\n",
+        res->truncated, res->replications, res->truncated / res->replications);
+}
+/*
+ * A function to print one statistic of a comparison of two numbers
+ * of servers
  *
- * @return float, the value for Rho
+ * @param const char *name, the label of the statistic
+ * @param double a, the mean with the first number of servers
+ * @param double b, the mean with the second number of servers
+ * @param double d, the mean difference
+ * @param double h, the half-width of the interval of the difference
+ * @param double reduction, the variance reduction of the difference
  */
-float calculateRho(float lambda, float mu, float m) {
-    float answer;
-
-    answer = lambda/(m*mu);     // lambda/(M*mu)
-
-    return answer;
+static void printDifference(const char *name, double a, double b, double d, double h, double reduction) {
+    printf("%-8s %10.4f %10.4f %11.4f +/- %6.4f %11.1fx\n", name, a, b, d, h, reduction);
 }
 /*
- * A function to calculate and print a priori statistics for the simulation
+ * A function to compare two numbers of servers with common random
+ * numbers and print the mean and interval of each difference
  *
- * @param int lambda, the average number of arrivals per time unit
- * @param int mu, the average number of customers to service per time unit
- * @param int m, the number of servers
- * @param int n, total number of arrivals to service
+ * @param struct simConfig *cfg, the run
+ * @param int m2, the number of servers to compare cfg->m with
  *
- * @local float po, the value for Po
- * @local float l, the value for L
- * @local float w, the value for W
- * @local float lq, the value for Lq
- * @local float wq, the value for Wq
- * @local floar rho, the value for Rho
+ * @local struct simComparison c, the comparison
  */
-void printPreCalc(int lambda, int mu, int m, int n) {
-    printf("\n");
-    printf("lambda = %d\n", lambda);
-    printf("mu = %d\n", mu);
-    printf("M = %d\n", m);
-    printf("\nPrinting a priori calculations...\n\n");
-
-    float po, l, w, lq, wq, rho;
-    po = calculatePo((float)lambda,(float)mu,(float)m);
-    l = calculateL((float)lambda, (float)mu, (float)m, po);
-    w = calculateW((float)lambda, l);
-    lq = calculateLq((float)lambda, (float)mu, l);
-    wq = calculateWq((float) lambda, lq);
-    rho = calculateRho((float)lambda, (float)mu, (float)m);
-    printf("Po =  %5.4f\n", po);
-    printf("L = %5.4f\n", l);
-    printf("W = %5.4f\n", w);
-    printf("Lq = %5.4f\n", lq);
-    printf("Wq = %5.4f\n", wq);
-    printf("Rho = %5.4f\n", rho);
-
+void printComparison(struct simConfig *cfg, int m2) {
+    struct simComparison c;
+    if(compareServers(cfg, m2, &c) != 0) {
+        fprintf(stderr, "lambda, mu, M and N must all be positive\n");
+        exit(1);
+    }
+    printf("\nlambda = %g\nmu = %g\n", cfg->lambda, cfg->mu);
+    printf("\nComparing M = %d with M = %d over %d replications with common random numbers...\n\n",
+        c.m[0], c.m[1], c.replications);
+    printf("%-8s %10s %10s %22s %12s\n", "", "M", "M2", "M - M2 (95% CI)", "reduction");
+    printDifference("Po", c.mean[0].po, c.mean[1].po, c.difference.po, c.halfWidth.po, c.reduction.po);
+    printDifference("W", c.mean[0].w, c.mean[1].w, c.difference.w, c.halfWidth.w, c.reduction.w);
+    printDifference("Wq", c.mean[0].wq, c.mean[1].wq, c.difference.wq, c.halfWidth.wq, c.reduction.wq);
+    printDifference("P(wait)", c.mean[0].pWait, c.mean[1].pWait, c.difference.pWait, c.halfWidth.pWait,
+        c.reduction.pWait);
+    printDifference("L", c.mean[0].l, c.mean[1].l, c.difference.l, c.halfWidth.l, c.reduction.l);
+    printDifference("Lq", c.mean[0].lq, c.mean[1].lq, c.difference.lq, c.halfWidth.lq, c.reduction.lq);
+    printDifference("Rho", c.mean[0].utilization, c.mean[1].utilization, c.difference.utilization,
+        c.halfWidth.utilization, c.reduction.utilization);
+    printf("\nreduction is the variance of the difference with independent streams over\n"
+        "its variance with common random numbers\n\n");
 }
 /*
- * A function to calculate and print a posteriori statistics for the simulation
+ * A function to find and print the fewest servers that meet waiting time targets
+ *
+ * @param struct simConfig *cfg, the run, cfg->m is ignored
+ * @param struct staffingTarget *target, the targets
  *
- * @local float f1, the new value for Po
- * @local float f2, the new value for W
- * @local float f3, the new value for Wq
- * @local float f4, the probability for having to wait for service
- * @local float f5, the probability for not having to wait for service
+ * @local struct staffingResult out, the answer
+ * @local int status, what optimizeStaffing() returned
  */
-void printPostCalc() {
-    printf("\nPrinting a posteriori calculations...\n\n");
-    float f1, f2, f3, f4, f5;    
-    f1 = idleTime/totalTime;
-    f2 = (totalWaitTime + totalServiceTime)/(float)numberOfCustomers;
-    f3 = totalWaitTime/(float)numberOfCustomers;
-    f4 = numInQueue/(float)numberOfCustomers;
-    f5 = 1.0 - f4;
-
-    printf("Percentage of idle time (Po) = %5.4f\n", f1);
-    printf("Average time spent in system (W) = %5.4f\n", f2);
-    printf("Average time spent waiting in queue (Wq) = %5.4f\n", f3);
-    printf("Probability of having to wait for service = %5.4f\n", f4);
-    printf("Probability of not having to wait for service = %5.4f\n\n", f5);
+void printStaffing(struct simConfig *cfg, struct staffingTarget *target) {
+    struct staffingResult out;
+    int status;
+    printf("\nlambda = %g\n", cfg->lambda);
+    printf("mu = %g\n", cfg->mu);
+    if(target->wq > 0)
+        printf("Target Wq < %g\n", target->wq);
+    if(target->pWait > 0)
+        printf("Target P(wait) < %g\n", target->pWait);
+    status = optimizeStaffing(cfg, target, &out);
+    if(status < 0) {
+        fprintf(stderr, "lambda, mu and N must all be positive\n");
+        exit(1);
+    }
+    if(status > 0) {
+        printf("\nNo M up to 4 times the Erlang C answer of %d meets the targets (%d replications)\n\n",
+            out.analyticM, out.replications);
+        return;
+    }
+    printf("\nFewest servers by Erlang C = %d\n", out.analyticM);
+    printf("Fewest servers by simulation = %d%s\n", out.m,
+        out.confirmed ? "" : " (M-1 undecided at the most replications)");
+    printf("Replications run = %d\n", out.replications);
+    printf("\nAt M = %d, Erlang C gives Wq = %5.4f and P(wait) = %5.4f\n", out.m, out.res.analytic.wq, out.res.analytic.pWait);
+    printReplications(&out.res);
 }
@@ -3,7 +3,8 @@
   File Name: simulation.h
   Simulation
 
-  Contains function prototypes, #defines, #includes for simulation.c
+  Contains function prototypes, #defines, #includes for simulation.c, the command line
+  program built on libsimulation
 ***************************************************************/
 
 #include <stdio.h>
@@ -11,9 +12,13 @@
 #include <math.h>
 #include <errno.h>
 #include <time.h>
-#include "customer.h"
-#include "heap.h"
-#include "FIFOqueue.h"
+#include <unistd.h>
+#include "libsimulation.h"
+#include "eventset.h"
+#include "variate.h"
+#include "sweep.h"
+#include "server.h"
+#include "network.h"
 
 #ifndef _simulation_h
 #define _simulation_h
@@ -23,118 +28,110 @@
  */
 #define STATS 4
 /*
- * The size of buffer to hold values of stats from value
+ * The size of buffer to hold values of stats from value, long enough for a 64 bit seed
  */
-#define BUFFER_SIZE 10
+#define BUFFER_SIZE 32
 
 /*
- * A function for generating a random time interval.
- * 
- * @param float avg, either lambda or mu
+ * A function to run the simulation described by a config and print
+ * the a priori and a posteriori statistics
  *
- * @return float, the average time interval 
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, where to store the results
  */
-float getNextRandomInterval(float avg);
+void printRun(struct simConfig *cfg, struct simResults *res);
 /*
- * A function for generating a given number of arrivals
- * into a priority queue
- *
- * @param int lambda, the average number of arrivals per time unit
- * @param int n, the total number of arrivals
- * @param struct heap *h, the priority queue
- */
-void generateArrivals(int lambda, int n, struct heap *h);
-/* 
- * A function for processing the next event in the priority queue
- * May be an arrival or a departure. May need to put an arrival
- * in a FIFO queue
+ * A function to calculate and print a priori statistics for the simulation
  *
- * @param struct heap *h, the priority queue
- * @param struct FIFOqueue *q, the FIFO queue
- * @param int mu, the average number of customers to service per time unit
+ * @param double lambda, the average number of arrivals per time unit
+ * @param double mu, the average number of customers to service per time unit
  * @param int m, the number of servers
+ * @param long n, total number of arrivals to service
  */
-void processNextEvent(struct heap *h, struct FIFOqueue *q, int mu, int m);
+void printPreCalc(double lambda, double mu, int m, long n);
 /*
- * A function to call other functions to run the simulation
+ * A function to print a posteriori statistics for the simulation
  *
- * @param int lambda, the average number of arrivals per time unit
- * @param int mu, the average number of customers to service per time unit
- * @param int m, the number of servers
- * @param int n, total number of arrivals to service
+ * @param struct results *r, the statistics of the run
  */
-void runSimulation(int lambda, int mu, int m, int n);
-/* 
- * A function to calculate Po
+void printPostCalc(struct results *r);
+/*
+ * A function to print the mean and 95% confidence interval of each
+ * a posteriori statistic over several replications
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * 
- * @return float, the value for Po
- */
-float calculatePo(float lambda, float mu, float m);
-/*
- * A function to calculate L
- * 
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * @param float po, the value of Po
+ * @param struct simResults *res, the results of the replications
+ */
+void printReplications(struct simResults *res);
+/*
+ * A function to print how much antithetic pairs and control variates
+ * reduced the variance of each mean, if they were used
  *
- * @return float, the value for L
+ * @param struct results *r, the variance reduction of each statistic
  */
-float calculateL(float lambda, float mu, float m, float po);
+void printReduction(struct results *r);
 /*
- * A function to calculate W
- * 
- * @param float lambda, the average number of arrivals per time unit
- * @param float l, the value for L
+ * A function to print the tail quantiles of the time in system and the
+ * time in queue over every customer of every replication
  *
- * @return float, the value for W
+ * @param struct simResults *res, the results of the run
  */
-float calculateW(float lambda, float l);
+void printQuantiles(struct simResults *res);
 /*
- * A function to calculate Lq
+ * A function to print the simulated and a priori probability of each
+ * number in the system, up to where both tails are below 0.001
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customer to service per time unit
- * @param float l, the value for L
+ * @param struct simResults *res, the results of the run
+ */
+void printStates(struct simResults *res);
+/*
+ * A function to print where the stopping rule ended the replications
  *
- * @return float, the value or Lq
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-float calculateLq(float lambda, float mu, float l);
-/* 
- * A function to calculate Wq
+void printStopping(struct simConfig *cfg, struct simResults *res);
+/*
+ * A function to print how many customers were left out as warm-up
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float lq, the value for Lq
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
+ */
+void printWarmup(struct simConfig *cfg, struct simResults *res);
+/*
+ * A function to print where the event loop spent its time, in a
+ * build made with make PROFILE=1
  *
- * @return float, the value for Wq
+ * @param struct simResults *res, the results of the run
  */
-float calculateWq(float lambda, float lq);
+void printProfile(struct simResults *res);
 /*
- * A function to calculate Rho
+ * A function to print how many customers were written to the log
  *
- * @param float lambda, the average number of arrivals per time unit
- * @param float mu, the average number of customers to service per time unit
- * @param float m, the number of servers
- * 
- * @return float, the value for Rho
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-float calculateRho(float lambda, float mu, float m);
+void printLog(struct simConfig *cfg, struct simResults *res);
 /*
- * A function to calculate and print a priori statistics for the simulation
+ * A function to print where a run was restored and how many checkpoints it wrote
  *
- * @param int lambda, the average number of arrivals per time unit
- * @param int mu, the average number of customers to service per time unit
- * @param int m, the number of servers
- * @param int n, total number of arrivals to service
+ * @param struct simConfig *cfg, the run
+ * @param struct simResults *res, the results of the run
  */
-void printPreCalc(int lambda, int mu, int m, int n);
+void printCheckpoints(struct simConfig *cfg, struct simResults *res);
 /*
- * A function to calculate and print a posteriori statistics for the simulation
+ * A function to compare two numbers of servers with common random
+ * numbers and print the mean and interval of each difference
+ *
+ * @param struct simConfig *cfg, the run
+ * @param int m2, the number of servers to compare cfg->m with
+ */
+void printComparison(struct simConfig *cfg, int m2);
+/*
+ * A function to find and print the fewest servers that meet waiting time targets
+ *
+ * @param struct simConfig *cfg, the run, cfg->m is ignored
+ * @param struct staffingTarget *target, the targets
  */
-void printPostCalc();
+void printStaffing(struct simConfig *cfg, struct staffingTarget *target);
 
 #endif
@@ -0,0 +1,104 @@
+/***************************************************************
+  Paul Lewis
+  File Name: simwatch.c
+  Simulation
+
+  A program for watching a running simulation that publishes its
+  progress with -P name. It maps the shared memory read only and
+  prints a snapshot of every replication at an interval, without
+  ever making the simulation wait
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <signal.h>
+#include <unistd.h>
+#include "progress.h"
+
+/*
+ * A function to print the snapshot of one replication
+ *
+ * @param int rep, the replication
+ * @param const struct progressSnapshot *s, the snapshot
+ */
+static void printSnapshot(int rep, const struct progressSnapshot *s) {
+    if(!s->started) {
+        printf("%4d %10s\n", rep, "waiting");
+        return;
+    }
+    printf("%4d %10s %14.2f %12lld %12lld %6.1f%% %12.0f %7d %7d %9.4f %9.4f %7.4f %9.1f\n", rep,
+        s->done ? "done" : "running", s->clock, (long long) s->customers, (long long) s->target,
+        s->target > 0 ? 100.0*s->customers/s->target : 0.0, s->eventsPerSec, s->queue, s->inSystem,
+        s->w, s->wq, s->po, s->elapsed);
+}
+/*
+ * A program to watch the progress of a running simulation
+ *
+ * @param int argc, the number of command line arguments
+ * @param char *argv[], the command line arguments, -n seconds between
+ *  snapshots, -1 to print them once, and the name given to -P
+ *
+ * @local struct progress *pr, the progress segment
+ * @local struct progressSnapshot s, a snapshot
+ * @local double seconds, the time between snapshots
+ * @local int once, boolean, whether to print them once
+ * @local int opt, the command line option being read
+ * @local int i, a counter
+ * @local int done, the replications finished
+ * @local int alive, boolean, whether the process is still running
+ *
+ * @return 0, or 1 if the process ended before its replications finished
+ */
+int main(int argc, char *argv[]) {
+    struct progress *pr;
+    struct progressSnapshot s;
+    double seconds = 1.0;
+    int once = 0, opt, i, done, alive;
+    while((opt = getopt(argc, argv, "n:1")) != -1) {
+        if(opt == 'n' && (seconds = atof(optarg)) > 0)
+            continue;
+        if(opt == '1') {
+            once = 1;
+            continue;
+        }
+        fprintf(stderr, "usage: %s [-n seconds] [-1] name\n", argv[0]);
+        exit(1);
+    }
+    if(optind != argc - 1) {
+        fprintf(stderr, "usage: %s [-n seconds] [-1] name\n", argv[0]);
+        exit(1);
+    }
+    if((pr = attachProgress(argv[optind])) == NULL) {
+        fprintf(stderr, "no simulation is publishing to %s: %s\n", argv[optind], strerror(errno));
+        exit(1);
+    }
+    printf("pid %lld, lambda = %g, mu = %g, M = %d, %u replications\n", (long long) pr->head->pid,
+        pr->head->lambda, pr->head->mu, pr->head->m, pr->head->slots);
+    for(;;) {
+        printf("\n%4s %10s %14s %12s %12s %7s %12s %7s %7s %9s %9s %7s %9s\n", "rep", "state", "clock",
+            "customers", "of", "", "events/s", "queue", "system", "W", "Wq", "Po", "seconds");
+        done = 0;
+        for(i=0;i<(int)pr->head->slots;i++) {
+            if(readProgress(pr, i, &s) != 0) {
+                printf("%4d %10s\n", i, "busy");
+                continue;
+            }
+            printSnapshot(i, &s);
+            done += s.done;
+        }
+        fflush(stdout);
+        alive = kill((pid_t) pr->head->pid, 0) == 0 || errno != ESRCH;
+        if(once || done == (int)pr->head->slots || !alive)
+            break;
+        usleep((useconds_t) (seconds*1e6));
+    }
+    if(!once && done < (int)pr->head->slots) {
+        fprintf(stderr, "the simulation ended before every replication finished\n");
+        pr = closeProgress(pr);
+        return 1;
+    }
+    pr = closeProgress(pr);
+    return 0;
+}
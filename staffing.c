@@ -0,0 +1,419 @@
+/***************************************************************
+  Paul Lewis
+  File Name: staffing.c
+  Simulation
+
+  Finds the smallest number of servers M that meets a waiting
+  time SLA. Erlang C brackets M, then M and M-1 are simulated
+  side by side with replications added only while a confidence
+  interval still straddles the target. Every M uses the same
+  streams for replication r, so neighbouring M are compared
+  with common random numbers
+***************************************************************/
+
+#include <string.h>
+#include "model.h"
+#include "erlang.h"
+#include "staffing.h"
+#include "stats.h"
+#include "threadpool.h"
+
+/*
+ * What the replications so far say about a server count
+ */
+#define STAFFING_UNSURE 0
+#define STAFFING_MEETS 1
+#define STAFFING_FAILS 2
+
+/*
+ * The replications run for one server count
+ */
+struct candidate {
+    int reps;                       // the number of replications summarized
+    struct summary po, w, wq, pWait, l, lq, utilization;
+    double pn[SIM_STATES];          // summed over the replications
+    long customers;
+    double precision;               // the largest any replication stopped at
+    long truncated;
+    struct histogram *wHist;        // every customer of every replication
+    struct histogram *wqHist;
+    long peakCustomers;
+    long allocations;
+};
+
+/*
+ * One replication for one server count, filled in by a worker thread
+ */
+struct staffingJob {
+    const struct simConfig *cfg;
+    struct candidate *c;
+    pthread_mutex_t *lock;          // guards the histograms of every candidate
+    int m;
+    int rep;
+    struct results r;
+    double pn[SIM_STATES];
+    long customers;
+    double precision;
+    long truncated;
+    long peakCustomers;
+    long allocations;
+};
+
+/*
+ * A function run by a worker thread for one replication
+ *
+ * @param void *arg, the struct staffingJob to run
+ *
+ * @local struct staffingJob *job, the replication
+ * @local struct simulation *sim, the run
+ */
+static void staffingReplicate(void *arg) {
+    struct staffingJob *job = (struct staffingJob *) arg;
+    const struct simConfig *cfg = job->cfg;
+    struct simulation *sim;
+    sim = newSimulation(cfg->lambda, cfg->mu, job->m, cfg->n, cfg->engine, cfg->method, cfg->seed, job->rep);
+    applyConfig(sim, cfg, job->rep);
+    runSimulation(sim);
+    job->r = postCalc(sim);
+    fillStates(sim, job->pn);
+    job->customers = sim->numberOfCustomers;
+    job->precision = runPrecision(sim);
+    job->truncated = sim->truncated;
+    job->peakCustomers = sim->p->peakLive;
+    job->allocations = sim->p->allocations;
+    pthread_mutex_lock(job->lock);
+    mergeHistogram(job->c->wHist, sim->wHist);
+    mergeHistogram(job->c->wqHist, sim->wqHist);
+    pthread_mutex_unlock(job->lock);
+    freeSimulation(sim);
+}
+/*
+ * A function to run more replications for up to two server counts at once
+ * and add them to their summaries in replication order
+ *
+ * @param struct threadPool *tp, the workers
+ * @param pthread_mutex_t *lock, guards the histograms of the candidates
+ * @param const struct simConfig *cfg, the run
+ * @param struct candidate *c[], the candidates, NULL entries are skipped
+ * @param int m[], the server count of each candidate
+ * @param int upto[], the number of replications each should have afterwards
+ *
+ * @local int i, k, n, counters
+ * @local int total, the number of new replications
+ * @local struct staffingJob *jobs, the new replications
+ * @local struct candidate *cd, a candidate
+ */
+static void extend(struct threadPool *tp, pthread_mutex_t *lock, const struct simConfig *cfg, struct candidate *c[2], int m[2], int upto[2]) {
+    int i, k, n, total = 0;
+    struct staffingJob *jobs;
+    struct candidate *cd;
+    for(i=0;i<2;i++)
+        if(c[i] != NULL && upto[i] > c[i]->reps)
+            total += upto[i] - c[i]->reps;
+    if(total == 0)
+        return;
+    jobs = (struct staffingJob *) malloc(total * sizeof(struct staffingJob));
+    if(jobs == NULL) {
+        perror("malloc error. cannot create replications.\n");
+        exit(1);
+    }
+    total = 0;
+    for(i=0;i<2;i++) {
+        if(c[i] == NULL)
+            continue;
+        for(k=c[i]->reps;k<upto[i];k++) {
+            jobs[total].cfg = cfg;
+            jobs[total].c = c[i];
+            jobs[total].lock = lock;
+            jobs[total].m = m[i];
+            jobs[total].rep = k;
+            submitTask(tp, staffingReplicate, &jobs[total]);
+            total++;
+        }
+    }
+    waitThreadPool(tp);
+    total = 0;
+    for(i=0;i<2;i++) {
+        cd = c[i];
+        if(cd == NULL)
+            continue;
+        for(k=cd->reps;k<upto[i];k++,total++) {
+            addSample(&cd->po, jobs[total].r.po);
+            addSample(&cd->w, jobs[total].r.w);
+            addSample(&cd->wq, jobs[total].r.wq);
+            addSample(&cd->pWait, jobs[total].r.pWait);
+            addSample(&cd->l, jobs[total].r.l);
+            addSample(&cd->lq, jobs[total].r.lq);
+            addSample(&cd->utilization, jobs[total].r.utilization);
+            for(n=0;n<SIM_STATES;n++)
+                cd->pn[n] += jobs[total].pn[n];
+            cd->customers += jobs[total].customers;
+            cd->truncated += jobs[total].truncated;
+            if(jobs[total].precision > cd->precision)
+                cd->precision = jobs[total].precision;
+            if(jobs[total].peakCustomers > cd->peakCustomers)
+                cd->peakCustomers = jobs[total].peakCustomers;
+            if(jobs[total].allocations > cd->allocations)
+                cd->allocations = jobs[total].allocations;
+        }
+        if(upto[i] > cd->reps)
+            cd->reps = upto[i];
+    }
+    free(jobs);
+}
+/*
+ * A function to judge a candidate against the targets
+ * It meets them when every interval lies below its target and fails
+ * when any interval lies above
+ *
+ * @param struct candidate *c, the candidate
+ * @param const struct staffingTarget *target, the targets
+ *
+ * @local int meets, fails, booleans
+ * @local double h, a half-width
+ *
+ * @return int, STAFFING_MEETS, STAFFING_FAILS or STAFFING_UNSURE
+ */
+static int verdict(struct candidate *c, const struct staffingTarget *target) {
+    int meets = 1, fails = 0;
+    double h;
+    if(target->wq > 0) {
+        h = halfWidth95(&c->wq);
+        meets = meets && c->wq.mean + h < target->wq;
+        fails = fails || c->wq.mean - h > target->wq;
+    }
+    if(target->pWait > 0) {
+        h = halfWidth95(&c->pWait);
+        meets = meets && c->pWait.mean + h < target->pWait;
+        fails = fails || c->pWait.mean - h > target->pWait;
+    }
+    return fails ? STAFFING_FAILS : meets ? STAFFING_MEETS : STAFFING_UNSURE;
+}
+/*
+ * A function to find the fewest servers the Erlang C values say meet the targets
+ *
+ * @param const struct simConfig *cfg, the rates
+ * @param const struct staffingTarget *target, the targets
+ * @param int mLow, the fewest servers for a stable queue
+ *
+ * @local int lo, hi, the range of M searched
+ * @local int i, a counter
+ * @local struct analytic *a, the values for M from lo to hi
+ *
+ * @return int, the number of servers
+ */
+static int analyticStaffing(const struct simConfig *cfg, const struct staffingTarget *target, int mLow) {
+    int lo = mLow, hi = 2 * mLow, i;
+    struct analytic *a;
+    for(;;) {
+        a = (struct analytic *) malloc((hi - lo + 1) * sizeof(struct analytic));
+        if(a == NULL) {
+            perror("malloc error. cannot create staffing table.\n");
+            exit(1);
+        }
+        erlangBatch(&cfg->lambda, &cfg->mu, 1, lo, hi, a);
+        for(i=0;i<=hi-lo;i++) {
+            if((target->wq <= 0 || a[i].wq < target->wq) && (target->pWait <= 0 || a[i].pWait < target->pWait)) {
+                free(a);
+                return lo + i;
+            }
+        }
+        free(a);
+        lo = hi + 1;
+        hi *= 2;
+    }
+}
+/*
+ * A function to get the candidate for a server count, growing the table
+ *
+ * @param struct candidate **table, the candidates from mLow up
+ * @param int *size, the number of entries in the table
+ * @param int index, the server count less mLow
+ *
+ * @local int newSize, the size of the grown table
+ *
+ * @return struct candidate *, the candidate
+ */
+static struct candidate *candidateFor(struct candidate **table, int *size, int index) {
+    int newSize;
+    if(index >= *size) {
+        newSize = 2 * index + 2;
+        *table = (struct candidate *) realloc(*table, newSize * sizeof(struct candidate));
+        if(*table == NULL) {
+            perror("realloc error. cannot grow staffing table.\n");
+            exit(1);
+        }
+        memset(*table + *size, 0, (newSize - *size) * sizeof(struct candidate));
+        *size = newSize;
+    }
+    if((*table)[index].wHist == NULL) {
+        (*table)[index].wHist = newHistogram();
+        (*table)[index].wqHist = newHistogram();
+    }
+    return *table + index;
+}
+/*
+ * A function to free a table of candidates
+ *
+ * @param struct candidate *table, the candidates
+ * @param int size, the number of entries in the table
+ *
+ * @local int i, a counter
+ */
+static void freeCandidates(struct candidate *table, int size) {
+    int i;
+    for(i=0;i<size;i++) {
+        freeHistogram(table[i].wHist);
+        freeHistogram(table[i].wqHist);
+    }
+    free(table);
+}
+/*
+ * A function to replicate up to two candidates until each has a verdict
+ * or the most replications, doubling the replications of the unsure ones
+ *
+ * @param struct threadPool *tp, the workers
+ * @param pthread_mutex_t *lock, guards the histograms of the candidates
+ * @param const struct simConfig *cfg, the run
+ * @param const struct staffingTarget *target, the targets
+ * @param struct candidate *c[], the candidates, a NULL entry is skipped
+ * @param int m[], the server count of each candidate
+ * @param int reps, the replications a candidate starts with
+ * @param int v[], the verdict of each candidate
+ *
+ * @local int i, a counter
+ * @local int upto[], the replications to extend each candidate to
+ * @local int more, boolean, whether any candidate needs more
+ */
+static void settle(struct threadPool *tp, pthread_mutex_t *lock, const struct simConfig *cfg, const struct staffingTarget *target,
+        struct candidate *c[2], int m[2], int reps, int v[2]) {
+    int i, upto[2], more;
+    for(i=0;i<2;i++)
+        upto[i] = c[i] != NULL && c[i]->reps < reps ? reps : 0;
+    extend(tp, lock, cfg, c, m, upto);
+    for(;;) {
+        more = 0;
+        for(i=0;i<2;i++) {
+            upto[i] = 0;
+            v[i] = c[i] != NULL ? verdict(c[i], target) : STAFFING_FAILS;
+            if(v[i] == STAFFING_UNSURE && c[i]->reps < STAFFING_MAX_REPS) {
+                upto[i] = 2 * c[i]->reps < STAFFING_MAX_REPS ? 2 * c[i]->reps : STAFFING_MAX_REPS;
+                more = 1;
+            }
+        }
+        if(!more)
+            return;
+        extend(tp, lock, cfg, c, m, upto);
+    }
+}
+/*
+ * A function to find the smallest number of servers that meets the
+ * targets, Wq below target->wq and P(wait) below target->pWait
+ * A target of 0 is not used. cfg->m is ignored
+ *
+ * @param const struct simConfig *cfg, the run, cfg->replications is the
+ *  number each server count starts with
+ * @param const struct staffingTarget *target, the targets
+ * @param struct staffingResult *out, where to store the result
+ *
+ * @local int i, a counter
+ * @local int mLow, the fewest servers for a stable queue
+ * @local int mHigh, the most servers tried before giving up
+ * @local int m, the server count being confirmed
+ * @local int reps, the replications a server count starts with
+ * @local int ms[], the server counts M and M-1
+ * @local int v[], the verdicts for M and M-1
+ * @local int size, the number of entries in the table
+ * @local struct candidate *table, the candidates from mLow up
+ * @local struct candidate *c[], the candidates M and M-1
+ * @local struct threadPool *tp, the workers
+ * @local pthread_mutex_t lock, guards the histograms of the candidates
+ * @local struct simConfig probe, the config with one server, to validate, and
+ *  without antithetic pairs or controls, to run, as M and M-1 already share
+ *  common random numbers and are compared replication by replication
+ *
+ * @return int, 0, 1 if no M up to STAFFING_SPAN times the Erlang C answer
+ *  meets the targets, or -1 if the config or targets are invalid
+ */
+int optimizeStaffing(const struct simConfig *cfg, const struct staffingTarget *target, struct staffingResult *out) {
+    int i, mLow, mHigh, m, reps, ms[2], v[2], size = 0;
+    struct candidate *table = NULL, *c[2];
+    struct threadPool *tp;
+    pthread_mutex_t lock = PTHREAD_MUTEX_INITIALIZER;
+    struct simConfig probe = *cfg;
+    probe.m = 1;
+    probe.antithetic = 0;
+    probe.control = 0;
+    if(!validConfig(&probe) || (target->wq <= 0 && target->pWait <= 0))
+        return -1;
+    mLow = (int) floor(cfg->lambda / cfg->mu) + 1;
+    reps = cfg->replications >= 2 ? cfg->replications : STAFFING_REPS;
+    out->analyticM = analyticStaffing(cfg, target, mLow);
+    out->replications = 0;
+    mHigh = STAFFING_SPAN * out->analyticM;
+    tp = newThreadPool(cfg->threads);
+    m = out->analyticM;
+    while(m <= mHigh) {
+        ms[0] = m;
+        ms[1] = m - 1;
+        c[0] = candidateFor(&table, &size, m - mLow);   // grows the table before c[1] points into it
+        c[1] = m - 1 >= mLow ? candidateFor(&table, &size, m - 1 - mLow) : NULL;
+        settle(tp, &lock, &probe, target, c, ms, reps, v);
+        if(v[0] != STAFFING_MEETS) {    // unsure at the limit counts as failing
+            m++;
+            continue;
+        }
+        if(v[1] == STAFFING_MEETS) {
+            m--;
+            continue;
+        }
+        break;
+    }
+    tp = freeThreadPool(tp);
+    for(i=0;i<size;i++)
+        out->replications += table[i].reps;
+    if(m > mHigh) {
+        out->m = 0;
+        out->confirmed = 0;
+        freeCandidates(table, size);
+        return 1;
+    }
+    c[0] = table + (m - mLow);
+    out->m = m;
+    out->confirmed = v[1] == STAFFING_FAILS;
+    out->res.analytic = erlangC(cfg->lambda, cfg->mu, m);
+    out->res.replications = c[0]->reps;
+    out->res.mean.po = c[0]->po.mean;
+    out->res.mean.w = c[0]->w.mean;
+    out->res.mean.wq = c[0]->wq.mean;
+    out->res.mean.pWait = c[0]->pWait.mean;
+    out->res.halfWidth.po = halfWidth95(&c[0]->po);
+    out->res.halfWidth.w = halfWidth95(&c[0]->w);
+    out->res.halfWidth.wq = halfWidth95(&c[0]->wq);
+    out->res.halfWidth.pWait = halfWidth95(&c[0]->pWait);
+    for(i=0;i<RESULT_STATS;i++)
+        *resultStat(&out->res.reduction, i) = 1.0;
+    out->res.mean.l = c[0]->l.mean;
+    out->res.mean.lq = c[0]->lq.mean;
+    out->res.mean.utilization = c[0]->utilization.mean;
+    out->res.halfWidth.l = halfWidth95(&c[0]->l);
+    out->res.halfWidth.lq = halfWidth95(&c[0]->lq);
+    out->res.halfWidth.utilization = halfWidth95(&c[0]->utilization);
+    for(i=0;i<SIM_STATES;i++)
+        out->res.pn[i] = c[0]->pn[i]/c[0]->reps;
+    erlangStates(cfg->lambda, cfg->mu, m, out->res.analytic.po, out->res.analyticPn, SIM_STATES);
+    out->res.customers = c[0]->customers;
+    out->res.precision = c[0]->precision;
+    out->res.truncated = c[0]->truncated;
+    out->res.logged = 0;                // staffing runs are not logged
+    out->res.restored = 0;              // nor checkpointed
+    out->res.checkpoints = 0;
+    memset(&out->res.profile, 0, sizeof(out->res.profile));  // nor profiled
+    out->res.published = 0;             // nor published
+    fillQuantiles(&out->res.w, c[0]->wHist);
+    fillQuantiles(&out->res.wq, c[0]->wqHist);
+    out->res.peakCustomers = c[0]->peakCustomers;
+    out->res.allocations = c[0]->allocations;
+    freeCandidates(table, size);
+    return 0;
+}
@@ -0,0 +1,25 @@
+/***************************************************************
+  Paul Lewis
+  File Name: staffing.h
+  Simulation
+
+  Contains #defines and #includes for staffing.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _staffing_h
+#define _staffing_h
+
+/*
+ * The replications each server count starts with when the config asks
+ * for fewer than two, and the most any server count is given
+ */
+#define STAFFING_REPS 8
+#define STAFFING_MAX_REPS 512
+/*
+ * The search gives up past STAFFING_SPAN times the Erlang C answer
+ */
+#define STAFFING_SPAN 4
+
+#endif
@@ -0,0 +1,328 @@
+/***************************************************************
+  Paul Lewis
+  File Name: stats.c
+  Simulation
+
+  Contains functions for summarizing samples and computing
+  confidence intervals
+***************************************************************/
+
+#include "stats.h"
+
+/*
+ * The 97.5% quantiles of Student's t distribution for 1 to 30 degrees of freedom
+ */
+static const double tTable[30] = {
+    12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+    2.201, 2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+    2.080, 2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
+
+/*
+ * A function to initialize an empty summary
+ *
+ * @param struct summary *s, the summary
+ */
+void initSummary(struct summary *s) {
+    s->count = 0;
+    s->mean = 0.0;
+    s->m2 = 0.0;
+}
+/*
+ * A function to add an observation to a summary
+ *
+ * @param struct summary *s, the summary
+ * @param double x, the observation
+ *
+ * @local double delta, the distance from the old mean
+ */
+void addSample(struct summary *s, double x) {
+    double delta = x - s->mean;
+    s->count++;
+    s->mean += delta/s->count;
+    s->m2 += delta*(x - s->mean);
+}
+/*
+ * A function to return the sample variance of a summary
+ *
+ * @param struct summary *s, the summary
+ *
+ * @return double, the variance, 0 with fewer than two observations
+ */
+double summaryVariance(struct summary *s) {
+    if(s->count < 2)
+        return 0.0;
+    return s->m2/(s->count - 1);
+}
+/*
+ * A function to return the half-width of a 95% confidence interval for the mean
+ *
+ * @param struct summary *s, the summary
+ *
+ * @return double, the half-width, 0 with fewer than two observations
+ */
+double halfWidth95(struct summary *s) {
+    if(s->count < 2)
+        return 0.0;
+    return tQuantile975(s->count - 1)*sqrt(summaryVariance(s)/s->count);
+}
+/*
+ * A function to initialize empty batch means
+ *
+ * @param struct batchMeans *b, the batch means
+ * @param long size, the observations in a batch before the first merge
+ */
+void initBatchMeans(struct batchMeans *b, long size) {
+    b->batches = 0;
+    b->first = size;
+    b->size = size;
+    b->inBatch = 0;
+    b->current = 0.0;
+}
+/*
+ * A function to add an observation to batch means
+ *
+ * @param struct batchMeans *b, the batch means
+ * @param double x, the observation
+ *
+ * @local int i, a counter
+ *
+ * @return int, boolean, whether a batch was completed
+ */
+int addBatchSample(struct batchMeans *b, double x) {
+    int i;
+    b->current += x;
+    if(++b->inBatch < b->size)
+        return 0;
+    b->sums[b->batches++] = b->current;
+    b->current = 0.0;
+    b->inBatch = 0;
+    if(b->batches == BATCH_COUNT) {     // merge neighbours and double the batch size
+        for(i=0;i<BATCH_COUNT/2;i++)
+            b->sums[i] = b->sums[2*i] + b->sums[2*i+1];
+        b->batches = BATCH_COUNT/2;
+        b->size *= 2;
+    }
+    return 1;
+}
+/*
+ * A function to return the half-width of a 95% confidence interval for
+ * the mean over the full batches, relative to the mean
+ *
+ * @param const struct batchMeans *b, the batch means
+ *
+ * @local int i, a counter
+ * @local struct summary s, the summary of the batch means
+ *
+ * @return double, the relative half-width, INFINITY until the batches
+ *  have been merged once or while the mean is 0
+ */
+double batchPrecision(const struct batchMeans *b) {
+    int i;
+    struct summary s;
+    if(b->size == b->first)
+        return INFINITY;
+    initSummary(&s);
+    for(i=0;i<b->batches;i++)
+        addSample(&s, b->sums[i]/b->size);
+    if(s.mean == 0.0)
+        return INFINITY;
+    return halfWidth95(&s)/fabs(s.mean);
+}
+/*
+ * A function to initialize an empty MSER-5 rule
+ *
+ * @param struct mser *m, the rule
+ */
+void initMser(struct mser *m) {
+    m->batches = 0;
+    m->inBatch = 0;
+    m->current = 0.0;
+    m->sum = 0.0;
+    m->sumSquares = 0.0;
+    m->marks = 0;
+    m->next = 1;
+}
+/*
+ * A function to add an observation to an MSER-5 rule
+ *
+ * @param struct mser *m, the rule
+ * @param double x, the observation
+ *
+ * @local double mean, the mean of a full batch
+ *
+ * @return int, boolean, whether a candidate point was marked, the last of m->at
+ */
+int addMserSample(struct mser *m, double x) {
+    double mean;
+    m->current += x;
+    if(++m->inBatch < MSER_SIZE)
+        return 0;
+    mean = m->current/MSER_SIZE;
+    m->sum += mean;
+    m->sumSquares += mean*mean;
+    m->current = 0.0;
+    m->inBatch = 0;
+    if(++m->batches < m->next || m->marks == MSER_MARKS)
+        return 0;
+    m->at[m->marks] = m->batches;
+    m->atSum[m->marks] = m->sum;
+    m->atSumSquares[m->marks++] = m->sumSquares;
+    if(m->next == 1)
+        m->next = 2;
+    else if((m->next & (m->next - 1)) == 0)     // 2^k, then 3 2^(k-1)
+        m->next = m->next/2*3;
+    else                                        // 3 2^(k-1), then 2^(k+1)
+        m->next = m->next/3*4;
+    return 1;
+}
+/*
+ * A function to find the truncation point of MSER-5: of no deletion and
+ * the candidate points, the number of leading batches whose deletion
+ * minimizes the variance of the remaining batch means divided by their
+ * count squared
+ * The sums of the kept means and their squares are the totals less
+ * those marked, so every candidate is tried in one pass
+ *
+ * @param const struct mser *m, the rule
+ *
+ * @local int j, a counter, -1 for no deletion
+ * @local long d, the batches deleted
+ * @local long best, the deletion with the smallest statistic
+ * @local double s1, s2, the sum of the kept means and of their squares
+ * @local double k, the number of kept batches
+ * @local double stat, the MSER statistic of a deletion
+ * @local double min, the smallest statistic
+ *
+ * @return long, the observations to delete, or -1 while the best
+ *  deletion is past the first half of the batches and so not yet settled
+ */
+long mserTruncation(const struct mser *m) {
+    int j;
+    long d, best = -1;
+    double s1, s2, k, stat, min = INFINITY;
+    for(j=-1;j<m->marks;j++) {
+        d = j < 0 ? 0 : m->at[j];
+        s1 = m->sum - (j < 0 ? 0.0 : m->atSum[j]);
+        s2 = m->sumSquares - (j < 0 ? 0.0 : m->atSumSquares[j]);
+        k = m->batches - d;
+        if(k < 2)
+            continue;
+        stat = (s2 - s1*s1/k)/(k*k);
+        if(stat < min) {
+            min = stat;
+            best = d;
+        }
+    }
+    if(best < 0 || 2*best > m->batches)
+        return -1;
+    return best * MSER_SIZE;
+}
+/*
+ * A function to estimate a mean and its 95% confidence interval from one
+ * output per replication, with antithetic pairs and control variates
+ * Paired replications 2k and 2k+1 are averaged into one observation.
+ * With controls, the output is regressed on the two controls, whose
+ * means are known to be 0, and the fitted line is read at 0
+ *
+ * @param const double *y, the outputs
+ * @param const double *c, two controls per replication, or NULL for none
+ * @param int n, the number of replications, even if paired
+ * @param int paired, boolean, whether replications come in antithetic pairs
+ * @param double *mean, where to store the estimate
+ * @param double *halfWidth, where to store the half-width, 0 with one replication
+ * @param double *reduction, where to store how many times smaller the variance
+ *  of the estimate is than that of the mean of n independent replications
+ *
+ * @local int i, j, k, counters
+ * @local int units, the number of independent observations
+ * @local int step, the replications in an observation
+ * @local struct summary all, the summary of the outputs one by one
+ * @local struct summary u, the summary of the observations
+ * @local double x, x1, x2, an observation and its controls
+ * @local double c1, c2, the means of the controls
+ * @local double s11, s12, s22, s1y, s2y, the centred sums of products
+ * @local double det, the determinant of the controls' matrix
+ * @local double b1, b2, the regression coefficients
+ * @local double sse, the residual sum of squares
+ * @local double var, the variance of the estimate
+ * @local long df, the degrees of freedom of the interval
+ */
+void estimateMean(const double *y, const double *c, int n, int paired, double *mean, double *halfWidth, double *reduction) {
+    int i, j, k, units, step = paired ? 2 : 1;
+    struct summary all, u;
+    double x, x1, x2, c1 = 0.0, c2 = 0.0, s11 = 0.0, s12 = 0.0, s22 = 0.0, s1y = 0.0, s2y = 0.0;
+    double det, b1, b2, sse, var;
+    long df;
+    units = n/step;
+    initSummary(&all);
+    initSummary(&u);
+    for(i=0;i<n;i++)
+        addSample(&all, y[i]);
+    for(k=0;k<units;k++) {
+        for(x=0.0,j=0;j<step;j++)
+            x += y[k*step+j];
+        addSample(&u, x/step);
+    }
+    *mean = u.mean;
+    var = summaryVariance(&u)/units;
+    df = units - 1;
+    if(c != NULL && units >= 4) {
+        for(k=0;k<units;k++) {
+            for(x1=x2=0.0,j=0;j<step;j++) {
+                x1 += c[2*(k*step+j)];
+                x2 += c[2*(k*step+j)+1];
+            }
+            c1 += x1/step;
+            c2 += x2/step;
+        }
+        c1 /= units;
+        c2 /= units;
+        for(k=0;k<units;k++) {
+            for(x=x1=x2=0.0,j=0;j<step;j++) {
+                x += y[k*step+j];
+                x1 += c[2*(k*step+j)];
+                x2 += c[2*(k*step+j)+1];
+            }
+            x = x/step - u.mean;
+            x1 = x1/step - c1;
+            x2 = x2/step - c2;
+            s11 += x1*x1;
+            s12 += x1*x2;
+            s22 += x2*x2;
+            s1y += x1*x;
+            s2y += x2*x;
+        }
+        det = s11*s22 - s12*s12;
+        if(det > 1e-12*s11*s22) {       // the controls are not collinear
+            b1 = (s22*s1y - s12*s2y)/det;
+            b2 = (s11*s2y - s12*s1y)/det;
+            sse = u.m2 - b1*s1y - b2*s2y;
+            *mean = u.mean - b1*c1 - b2*c2;
+            var = (sse > 0 ? sse : 0.0)/(units - 3)
+                * (1.0/units + (s22*c1*c1 - 2.0*s12*c1*c2 + s11*c2*c2)/det);
+            df = units - 3;
+        }
+    }
+    *halfWidth = units > 1 ? tQuantile975(df)*sqrt(var) : 0.0;
+    *reduction = var > 0 ? summaryVariance(&all)/n/var : 1.0;
+}
+/*
+ * A function to return the 97.5% quantile of Student's t distribution
+ * Past the table, a Cornish-Fisher expansion around the normal quantile is used
+ *
+ * @param long df, the degrees of freedom
+ *
+ * @local double z, the normal quantile
+ * @local double v, the degrees of freedom as a double
+ *
+ * @return double, the quantile
+ */
+double tQuantile975(long df) {
+    double z = 1.959963984540054, v = (double)df;
+    if(df < 1)
+        return 0.0;
+    if(df <= 30)
+        return tTable[df-1];
+    return z + (z*z*z + z)/(4.0*v) + (5.0*pow(z,5) + 16.0*z*z*z + 3.0*z)/(96.0*v*v);
+}
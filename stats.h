@@ -0,0 +1,194 @@
+/***************************************************************
+  Paul Lewis
+  File Name: stats.h
+  Simulation
+
+  Contains struct definitions, function prototypes, and #includes for stats.c
+***************************************************************/
+
+#include <stdlib.h>
+#include <math.h>
+
+#ifndef _stats_h
+#define _stats_h
+
+/*
+ * A running summary of a sample (Welford's method)
+ *
+ * @field long count, the number of observations
+ * @field double mean, the mean of the observations
+ * @field double m2, the sum of squared deviations from the mean
+ */
+struct summary {
+    long count;
+    double mean;
+    double m2;
+};
+
+#define BATCH_COUNT 64          // batches kept, full batches are merged in pairs
+#define BATCH_FIRST_SIZE 16     // observations in a batch before the first merge, for confidence intervals
+#define MSER_SIZE 5             // observations in a batch of MSER-5
+#define MSER_MARKS 128          // candidate truncation points kept, enough for 5 * 2^63 observations
+
+/*
+ * Batch means of a stream of observations in bounded memory
+ * When all BATCH_COUNT batches are full, neighbours are merged and
+ * the batch size doubles, so batches grow with the run and their
+ * means become nearly independent
+ *
+ * @field double sums[], the sum of each full batch
+ * @field int batches, the number of full batches
+ * @field long first, the observations in a batch before the first merge
+ * @field long size, the observations in a batch
+ * @field long inBatch, the observations in the batch being filled
+ * @field double current, the sum of the batch being filled
+ */
+struct batchMeans {
+    double sums[BATCH_COUNT];
+    int batches;
+    long first;
+    long size;
+    long inBatch;
+    double current;
+};
+
+/*
+ * The marginal standard error rule (MSER-5) over a stream in bounded
+ * memory. Observations are grouped in batches of MSER_SIZE, never
+ * merged, and the batch means are summed with their squares. The
+ * candidate truncation points are after 1, 2, 3, 4, 6, 8, 12, ... batches,
+ * 2^k and 3 2^(k-1), where the sums are marked, so the MSER statistic
+ * of deleting up to any of them is exact and each lies within a factor
+ * of 1.5 of the next
+ *
+ * @field long batches, the number of full batches
+ * @field long inBatch, the observations in the batch being filled
+ * @field double current, the sum of the batch being filled
+ * @field double sum, double sumSquares, of the full batch means
+ * @field int marks, the candidate points marked
+ * @field long next, the full batches at the next candidate point
+ * @field long at[], the full batches before each candidate point
+ * @field double atSum[], double atSumSquares[], the sums there
+ */
+struct mser {
+    long batches;
+    long inBatch;
+    double current;
+    double sum;
+    double sumSquares;
+    int marks;
+    long next;
+    long at[MSER_MARKS];
+    double atSum[MSER_MARKS];
+    double atSumSquares[MSER_MARKS];
+};
+
+/*
+ * A function to initialize an empty summary
+ *
+ * @param struct summary *s, the summary
+ */
+void initSummary(struct summary *s);
+/*
+ * A function to add an observation to a summary
+ *
+ * @param struct summary *s, the summary
+ * @param double x, the observation
+ */
+void addSample(struct summary *s, double x);
+/*
+ * A function to return the sample variance of a summary
+ *
+ * @param struct summary *s, the summary
+ *
+ * @return double, the variance, 0 with fewer than two observations
+ */
+double summaryVariance(struct summary *s);
+/*
+ * A function to return the half-width of a 95% confidence interval for the mean
+ *
+ * @param struct summary *s, the summary
+ *
+ * @return double, the half-width, 0 with fewer than two observations
+ */
+double halfWidth95(struct summary *s);
+/*
+ * A function to initialize empty batch means
+ *
+ * @param struct batchMeans *b, the batch means
+ * @param long size, the observations in a batch before the first merge
+ */
+void initBatchMeans(struct batchMeans *b, long size);
+/*
+ * A function to add an observation to batch means
+ *
+ * @param struct batchMeans *b, the batch means
+ * @param double x, the observation
+ *
+ * @return int, boolean, whether a batch was completed
+ */
+int addBatchSample(struct batchMeans *b, double x);
+/*
+ * A function to return the half-width of a 95% confidence interval for
+ * the mean over the full batches, relative to the mean
+ *
+ * @param const struct batchMeans *b, the batch means
+ *
+ * @return double, the relative half-width, INFINITY until the batches
+ *  have been merged once or while the mean is 0
+ */
+double batchPrecision(const struct batchMeans *b);
+/*
+ * A function to initialize an empty MSER-5 rule
+ *
+ * @param struct mser *m, the rule
+ */
+void initMser(struct mser *m);
+/*
+ * A function to add an observation to an MSER-5 rule
+ *
+ * @param struct mser *m, the rule
+ * @param double x, the observation
+ *
+ * @return int, boolean, whether a candidate point was marked, the last of m->at
+ */
+int addMserSample(struct mser *m, double x);
+/*
+ * A function to find the truncation point of MSER-5: of no deletion and
+ * the candidate points, the number of leading batches whose deletion
+ * minimizes the variance of the remaining batch means divided by their
+ * count squared
+ *
+ * @param const struct mser *m, the rule
+ *
+ * @return long, the observations to delete, or -1 while the best
+ *  deletion is past the first half of the batches and so not yet settled
+ */
+long mserTruncation(const struct mser *m);
+/*
+ * A function to estimate a mean and its 95% confidence interval from one
+ * output per replication, with antithetic pairs and control variates
+ * Paired replications 2k and 2k+1 are averaged into one observation.
+ * With controls, the output is regressed on the two controls, whose
+ * means are known to be 0, and the fitted line is read at 0
+ *
+ * @param const double *y, the outputs
+ * @param const double *c, two controls per replication, or NULL for none
+ * @param int n, the number of replications, even if paired
+ * @param int paired, boolean, whether replications come in antithetic pairs
+ * @param double *mean, where to store the estimate
+ * @param double *halfWidth, where to store the half-width, 0 with one replication
+ * @param double *reduction, where to store how many times smaller the variance
+ *  of the estimate is than that of the mean of n independent replications
+ */
+void estimateMean(const double *y, const double *c, int n, int paired, double *mean, double *halfWidth, double *reduction);
+/*
+ * A function to return the 97.5% quantile of Student's t distribution
+ *
+ * @param long df, the degrees of freedom
+ *
+ * @return double, the quantile
+ */
+double tQuantile975(long df);
+
+#endif
@@ -0,0 +1,162 @@
+/***************************************************************
+  Paul Lewis
+  File Name: sweep.c
+  Simulation
+
+  Runs the simulation over a grid of parameters. Points are
+  scheduled on the work stealing thread pool, so points near
+  saturation, which run far longer than lightly loaded ones,
+  do not hold up the rest of the grid. Every point uses the
+  streams of replication 0, so a row is exactly the run that
+  simulation.txt with the same values and seed would give
+***************************************************************/
+
+#include "simulation.h"
+#include "threadpool.h"
+
+/*
+ * The number of parameters in a sweep file, lambda, mu, M and N
+ */
+#define SWEEP_PARAMS 4
+
+/*
+ * One point of a sweep, filled in by the worker thread that runs it
+ */
+struct point {
+    struct simConfig cfg;
+    struct simResults res;
+    int status;                     // what simulate() returned, -1 if the point could not be run
+};
+
+/*
+ * A function run by a worker thread for one point
+ *
+ * @param void *arg, the struct point to run
+ *
+ * @local struct point *pt, the point
+ */
+static void runPoint(void *arg) {
+    struct point *pt = (struct point *) arg;
+    pt->status = simulate(&pt->cfg, &pt->res);
+}
+/*
+ * A function to count the values of a range
+ *
+ * @param long range[], the first value, last value and step
+ *
+ * @return long, the number of values
+ */
+static long rangeSize(long range[]) {
+    if(range[2] <= 0 || range[1] < range[0])
+        return 0;
+    return (range[1] - range[0]) / range[2] + 1;
+}
+/*
+ * A function to run the simulation at every point of a grid of lambda,
+ * mu, M and N read from a file, on a pool of threads, and print the
+ * a priori and a posteriori statistics of each point as a CSV row
+ * The file holds one line "first last step" for each of lambda, mu,
+ * M and N, followed by an optional seed. A line with only a first
+ * value is a single value
+ *
+ * Each point is a single replication
+ *
+ * @param const char *file, the file holding the ranges
+ * @param const struct simConfig *base, the engine, method, threads, stopping
+ *  rule and warm-up detection every point is run with
+ *
+ * @local int i, a counter
+ * @local long k, a counter
+ * @local long count, the number of points
+ * @local long ranges[][], the first value, last value and step of each parameter
+ * @local long idx[], the position of a point along each parameter
+ * @local char line[], the buffer for reading the file
+ * @local uint64_t seed, the seed
+ * @local FILE *fp, the sweep file
+ * @local struct point *points, the grid
+ * @local struct threadPool *tp, the workers
+ * @local struct simConfig *cfg, a point's config
+ * @local struct analytic *a, a point's a priori statistics
+ * @local struct results *r, a point's a posteriori statistics
+ */
+void runSweep(const char *file, const struct simConfig *base) {
+    int i;
+    long k, count = 1;
+    long ranges[SWEEP_PARAMS][3], idx[SWEEP_PARAMS];
+    char line[BUFFER_SIZE * 3];
+    uint64_t seed;
+    FILE *fp;
+    struct point *points;
+    struct threadPool *tp;
+    struct simConfig *cfg;
+    struct analytic *a;
+    struct results *r;
+
+    fp = fopen(file, "r");
+    if(fp == NULL) {
+        perror("Unable to open sweep file\n");
+        exit(1);
+    }
+    for(i=0;i<SWEEP_PARAMS && fgets(line,sizeof(line),fp)!=NULL;i++) {
+        ranges[i][1] = ranges[i][2] = 1;
+        k = sscanf(line, "%ld %ld %ld", &ranges[i][0], &ranges[i][1], &ranges[i][2]);
+        if(k < 1 || ranges[i][0] <= 0)
+            break;
+        if(k == 1)
+            ranges[i][1] = ranges[i][0];
+        count *= rangeSize(ranges[i]);
+    }
+    if(i < SWEEP_PARAMS || count == 0) {
+        fprintf(stderr, "%s must hold a positive range \"first last step\" for each of lambda, mu, M and N\n", file);
+        exit(1);
+    }
+    if(fgets(line,sizeof(line),fp) != NULL)     // optional seed
+        seed = strtoull(line, NULL, 10);
+    else
+        seed = (uint64_t) time(0);
+    fclose(fp);
+
+    points = (struct point *) malloc(count * sizeof(struct point));
+    if(points == NULL) {
+        perror("malloc error. cannot create sweep.\n");
+        exit(1);
+    }
+    tp = newThreadPool(base->threads);
+    for(k=0;k<count;k++) {
+        idx[SWEEP_PARAMS-1] = k;    // N varies fastest, lambda slowest
+        for(i=SWEEP_PARAMS-1;i>0;i--) {
+            idx[i-1] = idx[i] / rangeSize(ranges[i]);
+            idx[i] %= rangeSize(ranges[i]);
+        }
+        points[k].cfg = *base;
+        points[k].cfg.replications = 1;
+        points[k].cfg.lambda = ranges[0][0] + idx[0] * ranges[0][2];
+        points[k].cfg.mu = ranges[1][0] + idx[1] * ranges[1][2];
+        points[k].cfg.m = (int) (ranges[2][0] + idx[2] * ranges[2][2]);
+        points[k].cfg.n = ranges[3][0] + idx[3] * ranges[3][2];
+        points[k].cfg.seed = seed;
+        submitTask(tp, runPoint, &points[k]);
+    }
+    waitThreadPool(tp);
+    tp = freeThreadPool(tp);
+
+    fprintf(stderr, "seed = %llu\n", (unsigned long long) seed);
+    printf("lambda,mu,M,N,Po,L,W,Lq,Wq,Rho,PWait,simPo,simW,simWq,simPWait,simPNoWait,simWp95,simWp99,simWp999,simWqp95,simWqp99,simWqp999,simL,simLq,simRho,customers,truncated\n");
+    for(k=0;k<count;k++) {      // rows in grid order whatever order the points finished in
+        cfg = &points[k].cfg;
+        if(points[k].status != 0) {
+            printf("%g,%g,%d,%ld,error,the point cannot be run with these options\n", cfg->lambda, cfg->mu, cfg->m, cfg->n);
+            continue;
+        }
+        a = &points[k].res.analytic;
+        r = &points[k].res.mean;
+        printf("%g,%g,%d,%ld,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%.6f,%ld,%ld\n",
+            cfg->lambda, cfg->mu, cfg->m, cfg->n,
+            a->po, a->l, a->w, a->lq, a->wq, a->rho, a->pWait,
+            r->po, r->w, r->wq, r->pWait, 1.0 - r->pWait,
+            points[k].res.w.p95, points[k].res.w.p99, points[k].res.w.p999,
+            points[k].res.wq.p95, points[k].res.wq.p99, points[k].res.wq.p999,
+            r->l, r->lq, r->utilization, points[k].res.customers, points[k].res.truncated);
+    }
+    free(points);
+}
@@ -0,0 +1,25 @@
+/***************************************************************
+  Paul Lewis
+  File Name: sweep.h
+  Simulation
+
+  Contains function prototypes, #defines, and #includes for sweep.c
+***************************************************************/
+
+#include "libsimulation.h"
+
+#ifndef _sweep_h
+#define _sweep_h
+
+/*
+ * A function to run the simulation at every point of a grid of lambda,
+ * mu, M and N read from a file, on a pool of threads, and print the
+ * a priori and a posteriori statistics of each point as a CSV row
+ *
+ * @param const char *file, the file holding the ranges
+ * @param const struct simConfig *base, the engine, method, threads, stopping
+ *  rule and warm-up detection every point is run with
+ */
+void runSweep(const char *file, const struct simConfig *base);
+
+#endif
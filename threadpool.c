@@ -0,0 +1,248 @@
+/***************************************************************
+  Paul Lewis
+  File Name: threadpool.c
+  Simulation
+
+  Contains functions for creating, using, and freeing a pool of
+  worker threads. Each worker has its own deque of tasks and
+  steals from the others when it runs out
+***************************************************************/
+
+#include <unistd.h>
+#include "threadpool.h"
+
+/*
+ * The initial number of tasks each deque can hold, doubled when full
+ */
+#define DEQUE_SIZE 64
+
+/*
+ * A function to take a task from a worker's deque
+ *
+ * @param struct worker *w, the worker
+ * @param int bottom, boolean, take the newest task rather than the oldest
+ * @param struct task *t, where to store the task
+ *
+ * @return int, boolean, whether a task was taken
+ */
+static int takeTask(struct worker *w, int bottom, struct task *t) {
+    int found = 0;
+    pthread_mutex_lock(&w->lock);
+    if(w->count > 0) {
+        if(bottom) {
+            *t = w->tasks[(w->head + w->count - 1) % w->capacity];
+        } else {
+            *t = w->tasks[w->head];
+            w->head = (w->head + 1) % w->capacity;
+        }
+        w->count--;
+        found = 1;
+    }
+    pthread_mutex_unlock(&w->lock);
+    return found;
+}
+/*
+ * A function to find a task for a worker, its own newest first,
+ * otherwise the oldest task of the next worker that has one
+ *
+ * @param struct worker *w, the worker
+ * @param struct task *t, where to store the task
+ *
+ * @local struct threadPool *tp, the pool
+ * @local int i, a counter
+ *
+ * @return int, boolean, whether a task was found
+ */
+static int findTask(struct worker *w, struct task *t) {
+    struct threadPool *tp = w->tp;
+    int i;
+    if(takeTask(w, 1, t))
+        return 1;
+    for(i=1;i<tp->numThreads;i++)
+        if(takeTask(&tp->workers[(w->id + i) % tp->numThreads], 0, t))
+            return 1;
+    return 0;
+}
+/*
+ * The function each worker runs, taking tasks until shutdown
+ *
+ * @param void *arg, the worker
+ *
+ * @local struct worker *w, the worker
+ * @local struct threadPool *tp, the pool
+ * @local struct task t, the task being run
+ *
+ * @return void *, NULL
+ */
+static void *work(void *arg) {
+    struct worker *w = arg;
+    struct threadPool *tp = w->tp;
+    struct task t;
+    for(;;) {
+        if(findTask(w, &t)) {
+            pthread_mutex_lock(&tp->lock);
+            tp->queued--;
+            pthread_mutex_unlock(&tp->lock);
+            t.fn(t.arg);
+            pthread_mutex_lock(&tp->lock);
+            if(--tp->pending == 0)
+                pthread_cond_broadcast(&tp->allDone);
+            pthread_mutex_unlock(&tp->lock);
+            continue;
+        }
+        pthread_mutex_lock(&tp->lock);
+        while(tp->queued == 0 && !tp->shutdown)
+            pthread_cond_wait(&tp->workReady, &tp->lock);
+        if(tp->queued == 0) {       // shutdown with nothing left to do
+            pthread_mutex_unlock(&tp->lock);
+            break;
+        }
+        pthread_mutex_unlock(&tp->lock);
+    }
+    return NULL;
+}
+/*
+ * A function to start a thread pool
+ *
+ * @param int threads, the number of workers, 0 for one per processor
+ *
+ * @local struct threadPool *tp, the new pool
+ * @local struct worker *w, a worker
+ * @local int i, a counter
+ *
+ * @return struct threadPool *, reference to the pool
+ */
+struct threadPool *newThreadPool(int threads) {
+    int i;
+    struct worker *w;
+    struct threadPool *tp = (struct threadPool *) malloc(sizeof(struct threadPool));
+    if(tp == NULL) {
+        perror("malloc error. cannot create thread pool.\n");
+        exit(1);
+    }
+    if(threads <= 0)
+        threads = (int) sysconf(_SC_NPROCESSORS_ONLN);
+    if(threads <= 0)
+        threads = 1;
+    tp->numThreads = threads;
+    tp->next = 0;
+    tp->queued = 0;
+    tp->pending = 0;
+    tp->shutdown = 0;
+    tp->workers = malloc(sizeof(struct worker) * threads);
+    if(tp->workers == NULL) {
+        perror("malloc error. cannot create thread pool.\n");
+        exit(1);
+    }
+    pthread_mutex_init(&tp->lock, NULL);
+    pthread_cond_init(&tp->workReady, NULL);
+    pthread_cond_init(&tp->allDone, NULL);
+    for(i=0;i<threads;i++) {
+        w = &tp->workers[i];
+        w->tp = tp;
+        w->id = i;
+        w->capacity = DEQUE_SIZE;
+        w->head = 0;
+        w->count = 0;
+        w->tasks = malloc(sizeof(struct task) * w->capacity);
+        if(w->tasks == NULL) {
+            perror("malloc error. cannot create thread pool.\n");
+            exit(1);
+        }
+        pthread_mutex_init(&w->lock, NULL);
+    }
+    for(i=0;i<threads;i++) {    // start the workers once every deque exists
+        if(pthread_create(&tp->workers[i].thread, NULL, work, &tp->workers[i]) != 0) {
+            perror("pthread_create error. cannot start worker.\n");
+            exit(1);
+        }
+    }
+    return tp;
+}
+/*
+ * A function to queue a task on a thread pool
+ * Tasks are dealt round robin, a deque doubles when full
+ *
+ * @param struct threadPool *tp, the pool
+ * @param void (*fn)(void *), the function to run
+ * @param void *arg, the argument to pass
+ *
+ * @local struct worker *w, the worker the task is dealt to
+ * @local struct task *tasks, the larger ring
+ * @local int i, a counter
+ */
+void submitTask(struct threadPool *tp, void (*fn)(void *), void *arg) {
+    struct worker *w;
+    struct task *tasks;
+    int i;
+    pthread_mutex_lock(&tp->lock);
+    w = &tp->workers[tp->next];
+    tp->next = (tp->next + 1) % tp->numThreads;
+    tp->pending++;
+    tp->queued++;
+    pthread_mutex_unlock(&tp->lock);
+
+    pthread_mutex_lock(&w->lock);
+    if(w->count == w->capacity) {
+        tasks = malloc(sizeof(struct task) * w->capacity * 2);
+        if(tasks == NULL) {
+            perror("malloc error. cannot grow thread pool queue.\n");
+            exit(1);
+        }
+        for(i=0;i<w->count;i++)
+            tasks[i] = w->tasks[(w->head + i) % w->capacity];
+        free(w->tasks);
+        w->tasks = tasks;
+        w->head = 0;
+        w->capacity *= 2;
+    }
+    w->tasks[(w->head + w->count) % w->capacity].fn = fn;
+    w->tasks[(w->head + w->count) % w->capacity].arg = arg;
+    w->count++;
+    pthread_mutex_unlock(&w->lock);
+
+    pthread_mutex_lock(&tp->lock);
+    pthread_cond_signal(&tp->workReady);
+    pthread_mutex_unlock(&tp->lock);
+}
+/*
+ * A function to wait until every submitted task has finished
+ *
+ * @param struct threadPool *tp, the pool
+ */
+void waitThreadPool(struct threadPool *tp) {
+    pthread_mutex_lock(&tp->lock);
+    while(tp->pending > 0)
+        pthread_cond_wait(&tp->allDone, &tp->lock);
+    pthread_mutex_unlock(&tp->lock);
+}
+/*
+ * A function to stop the workers and free a thread pool
+ * Queued tasks are finished first
+ *
+ * @param struct threadPool *tp, the pool
+ *
+ * @local int i, a counter
+ *
+ * @return struct threadPool *, reference to the freed pool (NULL)
+ */
+struct threadPool *freeThreadPool(struct threadPool *tp) {
+    int i;
+    pthread_mutex_lock(&tp->lock);
+    tp->shutdown = 1;
+    pthread_cond_broadcast(&tp->workReady);
+    pthread_mutex_unlock(&tp->lock);
+    for(i=0;i<tp->numThreads;i++)
+        pthread_join(tp->workers[i].thread, NULL);
+    for(i=0;i<tp->numThreads;i++) {
+        pthread_mutex_destroy(&tp->workers[i].lock);
+        free(tp->workers[i].tasks);
+    }
+    pthread_mutex_destroy(&tp->lock);
+    pthread_cond_destroy(&tp->workReady);
+    pthread_cond_destroy(&tp->allDone);
+    free(tp->workers);
+    free(tp);
+    tp = NULL;
+    return tp;
+}
@@ -0,0 +1,112 @@
+/***************************************************************
+  Paul Lewis
+  File Name: threadpool.h
+  Simulation
+
+  Contains struct definitions, function prototypes, and #includes for threadpool.c
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <pthread.h>
+
+#ifndef _threadpool_h
+#define _threadpool_h
+
+/*
+ * A task for a thread pool
+ *
+ * @field void (*fn)(void *), the function to run
+ * @field void *arg, the argument to pass
+ */
+struct task {
+    void (*fn)(void *);
+    void *arg;
+};
+
+/*
+ * One worker of a thread pool and its deque of tasks
+ * The worker takes its own tasks newest first from the bottom, and
+ * idle workers steal the oldest from the top
+ *
+ * @field struct threadPool *tp, the pool the worker belongs to
+ * @field int id, the worker's index in the pool
+ * @field pthread_t thread, the worker thread
+ * @field struct task *tasks, a ring buffer of queued tasks
+ * @field int capacity, the size of the ring
+ * @field int head, the slot of the oldest task
+ * @field int count, the number of queued tasks
+ * @field pthread_mutex_t lock, guards the ring
+ */
+struct worker {
+    struct threadPool *tp;
+    int id;
+    pthread_t thread;
+    struct task *tasks;
+    int capacity;
+    int head;
+    int count;
+    pthread_mutex_t lock;
+};
+
+/*
+ * The thread pool structure
+ * Tasks are dealt round robin onto the workers' deques, and a worker
+ * whose deque runs dry steals from the others, so one long task never
+ * holds up the tasks queued behind it
+ *
+ * @field struct worker *workers, the workers
+ * @field int numThreads, the number of workers
+ * @field int next, the worker the next task is dealt to
+ * @field int queued, the number of tasks waiting in any deque
+ * @field int pending, the number of tasks submitted but not finished
+ * @field int shutdown, boolean, set when the workers should exit
+ * @field pthread_mutex_t lock, guards the fields above
+ * @field pthread_cond_t workReady, signalled when a task is queued
+ * @field pthread_cond_t allDone, signalled when pending reaches 0
+ */
+struct threadPool {
+    struct worker *workers;
+    int numThreads;
+    int next;
+    int queued;
+    int pending;
+    int shutdown;
+    pthread_mutex_t lock;
+    pthread_cond_t workReady;
+    pthread_cond_t allDone;
+};
+
+/*
+ * A function to start a thread pool
+ *
+ * @param int threads, the number of workers, 0 for one per processor
+ *
+ * @return struct threadPool *, reference to the pool
+ */
+struct threadPool *newThreadPool(int threads);
+/*
+ * A function to queue a task on a thread pool
+ *
+ * @param struct threadPool *tp, the pool
+ * @param void (*fn)(void *), the function to run
+ * @param void *arg, the argument to pass
+ */
+void submitTask(struct threadPool *tp, void (*fn)(void *), void *arg);
+/*
+ * A function to wait until every submitted task has finished
+ *
+ * @param struct threadPool *tp, the pool
+ */
+void waitThreadPool(struct threadPool *tp);
+/*
+ * A function to stop the workers and free a thread pool
+ * Queued tasks are finished first
+ *
+ * @param struct threadPool *tp, the pool
+ *
+ * @return struct threadPool *, reference to the freed pool (NULL)
+ */
+struct threadPool *freeThreadPool(struct threadPool *tp);
+
+#endif
@@ -0,0 +1,173 @@
+/***************************************************************
+  Paul Lewis
+  File Name: trace.c
+  Simulation
+
+  Contains functions for replaying recorded arrivals and service
+  times in place of random intervals. A trace file is mapped into
+  memory and read where it lies, and the pages a run has read are
+  given back as it goes, so a trace of any size can be replayed
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include "trace.h"
+
+/*
+ * A function to map a trace file into memory
+ *
+ * @param const char *path, the trace file
+ *
+ * @local int fd, the open file
+ * @local struct stat st, the size of the file
+ * @local void *map, the mapping
+ * @local const struct traceHeader *h, the header
+ * @local struct simTrace *t, the new trace
+ *
+ * @return struct simTrace *, reference to the trace, or NULL with errno
+ *  set if the file cannot be mapped or is not a trace
+ */
+struct simTrace *openTrace(const char *path) {
+    int fd;
+    struct stat st;
+    void *map;
+    const struct traceHeader *h;
+    struct simTrace *t;
+    if((fd = open(path, O_RDONLY)) < 0)
+        return NULL;
+    if(fstat(fd, &st) != 0) {
+        close(fd);
+        return NULL;
+    }
+    if(st.st_size < TRACE_HEADER) {
+        close(fd);
+        errno = EINVAL;
+        return NULL;
+    }
+    map = mmap(NULL, st.st_size, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);                          // the mapping keeps the file
+    if(map == MAP_FAILED)
+        return NULL;
+    h = (const struct traceHeader *) map;
+    if(memcmp(h->magic, TRACE_MAGIC, sizeof(h->magic)) != 0 || h->version != TRACE_VERSION
+            || h->records <= 0 || h->duration <= 0 || h->busy <= 0
+            || (uint64_t) st.st_size != TRACE_HEADER + 2*sizeof(double)*(uint64_t) h->records) {
+        munmap(map, st.st_size);
+        errno = EINVAL;
+        return NULL;
+    }
+    madvise(map, st.st_size, MADV_SEQUENTIAL);
+    t = (struct simTrace *) malloc(sizeof(struct simTrace));
+    if(t == NULL) {
+        perror("malloc error. cannot create trace.\n");
+        exit(1);
+    }
+    t->map = map;
+    t->length = st.st_size;
+    t->records = h->records;
+    t->gaps = (const double *) ((const char *) map + TRACE_HEADER);
+    t->services = t->gaps + t->records;
+    t->lambda = t->records/h->duration;
+    t->mu = t->records/h->busy;
+    return t;
+}
+/*
+ * A function to get the size and rates of a trace
+ *
+ * @param const struct simTrace *t, the trace
+ * @param double *lambda, where to store the arrival rate
+ * @param double *mu, where to store the service rate
+ *
+ * @return long, the number of customers
+ */
+long traceInfo(const struct simTrace *t, double *lambda, double *mu) {
+    *lambda = t->lambda;
+    *mu = t->mu;
+    return t->records;
+}
+/*
+ * A function to unmap a trace
+ *
+ * @param struct simTrace *t, the trace
+ *
+ * @return struct simTrace *, reference to the freed trace (NULL)
+ */
+struct simTrace *closeTrace(struct simTrace *t) {
+    munmap(t->map, t->length);
+    free(t);
+    t = NULL;
+    return t;
+}
+/*
+ * A function to make a variate buffer replay a column of a trace
+ * from a record onwards, wrapping to the first record after the last
+ *
+ * @param struct variates *v, the buffer
+ * @param const double *column, the column
+ * @param long records, the length of the column
+ * @param long start, the first record to replay
+ */
+void initTraceVariates(struct variates *v, const double *column, long records, long start) {
+    v->method = VARIATE_TRACE;
+    v->scale = 1.0;
+    v->trace = column;
+    v->records = records;
+    v->position = start;
+    v->released = start;
+    v->at = v->buf;
+    v->next = VARIATE_BATCH;    // fill on first use
+}
+/*
+ * A function to give back the pages of a column read so far
+ * They are only dropped from this process, and are read from the
+ * file again if another run still needs them
+ *
+ * @param struct variates *v, the buffer
+ * @param long upto, the first record still needed
+ *
+ * @local uintptr_t page, the page size
+ * @local uintptr_t from, the first whole page read
+ * @local uintptr_t to, the end of the last whole page read
+ */
+static void releaseTrace(struct variates *v, long upto) {
+    uintptr_t page = (uintptr_t) sysconf(_SC_PAGESIZE);
+    uintptr_t from = ((uintptr_t) (v->trace + v->released) + page - 1) & ~(page - 1);
+    uintptr_t to = (uintptr_t) (v->trace + upto) & ~(page - 1);
+    if(to > from)
+        madvise((void *) from, to - from, MADV_DONTNEED);
+    v->released = upto;
+}
+/*
+ * A function to point a variate buffer at the next batch of its trace
+ * Whole batches are read in place, only a batch that wraps past the
+ * last record is copied
+ *
+ * @param struct variates *v, the buffer
+ *
+ * @local int i, a counter
+ */
+void fillFromTrace(struct variates *v) {
+    int i;
+    if(v->position == v->records)
+        v->position = v->released = 0;
+    if(v->records - v->position >= VARIATE_BATCH) {
+        v->at = v->trace + v->position;
+        v->position += VARIATE_BATCH;
+    } else {
+        for(i=0;i<VARIATE_BATCH;i++) {
+            v->buf[i] = v->trace[v->position++];
+            if(v->position == v->records)
+                v->position = v->released = 0;
+        }
+        v->at = v->buf;
+    }
+    if(v->position - v->released >= TRACE_WINDOW)
+        releaseTrace(v, v->position - VARIATE_BATCH);
+    v->next = 0;
+}
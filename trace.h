@@ -0,0 +1,81 @@
+/***************************************************************
+  Paul Lewis
+  File Name: trace.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for trace.c
+***************************************************************/
+
+#include <stdint.h>
+#include <stddef.h>
+#include "libsimulation.h"
+#include "variate.h"
+
+#ifndef _trace_h
+#define _trace_h
+
+#define TRACE_MAGIC "SIMTRACE"     // the first 8 bytes of every trace file
+#define TRACE_VERSION 1
+#define TRACE_HEADER 64             // bytes before the columns, so both are aligned
+#define TRACE_WINDOW (1L << 20)     // records read between giving consumed pages back (8 MB)
+
+/*
+ * The header of a trace file, padded with zeros to TRACE_HEADER bytes
+ * It is followed by two columns of native doubles: the time from the
+ * previous arrival to each arrival, then the service time of each
+ *
+ * @field char magic[], TRACE_MAGIC, not terminated
+ * @field uint32_t version, TRACE_VERSION
+ * @field uint32_t reserved, 0
+ * @field int64_t records, the number of customers
+ * @field double duration, the sum of the interarrival times
+ * @field double busy, the sum of the service times
+ */
+struct traceHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    int64_t records;
+    double duration;
+    double busy;
+};
+
+/*
+ * A trace mapped into memory
+ *
+ * @field void *map, the mapping of the whole file
+ * @field size_t length, the length of the mapping
+ * @field long records, the number of customers
+ * @field const double *gaps, the interarrival times, in the mapping
+ * @field const double *services, the service times, in the mapping
+ * @field double lambda, the arrival rate over the whole trace
+ * @field double mu, the service rate over the whole trace
+ */
+struct simTrace {
+    void *map;
+    size_t length;
+    long records;
+    const double *gaps;
+    const double *services;
+    double lambda;
+    double mu;
+};
+
+/*
+ * A function to make a variate buffer replay a column of a trace
+ * from a record onwards, wrapping to the first record after the last
+ *
+ * @param struct variates *v, the buffer
+ * @param const double *column, the column
+ * @param long records, the length of the column
+ * @param long start, the first record to replay
+ */
+void initTraceVariates(struct variates *v, const double *column, long records, long start);
+/*
+ * A function to point a variate buffer at the next batch of its trace
+ *
+ * @param struct variates *v, the buffer
+ */
+void fillFromTrace(struct variates *v);
+
+#endif
@@ -0,0 +1,134 @@
+/***************************************************************
+  Paul Lewis
+  File Name: tracecvt.c
+  Simulation
+
+  A program for converting a CSV log of customers, one
+  "arrival time,service time" per line, into the binary trace
+  format that simulation -T replays
+***************************************************************/
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include "trace.h"
+
+#define COPY_SIZE (1 << 20)     // bytes copied at a time from the service column
+
+/*
+ * A function to write a column of doubles, stopping on an error
+ *
+ * @param FILE *fp, the file
+ * @param double x, the value
+ */
+static void writeValue(FILE *fp, double x) {
+    if(fwrite(&x, sizeof(x), 1, fp) != 1) {
+        perror("Unable to write trace\n");
+        exit(1);
+    }
+}
+/*
+ * A program to convert a CSV log into a trace
+ * Arrival times must not decrease, the first arrival is time 0, and
+ * blank lines, lines starting with # and a header line are skipped
+ *
+ * @param int argc, the number of command line arguments
+ * @param char *argv[], the command line arguments, the CSV file or - for
+ *  stdin and the trace file
+ *
+ * @local FILE *in, the CSV log
+ * @local FILE *out, the trace
+ * @local FILE *services, the service column, until the arrivals are written
+ * @local char line[], a line of the log
+ * @local char *p, char *end, where the values of the line are parsed
+ * @local long lines, the line number
+ * @local double arrival, double service, the values of the line
+ * @local double last, the previous arrival time
+ * @local struct traceHeader h, the header
+ * @local char *buf, a buffer for copying the service column
+ * @local size_t got, the bytes read into buf
+ *
+ * @return 0
+ */
+int main(int argc, char *argv[]) {
+    FILE *in, *out, *services;
+    char line[256], *p, *end, *buf;
+    long lines = 0;
+    double arrival, service, last = 0.0;
+    struct traceHeader h;
+    size_t got;
+    if(argc != 3) {
+        fprintf(stderr, "usage: %s log.csv|- trace\n", argv[0]);
+        exit(1);
+    }
+    in = strcmp(argv[1], "-") == 0 ? stdin : fopen(argv[1], "r");
+    if(in == NULL) {
+        perror("Unable to open file\n");
+        exit(1);
+    }
+    out = fopen(argv[2], "wb");
+    services = tmpfile();
+    if(out == NULL || services == NULL) {
+        perror("Unable to create trace\n");
+        exit(1);
+    }
+    memset(&h, 0, sizeof(h));
+    memcpy(h.magic, TRACE_MAGIC, sizeof(h.magic));
+    h.version = TRACE_VERSION;
+    if(fseek(out, TRACE_HEADER, SEEK_SET) != 0) {
+        perror("Unable to write trace\n");
+        exit(1);
+    }
+    while(fgets(line, sizeof(line), in) != NULL) {
+        lines++;
+        for(p=line;isspace((unsigned char) *p);p++)
+            ;
+        if(*p == '\0' || *p == '#')
+            continue;
+        arrival = strtod(p, &end);
+        if(end == p && lines == 1)      // a header line
+            continue;
+        for(p=end;isspace((unsigned char) *p) || *p == ',';p++)
+            ;
+        service = strtod(p, &end);
+        if(end == p || (h.records > 0 && arrival < last) || service < 0) {
+            fprintf(stderr, "line %ld: expected arrival time,service time with arrivals in order\n", lines);
+            exit(1);
+        }
+        if(h.records == 0)
+            last = arrival;             // the first arrival is at time 0
+        writeValue(out, arrival - last);
+        writeValue(services, service);
+        h.duration += arrival - last;
+        h.busy += service;
+        h.records++;
+        last = arrival;
+    }
+    if(h.records == 0 || h.duration <= 0 || h.busy <= 0) {
+        fprintf(stderr, "the log must hold customers spread over some time with some service\n");
+        exit(1);
+    }
+    buf = (char *) malloc(COPY_SIZE);
+    if(buf == NULL) {
+        perror("malloc error. cannot copy trace.\n");
+        exit(1);
+    }
+    rewind(services);
+    while((got = fread(buf, 1, COPY_SIZE, services)) > 0)
+        if(fwrite(buf, 1, got, out) != got) {
+            perror("Unable to write trace\n");
+            exit(1);
+        }
+    rewind(out);
+    if(fwrite(&h, sizeof(h), 1, out) != 1 || fclose(out) != 0) {
+        perror("Unable to write trace\n");
+        exit(1);
+    }
+    printf("%ld customers, lambda = %g, mu = %g\n", (long) h.records, h.records/h.duration, h.records/h.busy);
+    free(buf);
+    fclose(services);
+    if(in != stdin)
+        fclose(in);
+    return 0;
+}
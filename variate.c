@@ -0,0 +1,356 @@
+/***************************************************************
+  Paul Lewis
+  File Name: variate.c
+  Simulation
+
+  Contains functions for generating buffers of exponential variates
+  with a ziggurat (Marsaglia and Tsang, 2000) or by inversion, using
+  AVX2 kernels when the processor has them
+***************************************************************/
+
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <pthread.h>
+#include <immintrin.h>
+#include "variate.h"
+#include "trace.h"
+
+/*
+ * The ziggurat has 256 layers, the base layer's tail starts at ZIG_R
+ * and every layer has area ZIG_V
+ */
+#define ZIG_LAYERS 256
+#define ZIG_R 7.697117470131487
+#define ZIG_V 3.949659822581572e-3
+/*
+ * 2^52, random integers in the ziggurat have 52 bits
+ */
+#define TWO52 4503599627370496.0
+
+/*
+ * The ziggurat tables
+ * ke[i] is the acceptance bound, we[i] the scale and fe[i] exp(-x[i]) for layer i
+ */
+static uint64_t ke[ZIG_LAYERS];
+static double we[ZIG_LAYERS];
+static double fe[ZIG_LAYERS];
+/*
+ * Boolean, set if the AVX2 kernels are used
+ */
+static int useAvx2;
+/*
+ * Guards the one-time setup of the tables
+ */
+static pthread_once_t setupOnce = PTHREAD_ONCE_INIT;
+
+/*
+ * The polynomial for log(1+f) (from fdlibm) and the two parts of ln 2
+ */
+static const double Lg1 = 6.666666666666735130e-01;
+static const double Lg2 = 3.999999999940941908e-01;
+static const double Lg3 = 2.857142874366239149e-01;
+static const double Lg4 = 2.222219843214978396e-01;
+static const double Lg5 = 1.818357216161805012e-01;
+static const double Lg6 = 1.531383769920937332e-01;
+static const double Lg7 = 1.479819860511658591e-01;
+static const double LN2_HI = 6.93147180369123816490e-01;
+static const double LN2_LO = 1.90821492927058770002e-10;
+static const double SQRT2 = 1.4142135623730951;
+
+/*
+ * A function to build the ziggurat tables and choose the kernels
+ * Setting SIMULATION_SCALAR in the environment forces the scalar kernels
+ *
+ * @local double de, the right edge of the current layer
+ * @local double te, the right edge of the layer above
+ * @local double q, the width of the base layer's rectangle
+ * @local int i, a counter
+ */
+static void setupTables() {
+    double de = ZIG_R, te = ZIG_R, q = ZIG_V/exp(-ZIG_R);
+    int i;
+    ke[0] = (uint64_t)((de/q)*TWO52);
+    ke[1] = 0;
+    we[0] = q/TWO52;
+    we[ZIG_LAYERS-1] = de/TWO52;
+    fe[0] = 1.0;
+    fe[ZIG_LAYERS-1] = exp(-de);
+    for(i=ZIG_LAYERS-2;i>=1;i--) {
+        de = -log(ZIG_V/de + exp(-de));
+        ke[i+1] = (uint64_t)((de/te)*TWO52);
+        te = de;
+        fe[i] = exp(-de);
+        we[i] = de/TWO52;
+    }
+    __builtin_cpu_init();
+    useAvx2 = __builtin_cpu_supports("avx2") && getenv("SIMULATION_SCALAR") == NULL;
+}
+/*
+ * A function to compute the natural log with the same polynomial
+ * as the vectorized kernel, so both give identical results
+ * x = 2^k * m with m in [sqrt(2)/2, sqrt(2)), log(x) = k*ln2 + log(m)
+ *
+ * @param double x, a positive normal number
+ *
+ * @local uint64_t bits, the bits of x, then of m
+ * @local double m, f, s, z, w, t1, t2, r, hfsq, dk; parts of the computation
+ *
+ * @return double, log(x)
+ */
+double logKernel(double x) {
+    uint64_t bits;
+    double m, f, s, z, w, t1, t2, r, hfsq, dk;
+    memcpy(&bits, &x, sizeof(bits));
+    dk = (double)(bits >> 52) - 1023.0;
+    bits = (bits & 0x000fffffffffffffULL) | 0x3ff0000000000000ULL;
+    memcpy(&m, &bits, sizeof(m));
+    if(m > SQRT2) {
+        m = m*0.5;
+        dk = dk + 1.0;
+    }
+    f = m - 1.0;
+    s = f/(2.0 + f);
+    z = s*s;
+    w = z*z;
+    t1 = w*(Lg2 + w*(Lg4 + w*Lg6));
+    t2 = z*(Lg1 + w*(Lg3 + w*(Lg5 + w*Lg7)));
+    r = t2 + t1;
+    hfsq = 0.5*f*f;
+    return dk*LN2_HI - ((hfsq - (s*(hfsq + r) + dk*LN2_LO)) - f);
+}
+/*
+ * A function to turn random bits into a uniform on (0,1)
+ * The top 52 bits k give (2k+1)/2^53
+ *
+ * @param uint64_t u, the random bits
+ *
+ * @local uint64_t bits, the bits of a double in [1,2)
+ * @local double d, that double
+ *
+ * @return double, the uniform
+ */
+static inline double bitsToUniform(uint64_t u) {
+    uint64_t bits = (u >> 12) | 0x3ff0000000000000ULL;
+    double d;
+    memcpy(&d, &bits, sizeof(d));
+    return (d - 1.0) + 0x1.0p-53;
+}
+/*
+ * A function to run the ziggurat's common path on a batch
+ * Rejected draws are marked -1
+ *
+ * @param const uint64_t *u, the random bits
+ * @param double *out, the variates
+ *
+ * @local int i, a counter
+ * @local int iz, the layer
+ * @local uint64_t j, the 52 bit random integer
+ */
+static void zigguratScalar(const uint64_t *u, double *out) {
+    int i, iz;
+    uint64_t j;
+    for(i=0;i<VARIATE_BATCH;i++) {
+        iz = u[i] & (ZIG_LAYERS-1);
+        j = u[i] >> 12;
+        out[i] = j < ke[iz] ? (double)j*we[iz] : -1.0;
+    }
+}
+/*
+ * A function to run the ziggurat's common path on a batch with AVX2
+ * Rejected draws are marked -1
+ *
+ * @param const uint64_t *u, the random bits
+ * @param double *out, the variates
+ *
+ * @local int i, a counter
+ */
+__attribute__((target("avx2")))
+static void zigguratAvx2(const uint64_t *u, double *out) {
+    const __m256i layerMask = _mm256_set1_epi64x(ZIG_LAYERS-1);
+    const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256d magicd = _mm256_set1_pd(TWO52);
+    const __m256d reject = _mm256_set1_pd(-1.0);
+    int i;
+    for(i=0;i<VARIATE_BATCH;i+=4) {
+        __m256i uu = _mm256_loadu_si256((const __m256i *)(u+i));
+        __m256i iz = _mm256_and_si256(uu, layerMask);
+        __m256i j = _mm256_srli_epi64(uu, 12);
+        __m256i k = _mm256_i64gather_epi64((const long long *)ke, iz, 8);
+        __m256d w = _mm256_i64gather_pd(we, iz, 8);
+        __m256d jd = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(j, magic)), magicd);   // exact, j < 2^52
+        __m256d x = _mm256_mul_pd(jd, w);
+        __m256i accept = _mm256_cmpgt_epi64(k, j);
+        _mm256_storeu_pd(out+i, _mm256_blendv_pd(reject, x, _mm256_castsi256_pd(accept)));
+    }
+}
+/*
+ * A function to finish a rejected ziggurat draw
+ * Draws more random numbers from the stream until a variate is accepted
+ *
+ * @param struct variates *v, the buffer, for its stream
+ * @param uint64_t u, the rejected random bits
+ *
+ * @local int iz, the layer
+ * @local uint64_t j, the 52 bit random integer
+ * @local double x, the candidate variate
+ *
+ * @return double, the variate
+ */
+static double zigguratSlow(struct variates *v, uint64_t u) {
+    int iz;
+    uint64_t j;
+    double x;
+    for(;;) {
+        iz = u & (ZIG_LAYERS-1);
+        j = u >> 12;
+        x = (double)j*we[iz];
+        if(j < ke[iz])
+            return x;
+        if(iz == 0)                 // base layer tail, memoryless
+            return ZIG_R - logKernel(uniformOpen(&v->r));
+        if(fe[iz] + uniformOpen(&v->r)*(fe[iz-1] - fe[iz]) < exp(-x))  // wedge
+            return x;
+        u = nextRandom(&v->r);
+    }
+}
+/*
+ * A function to compute -log(U) for a batch
+ *
+ * @param const uint64_t *u, the random bits
+ * @param double *out, the variates
+ *
+ * @local int i, a counter
+ */
+static void inversionScalar(const uint64_t *u, double *out) {
+    int i;
+    for(i=0;i<VARIATE_BATCH;i++)
+        out[i] = -logKernel(bitsToUniform(u[i]));
+}
+/*
+ * A function to compute -log(U) for a batch with AVX2
+ * Follows logKernel operation for operation
+ *
+ * @param const uint64_t *u, the random bits
+ * @param double *out, the variates
+ *
+ * @local int i, a counter
+ */
+__attribute__((target("avx2")))
+static void inversionAvx2(const uint64_t *u, double *out) {
+    const __m256i one = _mm256_set1_epi64x(0x3ff0000000000000LL);
+    const __m256i mantissa = _mm256_set1_epi64x(0x000fffffffffffffLL);
+    const __m256i magic = _mm256_set1_epi64x(0x4330000000000000LL);
+    const __m256d magicd = _mm256_set1_pd(TWO52);
+    const __m256d onePd = _mm256_set1_pd(1.0);
+    const __m256d half = _mm256_set1_pd(0.5);
+    int i;
+    for(i=0;i<VARIATE_BATCH;i+=4) {
+        __m256i uu = _mm256_loadu_si256((const __m256i *)(u+i));
+        __m256d x = _mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(uu, 12), one));
+        x = _mm256_add_pd(_mm256_sub_pd(x, onePd), _mm256_set1_pd(0x1.0p-53));
+        __m256i bits = _mm256_castpd_si256(x);
+        __m256d dk = _mm256_sub_pd(_mm256_castsi256_pd(_mm256_or_si256(_mm256_srli_epi64(bits, 52), magic)), magicd);
+        dk = _mm256_sub_pd(dk, _mm256_set1_pd(1023.0));
+        __m256d m = _mm256_castsi256_pd(_mm256_or_si256(_mm256_and_si256(bits, mantissa), one));
+        __m256d big = _mm256_cmp_pd(m, _mm256_set1_pd(SQRT2), _CMP_GT_OQ);
+        m = _mm256_blendv_pd(m, _mm256_mul_pd(m, half), big);
+        dk = _mm256_add_pd(dk, _mm256_and_pd(big, onePd));
+        __m256d f = _mm256_sub_pd(m, onePd);
+        __m256d s = _mm256_div_pd(f, _mm256_add_pd(_mm256_set1_pd(2.0), f));
+        __m256d z = _mm256_mul_pd(s, s);
+        __m256d w = _mm256_mul_pd(z, z);
+        __m256d t1 = _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(Lg2),
+                        _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(Lg4), _mm256_mul_pd(w, _mm256_set1_pd(Lg6))))));
+        __m256d t2 = _mm256_mul_pd(z, _mm256_add_pd(_mm256_set1_pd(Lg1),
+                        _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(Lg3),
+                        _mm256_mul_pd(w, _mm256_add_pd(_mm256_set1_pd(Lg5), _mm256_mul_pd(w, _mm256_set1_pd(Lg7))))))));
+        __m256d r = _mm256_add_pd(t2, t1);
+        __m256d hfsq = _mm256_mul_pd(_mm256_mul_pd(half, f), f);
+        __m256d inner = _mm256_add_pd(_mm256_mul_pd(s, _mm256_add_pd(hfsq, r)), _mm256_mul_pd(dk, _mm256_set1_pd(LN2_LO)));
+        __m256d lg = _mm256_sub_pd(_mm256_mul_pd(dk, _mm256_set1_pd(LN2_HI)), _mm256_sub_pd(_mm256_sub_pd(hfsq, inner), f));
+        _mm256_storeu_pd(out+i, _mm256_sub_pd(_mm256_setzero_pd(), lg));
+    }
+}
+/*
+ * A function to initialize a variate buffer
+ *
+ * @param struct variates *v, the buffer
+ * @param struct rng *r, the stream to draw from, copied into the buffer
+ * @param double rate, the rate (lambda or mu) of the variates
+ * @param int method, one of the VARIATE_ values
+ */
+void initVariates(struct variates *v, struct rng *r, double rate, int method) {
+    pthread_once(&setupOnce, setupTables);
+    v->r = *r;
+    v->scale = 1.0/rate;
+    v->method = method;
+    v->at = v->buf;
+    v->next = VARIATE_BATCH;    // fill on first use
+}
+/*
+ * A function to refill a variate buffer
+ * The random bits for the batch are drawn first, in order, then the
+ * kernels run, then rejected ziggurat draws are finished in order
+ * Complementing the bits turns the uniform (2k+1)/2^53 into exactly
+ * 1 minus it, so the antithetic method is inversion of complemented bits
+ * A trace is not drawn but read, see fillFromTrace()
+ *
+ * @param struct variates *v, the buffer
+ *
+ * @local uint64_t u[], the random bits
+ * @local int i, a counter
+ */
+void fillVariates(struct variates *v) {
+    uint64_t u[VARIATE_BATCH];
+    int i;
+    if(v->method == VARIATE_TRACE) {
+        fillFromTrace(v);
+        return;
+    }
+    for(i=0;i<VARIATE_BATCH;i++)
+        u[i] = nextRandom(&v->r);
+    if(v->method == VARIATE_ANTITHETIC)
+        for(i=0;i<VARIATE_BATCH;i++)
+            u[i] = ~u[i];
+    if(v->method != VARIATE_ZIGGURAT) {
+        if(useAvx2)
+            inversionAvx2(u, v->buf);
+        else
+            inversionScalar(u, v->buf);
+    } else {
+        if(useAvx2)
+            zigguratAvx2(u, v->buf);
+        else
+            zigguratScalar(u, v->buf);
+        for(i=0;i<VARIATE_BATCH;i++)
+            if(v->buf[i] < 0.0)
+                v->buf[i] = zigguratSlow(v, u[i]);
+    }
+    for(i=0;i<VARIATE_BATCH;i++)
+        v->buf[i] *= v->scale;
+    v->next = 0;
+}
+/*
+ * A function to look up a method by name
+ *
+ * @param const char *name, ziggurat or inversion
+ *
+ * @return int, the method, -1 if the name is unknown
+ */
+int variateMethod(const char *name) {
+    if(strcmp(name, "ziggurat") == 0)
+        return VARIATE_ZIGGURAT;
+    if(strcmp(name, "inversion") == 0)
+        return VARIATE_INVERSION;
+    return -1;
+}
+/*
+ * A function to report whether the vectorized kernels are in use
+ *
+ * @return int, boolean
+ */
+int variatesVectorized() {
+    pthread_once(&setupOnce, setupTables);
+    return useAvx2;
+}
@@ -0,0 +1,107 @@
+/***************************************************************
+  Paul Lewis
+  File Name: variate.h
+  Simulation
+
+  Contains struct definitions, function prototypes, #defines, and #includes for variate.c
+***************************************************************/
+
+#include <stdint.h>
+#include "rng.h"
+
+#ifndef _variate_h
+#define _variate_h
+
+/*
+ * The number of variates generated at once
+ */
+#define VARIATE_BATCH 256
+/*
+ * The methods for generating exponential variates
+ */
+#define VARIATE_ZIGGURAT 0
+#define VARIATE_INVERSION 1
+#define VARIATE_ANTITHETIC 2    // inversion of 1-U, the antithetic partner of VARIATE_INVERSION
+#define VARIATE_TRACE 3         // recorded intervals replayed from a trace, see trace.h
+
+/*
+ * A buffer of exponential variates with a fixed rate
+ * Every variate is a function of the seed alone, whether the
+ * vectorized or the scalar kernels filled the buffer
+ *
+ * @field struct rng r, the stream the variates are drawn from
+ * @field double scale, the mean of the variates (1/rate)
+ * @field int method, one of the VARIATE_ values
+ * @field int next, the index of the next unused variate
+ * @field const double *at, the batch being used, buf or a batch of the trace
+ * @field const double *trace, the column of a trace replayed by VARIATE_TRACE
+ * @field long records, the length of the column
+ * @field long position, the record the next batch starts at
+ * @field long released, the record before which the column's pages have been given back
+ * @field double buf[], the variates
+ */
+struct variates {
+    struct rng r;
+    double scale;
+    int method;
+    int next;
+    const double *at;
+    const double *trace;
+    long records;
+    long position;
+    long released;
+    double buf[VARIATE_BATCH];
+};
+
+/*
+ * A function to initialize a variate buffer
+ *
+ * @param struct variates *v, the buffer
+ * @param struct rng *r, the stream to draw from, copied into the buffer
+ * @param double rate, the rate (lambda or mu) of the variates
+ * @param int method, one of the VARIATE_ values
+ */
+void initVariates(struct variates *v, struct rng *r, double rate, int method);
+/*
+ * A function to refill a variate buffer
+ *
+ * @param struct variates *v, the buffer
+ */
+void fillVariates(struct variates *v);
+/*
+ * A function to take the next variate from a buffer
+ *
+ * @param struct variates *v, the buffer
+ *
+ * @return double, the variate
+ */
+static inline double nextVariate(struct variates *v) {
+    if(v->next == VARIATE_BATCH)
+        fillVariates(v);
+    return v->at[v->next++];
+}
+/*
+ * A function to compute the natural log with the same polynomial
+ * as the vectorized kernel, so both give identical results
+ *
+ * @param double x, a positive normal number
+ *
+ * @return double, log(x)
+ */
+double logKernel(double x);
+/*
+ * A function to look up a method by name
+ *
+ * @param const char *name, ziggurat or inversion
+ *
+ * @return int, the method, -1 if the name is unknown
+ */
+int variateMethod(const char *name);
+/*
+ * A function to report whether the vectorized kernels are in use
+ *
+ * @return int, boolean
+ */
+int variatesVectorized();
+
+#endif